@@ -0,0 +1,226 @@
+/**
+ * Mede o tempo das funcionalidades para vários tamanhos de arquivo usando os dados do gerador
+ *
+ * Uso: ./execBenchmark [tamanho ...]
+ *
+ * Para cada tamanho (quantidade de veiculos, com um décimo disso de linhas) os CSVs são gerados em
+ * benchmark_dados/ e cada funcionalidade é executada em um processo próprio. O resultado de cada execução
+ * (tempo, vazão, latência e pico de memória residente) é escrito em benchmark.csv e benchmark.json
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DIRETORIO_DADOS "benchmark_dados"
+#define CONSULTAS_POR_LOTE 1000           // buscas pelo indice feitas em uma mesma sessão para medir a latência
+#define LIMITE_JUNCAO_ANINHADA 1000000000    // maior nroVeiculos * nroLinhas em que o nested loop ainda é medido
+#define PREFIXOS_DISTINTOS 60466176L         // 36^5, prefixos possiveis com 5 digitos em base 36, ver gerador.c
+
+typedef struct medicao {
+    double segundos;
+    long int picoMemoriaKiB;
+} medicao;
+
+/**
+ * Executa o programa em um processo filho dentro do diretório de dados, com a entrada vinda do arquivo
+ * @param programa caminho absoluto do executável
+ * @param nomeArquivoEntrada arquivo usado como entrada padrão
+ * @return tempo de parede e pico de memória residente do processo, segundos negativo caso o processo falhe
+ */
+medicao executaMedindo(char* programa, char* nomeArquivoEntrada) {
+    medicao resultado = {-1, -1};
+    struct timespec inicio, fim;
+    struct rusage uso;
+    int status;
+
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+
+    pid_t filho = fork();
+    if (filho == 0) {
+        if (chdir(DIRETORIO_DADOS) != 0 || freopen(nomeArquivoEntrada, "r", stdin) == NULL ||
+            freopen("/dev/null", "w", stdout) == NULL)
+            _exit(1);
+        execl(programa, programa, (char*)NULL);
+        _exit(1);
+    }
+    if (filho < 0 || wait4(filho, &status, 0, &uso) < 0) return resultado;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        if (WIFSIGNALED(status))
+            printf("Processo terminado pelo sinal %d\n", WTERMSIG(status));
+        else
+            printf("Processo terminou com o código %d\n", WEXITSTATUS(status));
+        return resultado;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+
+    resultado.segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+    resultado.picoMemoriaKiB = uso.ru_maxrss;
+    return resultado;
+}
+
+/**
+ * Escreve a entrada de um comando no diretório de dados
+ * @param conteudo texto da entrada
+ */
+void escreveEntrada(char* conteudo) {
+    FILE* arquivo = fopen(DIRETORIO_DADOS "/entrada.in", "w");
+    fputs(conteudo, arquivo);
+    fclose(arquivo);
+}
+
+/**
+ * Escreve a entrada do modo servidor com CONSULTAS_POR_LOTE buscas de prefixos existentes pelo indice
+ * @param nroVeiculos quantidade de veiculos gerados
+ */
+void escreveEntradaConsultas(long int nroVeiculos) {
+    char digitos[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    FILE* arquivo = fopen(DIRETORIO_DADOS "/entrada.in", "w");
+    long int nroPrefixos = nroVeiculos < PREFIXOS_DISTINTOS ? nroVeiculos : PREFIXOS_DISTINTOS;
+
+    fputs("29\n", arquivo);
+    for (long int i = 0; i < CONSULTAS_POR_LOTE; i++) {
+        long int numero = (i * 2654435761L) % nroPrefixos;  // espalha as consultas pelo arquivo
+        char prefixo[6];
+        for (int j = 0; j < 5; j++) {
+            prefixo[j] = digitos[numero % 36];
+            numero /= 36;
+        }
+        prefixo[5] = '\0';
+        fprintf(arquivo, "11 veiculo.bin indicePrefixo.bin prefixo \"%s\"\n", prefixo);
+    }
+
+    fclose(arquivo);
+}
+
+/**
+ * Mede um passo do benchmark e escreve a linha correspondente nas duas saídas
+ * @param programa caminho absoluto do executável
+ * @param csv arquivo benchmark.csv
+ * @param json arquivo benchmark.json
+ * @param primeiro 1 caso seja a primeira medição escrita no json
+ * @param tamanho quantidade de veiculos da rodada
+ * @param funcionalidade número da funcionalidade medida
+ * @param descricao nome da funcionalidade
+ * @param registros quantidade de registros (ou consultas) processados, usada na vazão
+ * @param operacoes quantidade de operações da execução, usada na latência
+ */
+void registraMedicao(char* programa, FILE* csv, FILE* json, int* primeiro, long int tamanho, int funcionalidade,
+                     char* descricao, long int registros, long int operacoes) {
+    medicao resultado = executaMedindo(programa, "entrada.in");
+    if (resultado.segundos < 0) {
+        printf("Falha ao executar %s\n", descricao);
+        return;
+    }
+
+    double vazao = registros / resultado.segundos;
+    double latenciaMs = resultado.segundos * 1000 / operacoes;
+
+    fprintf(csv, "%ld,%d,%s,%.6f,%.1f,%.4f,%ld\n", tamanho, funcionalidade, descricao, resultado.segundos, vazao,
+            latenciaMs, resultado.picoMemoriaKiB);
+    fprintf(json,
+            "%s\n  {\"tamanho\": %ld, \"funcionalidade\": %d, \"descricao\": \"%s\", \"segundos\": %.6f, "
+            "\"registrosPorSegundo\": %.1f, \"latenciaMs\": %.4f, \"picoMemoriaKiB\": %ld}",
+            *primeiro ? "" : ",", tamanho, funcionalidade, descricao, resultado.segundos, vazao, latenciaMs,
+            resultado.picoMemoriaKiB);
+    *primeiro = 0;
+
+    printf("%10ld %-28s %12.4f s %14.1f reg/s %10ld KiB\n", tamanho, descricao, resultado.segundos, vazao,
+           resultado.picoMemoriaKiB);
+    fflush(stdout);
+    fflush(csv);
+    fflush(json);
+}
+
+/**
+ * Gera os dados de um tamanho e mede cada funcionalidade sobre eles
+ * @param programa caminho absoluto do executável
+ * @param gerador caminho absoluto do gerador de dados
+ * @param csv arquivo benchmark.csv
+ * @param json arquivo benchmark.json
+ * @param primeiro 1 enquanto nenhuma medição foi escrita no json
+ * @param nroVeiculos quantidade de veiculos da rodada
+ */
+void executaRodada(char* programa, char* gerador, FILE* csv, FILE* json, int* primeiro, long int nroVeiculos) {
+    long int nroLinhas = nroVeiculos / 10 > 10 ? nroVeiculos / 10 : 10;
+    char comando[600];
+
+    sprintf(comando, "rm -rf %s && mkdir -p %s && %s %ld %ld %s/", DIRETORIO_DADOS, DIRETORIO_DADOS, gerador, nroVeiculos,
+            nroLinhas, DIRETORIO_DADOS);
+    if (system(comando) != 0) {
+        printf("Falha ao gerar os dados de %ld veiculos\n", nroVeiculos);
+        return;
+    }
+
+    escreveEntrada("1 veiculo.csv veiculo.bin\n");
+    registraMedicao(programa, csv, json, primeiro, nroVeiculos, 1, "CreateTable veiculo", nroVeiculos, 1);
+    escreveEntrada("2 linha.csv linha.bin\n");
+    registraMedicao(programa, csv, json, primeiro, nroVeiculos, 2, "CreateTable linha", nroLinhas, 1);
+
+    escreveEntrada("5 veiculo.bin modelo \"NEOBUS MEGA\"\n");
+    registraMedicao(programa, csv, json, primeiro, nroVeiculos, 5, "SelectFromWhere veiculo", nroVeiculos, 1);
+    escreveEntrada("6 linha.bin corLinha \"PRATA\"\n");
+    registraMedicao(programa, csv, json, primeiro, nroVeiculos, 6, "SelectFromWhere linha", nroLinhas, 1);
+
+    escreveEntrada("9 veiculo.bin indicePrefixo.bin\n");
+    registraMedicao(programa, csv, json, primeiro, nroVeiculos, 9, "CreateIndex veiculo", nroVeiculos, 1);
+    escreveEntrada("10 linha.bin indiceCodLinha.bin\n");
+    registraMedicao(programa, csv, json, primeiro, nroVeiculos, 10, "CreateIndex linha", nroLinhas, 1);
+
+    escreveEntradaConsultas(nroVeiculos);
+    registraMedicao(programa, csv, json, primeiro, nroVeiculos, 11, "SelectFromWithIndex veiculo", CONSULTAS_POR_LOTE,
+                    CONSULTAS_POR_LOTE);
+
+    if ((double)nroVeiculos * nroLinhas <= LIMITE_JUNCAO_ANINHADA) {
+        escreveEntrada("15 veiculo.bin linha.bin codLinha codLinha\n");
+        registraMedicao(programa, csv, json, primeiro, nroVeiculos, 15, "Juncao nested loop", nroVeiculos, 1);
+    }
+    escreveEntrada("16 veiculo.bin linha.bin codLinha codLinha indiceCodLinha.bin\n");
+    registraMedicao(programa, csv, json, primeiro, nroVeiculos, 16, "Juncao com indice", nroVeiculos, 1);
+    escreveEntrada("19 veiculo.bin linha.bin codLinha codLinha\n");
+    registraMedicao(programa, csv, json, primeiro, nroVeiculos, 19, "Juncao sort-merge", nroVeiculos, 1);
+    escreveEntrada("22 veiculo.bin linha.bin codLinha codLinha\n");
+    registraMedicao(programa, csv, json, primeiro, nroVeiculos, 22, "Juncao hash", nroVeiculos, 1);
+
+    escreveEntrada("17 veiculo.bin veiculoOrdenado.bin codLinha\n");
+    registraMedicao(programa, csv, json, primeiro, nroVeiculos, 17, "SortReg veiculo", nroVeiculos, 1);
+    escreveEntrada("18 linha.bin linhaOrdenado.bin codLinha\n");
+    registraMedicao(programa, csv, json, primeiro, nroVeiculos, 18, "SortReg linha", nroLinhas, 1);
+
+    sprintf(comando, "rm -rf %s", DIRETORIO_DADOS);
+    system(comando);
+}
+
+int main(int argc, char* argv[]) {
+    long int tamanhosPadrao[] = {1000, 10000, 100000, 1000000, 10000000, 100000000};
+    int nroTamanhos = argc > 1 ? argc - 1 : (int)(sizeof(tamanhosPadrao) / sizeof(tamanhosPadrao[0]));
+
+    char programa[4096], gerador[4096];
+    if (realpath("exec", programa) == NULL || realpath("gerador", gerador) == NULL) {
+        printf("Compile exec e gerador antes de executar o benchmark\n");
+        return 1;
+    }
+
+    FILE* csv = fopen("benchmark.csv", "w");
+    FILE* json = fopen("benchmark.json", "w");
+    int primeiro = 1;
+
+    fprintf(csv, "tamanho,funcionalidade,descricao,segundos,registrosPorSegundo,latenciaMs,picoMemoriaKiB\n");
+    fprintf(json, "[");
+
+    for (int i = 0; i < nroTamanhos; i++) {
+        long int tamanho = argc > 1 ? atol(argv[i + 1]) : tamanhosPadrao[i];
+        executaRodada(programa, gerador, csv, json, &primeiro, tamanho);
+    }
+
+    fprintf(json, "\n]\n");
+    fclose(csv);
+    fclose(json);
+
+    return 0;
+}
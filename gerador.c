@@ -0,0 +1,229 @@
+/**
+ * Gerador de dados sintéticos para os testes de escala
+ *
+ * Uso: ./gerador <nroVeiculos> <nroLinhas> <prefixoSaida> [taxaRemovidos] [taxaNulos] [semente]
+ *
+ * Gera <prefixoSaida>veiculo.csv e <prefixoSaida>linha.csv no mesmo formato dos casos de teste.
+ * O codLinha dos veiculos segue uma distribuição de Zipf sobre as linhas geradas, de forma que poucas linhas
+ * concentram a maior parte dos veiculos, como nos dados reais. taxaRemovidos é a fração dos registros
+ * marcados como removidos e taxaNulos a fração de NULO em cada campo que aceita valor nulo
+ * O prefixo tem 5 digitos em base 36, então só existem 36^5 prefixos distintos. Os veiculos além disso são
+ * gerados como removidos, para que o arquivo tenha o tamanho pedido sem repetir o prefixo de um registro ativo
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define EXPOENTE_ZIPF 1.0
+#define PREFIXOS_DISTINTOS 60466176L  // 36^5
+
+char* modelos[] = {"MARCOPOLO TORINO", "NEOBUS MEGA BRT", "CAIO APACHE VIP IV", "MARCOPOLO VIALE", "MARCOPOLO VIALE BRT",
+                   "CAIO MILLENNIUM BRT", "NEOBUS SPECTRUM", "CAIO MILLENNIUM", "NEOBUS MEGA", "CAIO APACHE VIP",
+                   "BUSSCAR URBANUSS", "MARCOPOLO TORINO GV", "CAIO APACHE", "CAIO MILLENNIUM II", "MARCOPOLO SENIOR",
+                   "MARCOPOLO GRAN VIALE", "CIFERAL SENIOR MIDI", "BUSSCAR URBANUSS PLUSS L"};
+char* categorias[] = {"ARTICULADO", "BIARTIC. BIO", "BIARTICULADO", "COMUM", "HIBRIDO", "HIBRIDO BIO",
+                      "MICRO", "MICROESPECIAL", "PADRON", "SEMIPADRON"};
+char* bairros[] = {"C. MUSICA", "V. ALEGRE", "R.PRADO", "C.GOMES", "UNIVERSIDADES", "HAUER", "STA.CANDIDA", "BOQUEIRAO",
+                   "PINHEIRINHO", "CABRAL", "PORTAO", "BACACHERI", "CAPAO RASO", "FAZENDINHA", "CENTENARIO", "BARREIRINHA"};
+char* cores[] = {"AMARELA", "BRANCA", "LARANJA", "MADRUGUEIRO", "PRATA", "TURISMO", "VERDE", "VERMELHA"};
+char* cartoes[] = {"S", "N", "F"};
+
+#define QUANTIDADE(vetor) ((int)(sizeof(vetor) / sizeof(vetor[0])))
+
+unsigned long long estadoAleatorio;
+
+/**
+ * Gerador xorshift64*, reproduzível a partir da semente e com período suficiente para 10^8 registros
+ * @return próximo número pseudoaleatório
+ */
+unsigned long long proximoAleatorio() {
+    estadoAleatorio ^= estadoAleatorio >> 12;
+    estadoAleatorio ^= estadoAleatorio << 25;
+    estadoAleatorio ^= estadoAleatorio >> 27;
+    return estadoAleatorio * 2685821657736338717ULL;
+}
+
+/**
+ * @return número pseudoaleatório uniforme em [0, 1)
+ */
+double aleatorioUniforme() {
+    return (proximoAleatorio() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @param limite quantidade de valores possiveis
+ * @return inteiro pseudoaleatório uniforme em [0, limite)
+ */
+long int aleatorioAte(long int limite) {
+    return (long int)(proximoAleatorio() % (unsigned long long)limite);
+}
+
+/**
+ * Monta a distribuição acumulada de Zipf sobre as linhas, usada para sortear o codLinha dos veiculos
+ * @param nroLinhas quantidade de linhas
+ * @return vetor com a probabilidade acumulada de cada posição
+ */
+double* criaDistribuicaoZipf(long int nroLinhas) {
+    double* acumulada = (double*)malloc(sizeof(double) * nroLinhas);
+    double soma = 0;
+
+    for (long int i = 0; i < nroLinhas; i++) {
+        soma += 1.0 / pow(i + 1, EXPOENTE_ZIPF);
+        acumulada[i] = soma;
+    }
+    for (long int i = 0; i < nroLinhas; i++) acumulada[i] /= soma;
+
+    return acumulada;
+}
+
+/**
+ * Sorteia uma posição seguindo a distribuição acumulada
+ * @param acumulada distribuição acumulada
+ * @param nroLinhas quantidade de posições
+ * @return posição sorteada
+ */
+long int sorteiaZipf(double* acumulada, long int nroLinhas) {
+    double alvo = aleatorioUniforme();
+    long int inicio = 0, fim = nroLinhas - 1;
+
+    while (inicio < fim) {
+        long int meio = (inicio + fim) / 2;
+        if (acumulada[meio] < alvo)
+            inicio = meio + 1;
+        else
+            fim = meio;
+    }
+
+    return inicio;
+}
+
+/**
+ * As linhas populares não devem ser as de menor código, então a posição sorteada é espalhada pelos códigos
+ * @param posicao posição da linha na distribuição
+ * @param nroLinhas quantidade de linhas
+ * @return código da linha
+ */
+long int codigoDaLinha(long int posicao, long int nroLinhas) {
+    return (posicao * 7919) % nroLinhas;
+}
+
+/**
+ * Escreve o prefixo do veiculo, o número do veiculo em base 36 com 5 digitos
+ * @param arquivo arquivo de saída
+ * @param numero número do veiculo, menor que PREFIXOS_DISTINTOS
+ */
+void escrevePrefixo(FILE* arquivo, long int numero) {
+    char digitos[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    char prefixo[6];
+
+    for (int i = 0; i < 5; i++) {
+        prefixo[i] = digitos[numero % 36];
+        numero /= 36;
+    }
+    prefixo[5] = '\0';
+
+    fputs(prefixo, arquivo);
+}
+
+/**
+ * Gera o CSV de veiculos
+ * @param nomeArquivo nome do CSV
+ * @param nroVeiculos quantidade de veiculos
+ * @param nroLinhas quantidade de linhas que os veiculos podem referenciar
+ * @param taxaRemovidos fração de registros removidos
+ * @param taxaNulos fração de nulos em cada campo que aceita nulo
+ */
+void geraVeiculos(char* nomeArquivo, long int nroVeiculos, long int nroLinhas, double taxaRemovidos, double taxaNulos) {
+    FILE* arquivo = fopen(nomeArquivo, "w");
+    if (arquivo == NULL) {
+        printf("Falha ao criar %s\n", nomeArquivo);
+        exit(1);
+    }
+
+    double* acumulada = criaDistribuicaoZipf(nroLinhas);
+
+    fputs("Prefixo do veiculo,Data de entrada do veiculo na frota,Quantidade de lugares sentados disponiveis,"
+          "Linha associada ao veiculo,Modelo do veiculo,Categoria do veiculo\n",
+          arquivo);
+
+    for (long int i = 0; i < nroVeiculos; i++) {
+        // acima de 36^5 o prefixo se repetiria, então o veiculo só pode entrar como removido
+        if (i >= PREFIXOS_DISTINTOS || aleatorioUniforme() < taxaRemovidos) fputc('*', arquivo);
+        escrevePrefixo(arquivo, i % PREFIXOS_DISTINTOS);
+
+        if (aleatorioUniforme() < taxaNulos)
+            fputs(",NULO", arquivo);
+        else
+            fprintf(arquivo, ",%04ld-%02ld-%02ld", 1990 + aleatorioAte(32), 1 + aleatorioAte(12), 1 + aleatorioAte(28));
+
+        fprintf(arquivo, ",%ld", 10 + aleatorioAte(51));
+
+        if (aleatorioUniforme() < taxaNulos)
+            fputs(",NULO", arquivo);
+        else
+            fprintf(arquivo, ",%ld", codigoDaLinha(sorteiaZipf(acumulada, nroLinhas), nroLinhas));
+
+        fprintf(arquivo, ",%s", aleatorioUniforme() < taxaNulos ? "NULO" : modelos[aleatorioAte(QUANTIDADE(modelos))]);
+        fprintf(arquivo, ",%s\n", aleatorioUniforme() < taxaNulos ? "NULO" : categorias[aleatorioAte(QUANTIDADE(categorias))]);
+    }
+
+    free(acumulada);
+    fclose(arquivo);
+}
+
+/**
+ * Gera o CSV de linhas, com códigos de 0 a nroLinhas - 1
+ * @param nomeArquivo nome do CSV
+ * @param nroLinhas quantidade de linhas
+ * @param taxaRemovidos fração de registros removidos
+ * @param taxaNulos fração de nulos em cada campo que aceita nulo
+ */
+void geraLinhas(char* nomeArquivo, long int nroLinhas, double taxaRemovidos, double taxaNulos) {
+    FILE* arquivo = fopen(nomeArquivo, "w");
+    if (arquivo == NULL) {
+        printf("Falha ao criar %s\n", nomeArquivo);
+        exit(1);
+    }
+
+    fputs("Codigo da linha,Aceita cartao,Nome da linha,Cor que descreve a linha\n", arquivo);
+
+    for (long int i = 0; i < nroLinhas; i++) {
+        if (aleatorioUniforme() < taxaRemovidos) fputc('*', arquivo);
+        fprintf(arquivo, "%ld,%s", i, cartoes[aleatorioAte(QUANTIDADE(cartoes))]);
+
+        if (aleatorioUniforme() < taxaNulos)
+            fputs(",NULO", arquivo);
+        else
+            fprintf(arquivo, ",%s-%s", bairros[aleatorioAte(QUANTIDADE(bairros))], bairros[aleatorioAte(QUANTIDADE(bairros))]);
+
+        fprintf(arquivo, ",%s\n", aleatorioUniforme() < taxaNulos ? "NULO" : cores[aleatorioAte(QUANTIDADE(cores))]);
+    }
+
+    fclose(arquivo);
+}
+
+int main(int argc, char const* argv[]) {
+    if (argc < 4) {
+        printf("Uso: %s <nroVeiculos> <nroLinhas> <prefixoSaida> [taxaRemovidos] [taxaNulos] [semente]\n", argv[0]);
+        return 1;
+    }
+
+    long int nroVeiculos = atol(argv[1]);
+    long int nroLinhas = atol(argv[2]);
+    double taxaRemovidos = argc > 4 ? atof(argv[4]) : 0.05;
+    double taxaNulos = argc > 5 ? atof(argv[5]) : 0.03;
+    estadoAleatorio = argc > 6 ? strtoull(argv[6], NULL, 10) : 2021;
+    if (estadoAleatorio == 0) estadoAleatorio = 1;  // o xorshift não sai do zero
+    if (nroLinhas < 1) nroLinhas = 1;
+
+    char nomeArquivo[300];
+
+    sprintf(nomeArquivo, "%sveiculo.csv", argv[3]);
+    geraVeiculos(nomeArquivo, nroVeiculos, nroLinhas, taxaRemovidos, taxaNulos);
+
+    sprintf(nomeArquivo, "%slinha.csv", argv[3]);
+    geraLinhas(nomeArquivo, nroLinhas, taxaRemovidos, taxaNulos);
+
+    return 0;
+}
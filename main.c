@@ -10,12 +10,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "source/arvore/arvore.h"
+#include "source/estatisticas/estatisticas.h"
 #include "source/linha/linha.h"
 #include "source/utils/utils.h"
 #include "source/veiculo/veiculo.h"
 
-void menu() {
-    int funcionalidade, numeroDeEntradas;
+#define FIM_DE_RESPOSTA "#FIM"  // linha que encerra a saída de cada comando no modo servidor
+
+/**
+ * Lê os parâmetros de uma funcionalidade da entrada padrão e a executa
+ * @param funcionalidade número da funcionalidade
+ */
+void executaFuncionalidade(int funcionalidade) {
+    int numeroDeEntradas;
     char nomeArquivoCSV[100];
     char nomeArquivoBin[100];
     char nomeArquivoBin2[100];
@@ -24,7 +32,12 @@ void menu() {
     char nomeDoCampoBuscado[100];
     char valorBuscado[100];
     int valorBuscadoVeiculoArvore;
-    scanf("%d", &funcionalidade);  //le o modo que o programa deve operar
+    int inicioIntervalo, fimIntervalo;
+    double fatorPreenchimento;
+
+    char nomeFase[32];
+    sprintf(nomeFase, "funcionalidade %d", funcionalidade);
+    iniciaFase(nomeFase);
 
     switch (funcionalidade) {
         case 1:
@@ -107,7 +120,6 @@ void menu() {
             scanf("%*s");
             scanf("%*s");
             SelectFromWhereNestedLoop(nomeArquivoBin, nomeArquivoBin2);
-            return;
             break;
         case 16:
             scanf("%s", nomeArquivoBin);
@@ -116,7 +128,6 @@ void menu() {
             scanf("%*s");
             scanf("%s", nomeArquivoBinIndice);
             SelectFromWhereUniqueLoop(nomeArquivoBin, nomeArquivoBin2, nomeArquivoBinIndice);
-            return;
             break;
         case 17:
             scanf("%s", nomeArquivoBin);
@@ -134,16 +145,123 @@ void menu() {
             scanf("%s", nomeArquivoBin);
             scanf("%s", nomeArquivoBin2);
             scanf("%*s %*s");
-            if (!SortReg_Veiculo(nomeArquivoBin, "veiculo-ordenado.bin")) return;
-            if (!SortReg_Linha(nomeArquivoBin2, "linha-ordenado.bin")) return;
+            if (!SortReg_Veiculo(nomeArquivoBin, "veiculo-ordenado.bin")) break;
+            if (!SortReg_Linha(nomeArquivoBin2, "linha-ordenado.bin")) break;
             Search_LinhaVeiculo("veiculo-ordenado.bin", "linha-ordenado.bin");
             break;
+        case 20:
+            scanf("%s", nomeArquivoBin);
+            scanf("%s", nomeArquivoBinIndice);
+            scanf("%lf", &fatorPreenchimento);
+            CreateIndexEmLote_Veiculo(nomeArquivoBin, nomeArquivoBinIndice, fatorPreenchimento);
+            break;
+        case 21:
+            scanf("%s", nomeArquivoBin);
+            scanf("%s", nomeArquivoBinIndice);
+            scanf("%lf", &fatorPreenchimento);
+            CreateIndexEmLote_Linha(nomeArquivoBin, nomeArquivoBinIndice, fatorPreenchimento);
+            break;
+        case 22:
+            scanf("%s", nomeArquivoBin);
+            scanf("%s", nomeArquivoBin2);
+            scanf("%*s");
+            scanf("%*s");
+            SelectFromWhereHashJoin(nomeArquivoBin, nomeArquivoBin2);
+            break;
+        case 23:
+            scanf("%s", nomeArquivoBin);
+            scanf("%s", nomeArquivoBinIndice);
+            scanf("%lf", &fatorPreenchimento);
+            CreateIndexArvoreMais_Linha(nomeArquivoBin, nomeArquivoBinIndice, fatorPreenchimento);
+            break;
+        case 24:
+            scanf("%s", nomeArquivoBin);
+            scanf("%s", nomeArquivoBinIndice);
+            scanf("%*s");
+            scanf("%d %d", &inicioIntervalo, &fimIntervalo);
+            SelectFromWhereIntervalo_Linha(nomeArquivoBin, nomeArquivoBinIndice, inicioIntervalo, fimIntervalo);
+            break;
+        case 25:
+            scanf("%s", nomeArquivoBin);
+            scanf("%s", nomeDoCampoBuscado);
+            CreateIndexHash_Veiculo(nomeArquivoBin, nomeDoCampoBuscado);
+            break;
+        case 26:
+            scanf("%s", nomeArquivoBin);
+            scanf("%s", nomeDoCampoBuscado);
+            CreateIndexHash_Linha(nomeArquivoBin, nomeDoCampoBuscado);
+            break;
+        case 27:
+            scanf("%s", nomeArquivoBin);
+            scanf("%s", nomeArquivoBinIndice);
+            Vacuum_Veiculo(nomeArquivoBin, nomeArquivoBinIndice);
+            break;
+        case 28:
+            scanf("%s", nomeArquivoBin);
+            scanf("%s", nomeArquivoBinIndice);
+            Vacuum_Linha(nomeArquivoBin, nomeArquivoBinIndice);
+            break;
         default:
             break;
     }
+
+    encerraFase();
+}
+
+/**
+ * Executa os comandos lidos da entrada padrão, um após o outro, no mesmo processo até o fim da entrada
+ * ou até a funcionalidade 0. As arvores de indices ficam abertas entre os comandos
+ * @param fimDeResposta linha escrita ao final da saída de cada comando, ou NULL para não separar as saídas
+ */
+void executaSessao(char* fimDeResposta) {
+    int funcionalidade;
+
+    iniciaSessaoArvores();
+
+    while (scanf("%d", &funcionalidade) == 1 && funcionalidade != 0) {
+        executaFuncionalidade(funcionalidade);
+        if (fimDeResposta != NULL) {
+            printf("\n%s\n", fimDeResposta);
+            fflush(stdout);
+        }
+    }
+
+    encerraSessaoArvores();
 }
 
-int main() {
-    menu();
+/**
+ * Modo script: executa em um único processo a sequência de comandos guardada em um arquivo,
+ * no mesmo formato da entrada padrão (incluindo os registros das inserções)
+ * @param nomeArquivoScript nome do arquivo com os comandos
+ */
+void executaScript(char* nomeArquivoScript) {
+    if (freopen(nomeArquivoScript, "r", stdin) == NULL) {
+        printf("Falha no processamento do arquivo.");
+        return;
+    }
+
+    executaSessao(NULL);
+}
+
+void menu() {
+    int funcionalidade;
+    scanf("%d", &funcionalidade);  //le o modo que o programa deve operar
+
+    if (funcionalidade == 29)
+        executaSessao(FIM_DE_RESPOSTA);  // modo servidor
+    else
+        executaFuncionalidade(funcionalidade);
+}
+
+int main(int argc, char* argv[]) {
+    iniciaEstatisticas();
+
+    // a saída é escrita em blocos grandes, o modo servidor descarrega ao fim de cada resposta
+    setvbuf(stdout, NULL, _IOFBF, TAMANHO_BUFFER_SAIDA);
+
+    if (argc > 1)
+        executaScript(argv[1]);
+    else
+        menu();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Cria uma arena sem nenhum bloco
+ * @param tamanhoBloco tamanho de cada bloco, limitado a TAMANHO_BLOCO_ARENA
+ * @return ponteiro para a arena criada
+ */
+arena* criaArena(long int tamanhoBloco) {
+    arena* a = (arena*)malloc(sizeof(arena));
+    a->capacidadeBlocos = 8;
+    a->blocos = (char**)malloc(a->capacidadeBlocos * sizeof(char*));
+    a->tamanhos = (long int*)malloc(a->capacidadeBlocos * sizeof(long int));
+    a->nroBlocos = 0;
+    a->tamanhoBloco = (tamanhoBloco < 1) ? 1 : (tamanhoBloco > TAMANHO_BLOCO_ARENA) ? TAMANHO_BLOCO_ARENA : tamanhoBloco;
+    a->blocoAtual = -1;
+    a->usadoBloco = 0;
+    a->reservado = 0;
+    return a;
+}
+
+/**
+ * Reserva uma região na arena, que continua válida até a arena ser esvaziada ou liberada
+ * @param a arena
+ * @param tamanho quantidade de bytes
+ * @return ponteiro para o inicio da região
+ */
+char* alocaArena(arena* a, long int tamanho) {
+    // passa para o próximo bloco quando o atual não comporta a região, alocando-o caso ainda não exista
+    while (a->blocoAtual < 0 || a->tamanhos[a->blocoAtual] - a->usadoBloco < tamanho) {
+        a->blocoAtual++;
+        a->usadoBloco = 0;
+
+        if (a->blocoAtual == a->nroBlocos) {
+            if (a->nroBlocos == a->capacidadeBlocos) {
+                a->capacidadeBlocos *= 2;
+                a->blocos = (char**)realloc(a->blocos, a->capacidadeBlocos * sizeof(char*));
+                a->tamanhos = (long int*)realloc(a->tamanhos, a->capacidadeBlocos * sizeof(long int));
+            }
+            a->tamanhos[a->nroBlocos] = (tamanho > a->tamanhoBloco) ? tamanho : a->tamanhoBloco;
+            a->blocos[a->nroBlocos] = (char*)malloc(a->tamanhos[a->nroBlocos]);
+            a->nroBlocos++;
+        }
+        a->reservado += a->tamanhos[a->blocoAtual];
+    }
+
+    char* regiao = a->blocos[a->blocoAtual] + a->usadoBloco;
+    a->usadoBloco += tamanho;
+    return regiao;
+}
+
+/**
+ * Calcula quanto da arena estaria em uso depois de uma reserva, contando blocos inteiros
+ * @param a arena
+ * @param tamanho quantidade de bytes da próxima reserva
+ * @return tamanho dos blocos em uso depois da reserva
+ */
+long int ocupacaoArena(arena* a, long int tamanho) {
+    if (a->blocoAtual >= 0 && a->tamanhos[a->blocoAtual] - a->usadoBloco >= tamanho) return a->reservado;
+
+    long int proximoBloco = (a->blocoAtual + 1 < a->nroBlocos) ? a->tamanhos[a->blocoAtual + 1] : a->tamanhoBloco;
+    return a->reservado + ((proximoBloco > tamanho) ? proximoBloco : tamanho);
+}
+
+/**
+ * Descarta todas as regiões reservadas, os blocos ficam alocados para as próximas reservas
+ * @param a arena
+ */
+void esvaziaArena(arena* a) {
+    a->blocoAtual = -1;
+    a->usadoBloco = 0;
+    a->reservado = 0;
+}
+
+/**
+ * Libera a arena e todos os seus blocos
+ * @param a arena
+ */
+void liberaArena(arena* a) {
+    for (int i = 0; i < a->nroBlocos; i++) free(a->blocos[i]);
+    free(a->blocos);
+    free(a->tamanhos);
+    free(a);
+}
@@ -0,0 +1,29 @@
+#ifndef _ARENA_H_
+#define _ARENA_H_
+#include <stdio.h>
+
+#define TAMANHO_BLOCO_ARENA 1048576L  // maior tamanho de bloco da arena (1 MiB)
+
+/**
+ * Alocador em blocos grandes onde cada alocação só avança a posição livre do bloco atual,
+ * sem cabeçalho nem alinhamento por alocação. As regiões não são liberadas uma a uma,
+ * a arena inteira é esvaziada (mantendo os blocos para reuso) ou liberada de uma vez
+ */
+typedef struct arena {
+    char** blocos;
+    long int* tamanhos;  // tamanho de cada bloco, maior que tamanhoBloco só para alocações maiores que ele
+    int nroBlocos;
+    int capacidadeBlocos;
+    long int tamanhoBloco;
+    int blocoAtual;
+    long int usadoBloco;  // bytes ocupados no bloco atual
+    long int reservado;   // tamanho dos blocos em uso, do primeiro até o atual, incluindo o que sobrou no fim de cada um
+} arena;
+
+arena* criaArena(long int tamanhoBloco);
+char* alocaArena(arena* a, long int tamanho);
+long int ocupacaoArena(arena* a, long int tamanho);
+void esvaziaArena(arena* a);
+void liberaArena(arena* a);
+
+#endif
@@ -1,5 +1,24 @@
 #include "arvore.h"
 
+#include <string.h>
+#include <sys/stat.h>
+
+#include "../estatisticas/estatisticas.h"
+
+/**
+ * Arvores mantidas abertas entre os comandos de uma sessão (modo servidor ou script), identificadas pelo
+ * dispositivo e inode do arquivo para que dois caminhos para o mesmo arquivo não tenham buffers distintos
+ */
+typedef struct sessaoArvores {
+    int ativa;
+    int quantidade;
+    arvore* arvores[TAMANHO_SESSAO_ARVORES];
+    dev_t dispositivos[TAMANHO_SESSAO_ARVORES];
+    ino_t inodes[TAMANHO_SESSAO_ARVORES];
+} sessaoArvores;
+
+static sessaoArvores sessao = {0};
+
 void imprimeHeader(arvore* currArvore) {
     printf("============== HEADER ==============\n");
     printf("status: %c\n", currArvore->header.status);
@@ -14,7 +33,7 @@ void imprimeNo(arvoreNo* no) {
     printf("F: %c ", no->folha);
     printf("N: %d|", no->nroChavesIndexadas);
 
-    for (int i = 0; i < ORDEM_ARVORE - 1; i++) {
+    for (int i = 0; i < no->nroChavesIndexadas; i++) {
         printf(" %d:", i);
         printf("[(%d,", no->registros[i].P_ant);
         printf("%d), ", no->registros[i].P_prox);
@@ -42,7 +61,7 @@ void imprimeNoRecursivo(arvore* currArvore, arvoreNo* no, int depth) {
     printf("F: %c ", no->folha);
     printf("N: %d|", no->nroChavesIndexadas);
 
-    for (int i = 0; i < ORDEM_ARVORE - 1; i++) {
+    for (int i = 0; i < currArvore->header.ordem - 1; i++) {
         printf(" %d:", i);
         printf("[(%d,", no->registros[i].P_ant);
         printf("%d), ", no->registros[i].P_prox);
@@ -51,17 +70,21 @@ void imprimeNoRecursivo(arvore* currArvore, arvoreNo* no, int depth) {
     }
     printf("\n");
 
-    for (int i = 0; i < ORDEM_ARVORE - 1; i++) {
+    for (int i = 0; i < currArvore->header.ordem - 1; i++) {
         if (no->registros[i].C != -1 && no->registros[i].P_ant != -1) {
             arvoreNo proxNo;
+            iniciaNoArvore(currArvore, &proxNo);
             lerNoArvore(currArvore, &proxNo, no->registros[i].P_ant);
             imprimeNoRecursivo(currArvore, &proxNo, depth + 6);
+            liberaNoArvore(&proxNo);
         }
     }
     if (no->registros[no->nroChavesIndexadas - 1].P_prox != -1) {
         arvoreNo proxNo;
+        iniciaNoArvore(currArvore, &proxNo);
         lerNoArvore(currArvore, &proxNo, no->registros[no->nroChavesIndexadas - 1].P_prox);
         imprimeNoRecursivo(currArvore, &proxNo, depth + 6);
+        liberaNoArvore(&proxNo);
     }
 }
 
@@ -71,37 +94,185 @@ void imprimeArvore(arvore* currArvore) {
     imprimeNoRecursivo(currArvore, &currArvore->raiz, 0);
 }
 
+/**
+ * Desce pela subárvore mais à esquerda até uma folha, sem contar as leituras nas estatisticas
+ * @param currArvore arvore a ser medida
+ * @return quantidade de niveis da arvore
+ */
+int calculaAlturaArvore(arvore* currArvore) {
+    if (currArvore->header.noRaiz == -1) return 0;
+
+    contadores antes = estatisticas;
+    arvoreNo currNo;
+    iniciaNoArvore(currArvore, &currNo);
+    copiaNoArvore(currArvore, &currNo, &currArvore->raiz);
+    int altura = 1;
+
+    while (currNo.folha != '1' && currNo.nroChavesIndexadas > 0 && currNo.registros[0].P_ant != -1) {
+        lerNoArvore(currArvore, &currNo, currNo.registros[0].P_ant);
+        altura++;
+    }
+
+    liberaNoArvore(&currNo);
+    estatisticas = antes;
+    return altura;
+}
+
+/**
+ * Libera a struct alocada, escreve os nós pendentes do buffer, salva as modificações e fecha o arquivo
+ * @param currArvore arvore a ser liberada
+ * 
+ */
+void finalizaArvore(arvore* currArvore) {
+    if (estatisticasAtivas()) registraAlturaArvore(calculaAlturaArvore(currArvore));
+
+    descarregaBufferArvore(currArvore);
+
+    currArvore->header.status = '1';
+    salvaHeaderArvore(currArvore);
+
+    // durante uma sessão a arvore continua aberta, com o buffer aquecido, para o próximo comando
+    for (int i = 0; i < sessao.quantidade; i++) {
+        if (sessao.arvores[i] == currArvore) {
+            fflush(currArvore->arquivoIndice);
+            return;
+        }
+    }
+
+    fclose(currArvore->arquivoIndice);
+    liberaNoArvore(&currArvore->raiz);
+    free(currArvore->buffer.registros);
+    free(currArvore);
+}
+
+/**
+ * Procura na sessão a arvore aberta para o arquivo
+ * @param nomeArquivoIndice nome do arquivo de indices
+ * @return posição da arvore na sessão ou -1 caso o arquivo não esteja aberto
+ */
+int buscaArvoreSessao(char nomeArquivoIndice[]) {
+    struct stat informacoes;
+    if (!sessao.ativa || stat(nomeArquivoIndice, &informacoes) != 0) return -1;
+
+    for (int i = 0; i < sessao.quantidade; i++)
+        if (sessao.dispositivos[i] == informacoes.st_dev && sessao.inodes[i] == informacoes.st_ino) return i;
+
+    return -1;
+}
+
+/**
+ * Fecha a arvore de uma posição da sessão e a remove da sessão
+ * @param posicao posição da arvore na sessão
+ */
+void removeArvoreSessao(int posicao) {
+    arvore* currArvore = sessao.arvores[posicao];
+
+    sessao.quantidade--;
+    sessao.arvores[posicao] = sessao.arvores[sessao.quantidade];
+    sessao.dispositivos[posicao] = sessao.dispositivos[sessao.quantidade];
+    sessao.inodes[posicao] = sessao.inodes[sessao.quantidade];
+
+    finalizaArvore(currArvore);
+}
+
+/**
+ * Guarda uma arvore recém carregada na sessão, fechando a mais antiga caso a sessão esteja cheia
+ * @param currArvore arvore carregada
+ */
+void adicionaArvoreSessao(arvore* currArvore) {
+    struct stat informacoes;
+    if (!sessao.ativa || fstat(fileno(currArvore->arquivoIndice), &informacoes) != 0) return;
+
+    if (sessao.quantidade == TAMANHO_SESSAO_ARVORES) removeArvoreSessao(0);
+
+    sessao.arvores[sessao.quantidade] = currArvore;
+    sessao.dispositivos[sessao.quantidade] = informacoes.st_dev;
+    sessao.inodes[sessao.quantidade] = informacoes.st_ino;
+    sessao.quantidade++;
+}
+
+/**
+ * Inicia uma sessão, a partir daqui as arvores carregadas continuam abertas até o fim da sessão
+ */
+void iniciaSessaoArvores() {
+    sessao.ativa = 1;
+    sessao.quantidade = 0;
+}
+
+/**
+ * Encerra a sessão, salvando e fechando todas as arvores mantidas abertas
+ */
+void encerraSessaoArvores() {
+    while (sessao.quantidade > 0) removeArvoreSessao(sessao.quantidade - 1);
+    sessao.ativa = 0;
+}
+
 /**
  * Aloca uma struct do tipo arvore e inicializa seus valores
  * @param nomeArquivoIndice nome do arquivo onde os indices serão salvos
- * @return ponteiro para a struct do tipo arvore
+ * @param versao versão do formato do arquivo, 1 para o original, 2 para o paginado e 3 para a arvore B+ paginada
+ * @return ponteiro para a struct do tipo arvore ou NULL caso o arquivo não possa ser criado
  */
-arvore* criaArvore(char nomeArquivoIndice[]) {
+arvore* criaArvoreVersao(char nomeArquivoIndice[], int versao) {
+    // o arquivo será truncado, então uma cópia aberta na sessão deixa de valer
+    int posicaoSessao = buscaArvoreSessao(nomeArquivoIndice);
+    if (posicaoSessao != -1) removeArvoreSessao(posicaoSessao);
+
     arvore* novaArvore = (arvore*)malloc(sizeof(arvore));
 
+    novaArvore->arquivoIndice = fopen(nomeArquivoIndice, "w+");
+
+    if (novaArvore->arquivoIndice == NULL) {
+        printf("Falha no processamento do arquivo.");
+        free(novaArvore);
+        return NULL;
+    }
+
     novaArvore->header.status = '1';
     novaArvore->header.noRaiz = -1;
     novaArvore->header.RRNproxNo = 0;
 
     for (int i = 0; i < 68; i++) novaArvore->header.lixo[i] = '@';
 
-    novaArvore->arquivoIndice = fopen(nomeArquivoIndice, "w+");
+    novaArvore->header.versao = versao;
+    novaArvore->header.ordem = (versao == 1) ? ORDEM_ARVORE : ORDEM_PAGINADA;
+    novaArvore->header.tamanhoNo = (versao == 1) ? TAMANHO_NO_ARVORE : TAMANHO_PAGINA_ARVORE;
+
+    iniciaBufferArvore(novaArvore);
+    iniciaNoArvore(novaArvore, &novaArvore->raiz);
+    criarNovoNo(novaArvore, &novaArvore->raiz, '0', -1);
+
     salvaHeaderArvore(novaArvore);
 
     return novaArvore;
 }
 
 /**
- * Libera a struct alocada, salva as modificações e fecha o arquivo
- * @param currArvore arvore a ser liberada
- * 
+ * Cria uma arvore no formato original, de ordem 5 e nós de 77 bytes
+ * @param nomeArquivoIndice nome do arquivo onde os indices serão salvos
+ * @return ponteiro para a struct do tipo arvore
  */
-void finalizaArvore(arvore* currArvore) {
-    currArvore->header.status = '1';
-    salvaHeaderArvore(currArvore);
+arvore* criaArvore(char nomeArquivoIndice[]) {
+    return criaArvoreVersao(nomeArquivoIndice, 1);
+}
 
-    fclose(currArvore->arquivoIndice);
-    free(currArvore);
+/**
+ * Cria uma arvore no formato paginado, onde cada nó ocupa uma página de 4 KiB
+ * e guarda ORDEM_PAGINADA - 1 chaves, deixando a arvore com poucos niveis
+ * @param nomeArquivoIndice nome do arquivo onde os indices serão salvos
+ * @return ponteiro para a struct do tipo arvore
+ */
+arvore* criaArvorePaginada(char nomeArquivoIndice[]) {
+    return criaArvoreVersao(nomeArquivoIndice, 2);
+}
+
+/**
+ * Cria uma arvore B+ no formato paginado, com as folhas encadeadas para buscas por intervalo
+ * @param nomeArquivoIndice nome do arquivo onde os indices serão salvos
+ * @return ponteiro para a struct do tipo arvore
+ */
+arvore* criaArvoreMais(char nomeArquivoIndice[]) {
+    return criaArvoreVersao(nomeArquivoIndice, VERSAO_ARVORE_MAIS);
 }
 
 /**
@@ -114,27 +285,57 @@ void alteraStatusArvore(arvore* currArvore) {
     salvaHeaderArvore(currArvore);
 }
 
+/**
+ * Aloca os registros de um nó de acordo com a ordem da arvore
+ * @param currArvore arvore dona do nó
+ * @param no nó a ser preparado
+ */
+void iniciaNoArvore(arvore* currArvore, arvoreNo* no) {
+    no->registros = (registro*)malloc((currArvore->header.ordem - 1) * sizeof(registro));
+}
+
+/**
+ * Copia um nó para outro já preparado por iniciaNoArvore
+ * @param currArvore arvore dona dos nós
+ * @param destino nó que receberá a cópia
+ * @param origem nó copiado
+ */
+void copiaNoArvore(arvore* currArvore, arvoreNo* destino, arvoreNo* origem) {
+    destino->folha = origem->folha;
+    destino->nroChavesIndexadas = origem->nroChavesIndexadas;
+    destino->RRNdoNo = origem->RRNdoNo;
+    destino->proximaFolha = origem->proximaFolha;
+    memcpy(destino->registros, origem->registros, (currArvore->header.ordem - 1) * sizeof(registro));
+}
+
+/**
+ * Libera os registros de um nó preparado por iniciaNoArvore
+ * @param no nó a ser liberado
+ */
+void liberaNoArvore(arvoreNo* no) {
+    free(no->registros);
+    no->registros = NULL;
+}
+
 /**
  * Cria um novo nó de arbore b
+ * @param currArvore arvore dona do nó
+ * @param noCriado nó já preparado por iniciaNoArvore, que será inicializado
  * @param isFolha define se o nó criado será folha ou não
  * @param RRndoNo RRN do nó que será criado
- * @return nó criado e inicializado
  */
-arvoreNo criarNovoNo(char isFolha, int RRndoNo) {
-    arvoreNo noCriado;
-
-    noCriado.folha = isFolha;
-    noCriado.nroChavesIndexadas = 0;
-    noCriado.RRNdoNo = RRndoNo;
-
-    for (int i = 0; i < ORDEM_ARVORE - 1; i++) {
-        noCriado.registros[i].P_ant = -1;
-        noCriado.registros[i].P_prox = -1;
-        noCriado.registros[i].C = -1;
-        noCriado.registros[i].Pr = -1;
+void criarNovoNo(arvore* currArvore, arvoreNo* noCriado, char isFolha, int RRndoNo) {
+    noCriado->folha = isFolha;
+    noCriado->nroChavesIndexadas = 0;
+    noCriado->RRNdoNo = RRndoNo;
+    noCriado->proximaFolha = -1;
+
+    for (int i = 0; i < currArvore->header.ordem - 1; i++) {
+        noCriado->registros[i].P_ant = -1;
+        noCriado->registros[i].P_prox = -1;
+        noCriado->registros[i].C = -1;
+        noCriado->registros[i].Pr = -1;
     }
-
-    return noCriado;
 }
 
 /**
@@ -147,6 +348,13 @@ void salvaHeaderArvore(arvore* currArvore) {
     fwrite(&currArvore->header.status, sizeof(char), 1, currArvore->arquivoIndice);
     fwrite(&currArvore->header.noRaiz, sizeof(int), 1, currArvore->arquivoIndice);
     fwrite(&currArvore->header.RRNproxNo, sizeof(int), 1, currArvore->arquivoIndice);
+
+    // a partir da versão 2 a versão, a ordem e o tamanho dos nós ficam no inicio do lixo
+    if (currArvore->header.versao > 1) {
+        currArvore->header.lixo[0] = '0' + currArvore->header.versao;
+        memcpy(&currArvore->header.lixo[1], &currArvore->header.ordem, sizeof(int));
+        memcpy(&currArvore->header.lixo[5], &currArvore->header.tamanhoNo, sizeof(int));
+    }
     fwrite(&currArvore->header.lixo, sizeof(char), 68, currArvore->arquivoIndice);
 }
 
@@ -162,6 +370,17 @@ void leHeaderArvore(FILE* arquivoIndice, arvoreHeader* header) {
     fread(&header->noRaiz, sizeof(int), 1, arquivoIndice);
     fread(&header->RRNproxNo, sizeof(int), 1, arquivoIndice);
     fread(&header->lixo, sizeof(char), 68, arquivoIndice);
+
+    // o formato original não tem versão e tem o lixo todo preenchido com '@'
+    if (header->lixo[0] == '@') {
+        header->versao = 1;
+        header->ordem = ORDEM_ARVORE;
+        header->tamanhoNo = TAMANHO_NO_ARVORE;
+    } else {
+        header->versao = header->lixo[0] - '0';
+        memcpy(&header->ordem, &header->lixo[1], sizeof(int));
+        memcpy(&header->tamanhoNo, &header->lixo[5], sizeof(int));
+    }
 }
 
 /**
@@ -170,6 +389,9 @@ void leHeaderArvore(FILE* arquivoIndice, arvoreHeader* header) {
  * @return ponteiro para a struct do tipo arvore
  */
 arvore* carregaArvore(char nomeArquivoIndice[]) {
+    int posicaoSessao = buscaArvoreSessao(nomeArquivoIndice);
+    if (posicaoSessao != -1) return sessao.arvores[posicaoSessao];
+
     arvore* novaArvore = (arvore*)malloc(sizeof(arvore));
 
     novaArvore->arquivoIndice = fopen(nomeArquivoIndice, "r+");
@@ -182,64 +404,239 @@ arvore* carregaArvore(char nomeArquivoIndice[]) {
 
     leHeaderArvore(novaArvore->arquivoIndice, &novaArvore->header);
 
-    if (novaArvore->header.status == '0') {
+    // além do status o formato precisa ser um que esta versão consiga ler
+    int formatoValido = novaArvore->header.ordem >= 3 && novaArvore->header.ordem <= ORDEM_MAXIMA &&
+                        novaArvore->header.tamanhoNo >= 13 + 16 * (novaArvore->header.ordem - 1) &&
+                        novaArvore->header.tamanhoNo <= TAMANHO_PAGINA_ARVORE;
+
+    if (novaArvore->header.status == '0' || !formatoValido) {
         printf("Falha no processamento do arquivo.");
         fclose(novaArvore->arquivoIndice);
         free(novaArvore);
         return NULL;
     }
 
+    iniciaBufferArvore(novaArvore);
+    iniciaNoArvore(novaArvore, &novaArvore->raiz);
     lerNoArvore(novaArvore, &novaArvore->raiz, novaArvore->header.noRaiz);
+    adicionaArvoreSessao(novaArvore);
 
     return novaArvore;
 }
 
 /**
- * Lê um nó especifico de uma arvore
+ * Lê um nó especifico diretamente do arquivo, sem passar pelo buffer
+ * o nó inteiro é lido com uma única leitura e depois separado em campos
  * @param currArvore arvore de onde o nó será lido
  * @param novoNo variável onde o nó lido será salvo
  * @param RRN RRN do nó a ser lido
  */
-void lerNoArvore(arvore* currArvore, arvoreNo* novoNo, int RRN) {
-    fseek(currArvore->arquivoIndice, (RRN + 1) * 77, 0);
+void lerNoDisco(arvore* currArvore, arvoreNo* novoNo, int RRN) {
+    CONTA(nosLidosDisco, 1);
+    int ordem = currArvore->header.ordem;
+    int tamanhoNo = currArvore->header.tamanhoNo;
+    char pagina[TAMANHO_PAGINA_ARVORE];
+
+    memset(pagina, 0, tamanhoNo);
+    fseek(currArvore->arquivoIndice, (long int)(RRN + 1) * tamanhoNo, 0);
+    fread(pagina, sizeof(char), tamanhoNo, currArvore->arquivoIndice);
+
+    char* atual = pagina;
+
+    novoNo->folha = *atual++;
+    memcpy(&novoNo->nroChavesIndexadas, atual, sizeof(int));
+    atual += sizeof(int);
+    memcpy(&novoNo->RRNdoNo, atual, sizeof(int));
+    atual += sizeof(int);
+
+    memcpy(&novoNo->registros[0].P_ant, atual, sizeof(int));
+    atual += sizeof(int);
+
+    for (int i = 0; i < ordem - 1; i++) {
+        memcpy(&novoNo->registros[i].C, atual, sizeof(int));
+        atual += sizeof(int);
+        memcpy(&novoNo->registros[i].Pr, atual, sizeof(long int));
+        atual += sizeof(long int);
+        memcpy(&novoNo->registros[i].P_prox, atual, sizeof(int));
+        atual += sizeof(int);
+    }
 
-    fread(&novoNo->folha, sizeof(char), 1, currArvore->arquivoIndice);
-    fread(&novoNo->nroChavesIndexadas, sizeof(int), 1, currArvore->arquivoIndice);
-    fread(&novoNo->RRNdoNo, sizeof(int), 1, currArvore->arquivoIndice);
+    for (int i = 0; i < ordem - 2; i++) {
+        novoNo->registros[i + 1].P_ant = novoNo->registros[i].P_prox;
+    }
 
-    fread(&novoNo->registros[0].P_ant, sizeof(int), 1, currArvore->arquivoIndice);
+    // nas folhas da arvore B+ o último P guarda a próxima folha
+    novoNo->proximaFolha = -1;
+    if (currArvore->header.versao == VERSAO_ARVORE_MAIS && novoNo->folha == '1') {
+        novoNo->proximaFolha = novoNo->registros[ordem - 2].P_prox;
+        novoNo->registros[ordem - 2].P_prox = -1;
+    }
+}
 
-    for (int i = 0; i < ORDEM_ARVORE - 1; i++) {
-        fread(&novoNo->registros[i].C, sizeof(int), 1, currArvore->arquivoIndice);
-        fread(&novoNo->registros[i].Pr, sizeof(long int), 1, currArvore->arquivoIndice);
-        fread(&novoNo->registros[i].P_prox, sizeof(int), 1, currArvore->arquivoIndice);
+/**
+ * Salva um nó especifico diretamente no arquivo, sem passar pelo buffer
+ * o nó é montado em memória, completado com '@' até o tamanho do nó e escrito de uma vez
+ * @param currArvore arvore de onde o nó será salvo
+ * @param novoNo nó que será salvo
+ * @param RRN RRN que indica onde o nó será salvo
+ */
+void salvaNoDisco(arvore* currArvore, arvoreNo* novoNo, int RRN) {
+    CONTA(nosSalvosDisco, 1);
+    int ordem = currArvore->header.ordem;
+    int tamanhoNo = currArvore->header.tamanhoNo;
+    char pagina[TAMANHO_PAGINA_ARVORE];
+
+    memset(pagina, '@', tamanhoNo);
+    char* atual = pagina;
+
+    *atual++ = novoNo->folha;
+    memcpy(atual, &novoNo->nroChavesIndexadas, sizeof(int));
+    atual += sizeof(int);
+    memcpy(atual, &novoNo->RRNdoNo, sizeof(int));
+    atual += sizeof(int);
+
+    memcpy(atual, &novoNo->registros[0].P_ant, sizeof(int));
+    atual += sizeof(int);
+
+    for (int i = 0; i < ordem - 1; i++) {
+        memcpy(atual, &novoNo->registros[i].C, sizeof(int));
+        atual += sizeof(int);
+        memcpy(atual, &novoNo->registros[i].Pr, sizeof(long int));
+        atual += sizeof(long int);
+        memcpy(atual, &novoNo->registros[i].P_prox, sizeof(int));
+        atual += sizeof(int);
     }
 
-    for (int i = 0; i < ORDEM_ARVORE - 2; i++) {
-        novoNo->registros[i + 1].P_ant = novoNo->registros[i].P_prox;
+    // nas folhas da arvore B+ o último P guarda a próxima folha
+    if (currArvore->header.versao == VERSAO_ARVORE_MAIS && novoNo->folha == '1') {
+        memcpy(atual - sizeof(int), &novoNo->proximaFolha, sizeof(int));
+    }
+
+    fseek(currArvore->arquivoIndice, (long int)(RRN + 1) * tamanhoNo, 0);
+    fwrite(pagina, sizeof(char), tamanhoNo, currArvore->arquivoIndice);
+}
+
+/**
+ * Inicializa o buffer de nós da arvore com todos os quadros livres,
+ * os registros dos quadros são alocados de acordo com a ordem da arvore
+ * @param currArvore arvore que terá o buffer inicializado
+ */
+void iniciaBufferArvore(arvore* currArvore) {
+    int registrosPorNo = currArvore->header.ordem - 1;
+    currArvore->buffer.registros = (registro*)malloc(TAMANHO_BUFFER_ARVORE * registrosPorNo * sizeof(registro));
+
+    for (int i = 0; i < TAMANHO_BUFFER_ARVORE; i++) {
+        currArvore->buffer.quadros[i].no.registros = currArvore->buffer.registros + i * registrosPorNo;
+        currArvore->buffer.quadros[i].RRN = -1;
+        currArvore->buffer.quadros[i].sujo = '0';
+        currArvore->buffer.quadros[i].referencia = '0';
+    }
+
+    currArvore->buffer.ponteiroRelogio = 0;
+}
+
+/**
+ * Procura no buffer o quadro que contém um nó
+ * @param currArvore arvore dona do buffer
+ * @param RRN RRN do nó buscado
+ * @return indice do quadro ou -1 caso o nó não esteja no buffer
+ */
+int buscaQuadroBuffer(arvore* currArvore, int RRN) {
+    for (int i = 0; i < TAMANHO_BUFFER_ARVORE; i++) {
+        if (currArvore->buffer.quadros[i].RRN == RRN) return i;
+    }
+    return -1;
+}
+
+/**
+ * Escolhe um quadro para receber um novo nó usando o algoritmo do relógio,
+ * caso o nó que ocupava o quadro esteja sujo ele é escrito no disco antes de ser descartado
+ * @param currArvore arvore dona do buffer
+ * @return indice do quadro liberado
+ */
+int liberaQuadroBuffer(arvore* currArvore) {
+    bufferArvore* buffer = &currArvore->buffer;
+
+    while (1) {
+        quadroBuffer* quadro = &buffer->quadros[buffer->ponteiroRelogio];
+        int indice = buffer->ponteiroRelogio;
+        buffer->ponteiroRelogio = (buffer->ponteiroRelogio + 1) % TAMANHO_BUFFER_ARVORE;
+
+        if (quadro->RRN != -1 && quadro->referencia == '1') {  // ganha uma segunda chance
+            quadro->referencia = '0';
+            continue;
+        }
+
+        if (quadro->RRN != -1 && quadro->sujo == '1') salvaNoDisco(currArvore, &quadro->no, quadro->RRN);
+
+        quadro->RRN = -1;
+        quadro->sujo = '0';
+        return indice;
     }
 }
 
 /**
- * Salva um nó especifico de uma arvore
+ * Escreve no disco todos os nós alterados que ainda estão no buffer
+ * @param currArvore arvore dona do buffer
+ */
+void descarregaBufferArvore(arvore* currArvore) {
+    for (int i = 0; i < TAMANHO_BUFFER_ARVORE; i++) {
+        quadroBuffer* quadro = &currArvore->buffer.quadros[i];
+        if (quadro->RRN != -1 && quadro->sujo == '1') {
+            salvaNoDisco(currArvore, &quadro->no, quadro->RRN);
+            quadro->sujo = '0';
+        }
+    }
+}
+
+/**
+ * Lê um nó especifico de uma arvore, passando pelo buffer
+ * @param currArvore arvore de onde o nó será lido
+ * @param novoNo variável onde o nó lido será salvo
+ * @param RRN RRN do nó a ser lido
+ */
+void lerNoArvore(arvore* currArvore, arvoreNo* novoNo, int RRN) {
+    CONTA(nosLidos, 1);
+    if (RRN < 0) {  // RRN inválido não é guardado no buffer
+        lerNoDisco(currArvore, novoNo, RRN);
+        return;
+    }
+
+    int indice = buscaQuadroBuffer(currArvore, RRN);
+
+    if (indice == -1) {
+        indice = liberaQuadroBuffer(currArvore);
+        lerNoDisco(currArvore, &currArvore->buffer.quadros[indice].no, RRN);
+        currArvore->buffer.quadros[indice].RRN = RRN;
+    }
+
+    currArvore->buffer.quadros[indice].referencia = '1';
+    copiaNoArvore(currArvore, novoNo, &currArvore->buffer.quadros[indice].no);
+}
+
+/**
+ * Salva um nó especifico de uma arvore no buffer, a escrita no disco ocorre
+ * quando o quadro for substituido ou quando a arvore for finalizada
  * @param currArvore arvore de onde o nó será salvo
  * @param novoNo nó que será salvo
  * @param RRN RRN que indica onde o nó será salvo
  */
 void salvaNoArvore(arvore* currArvore, arvoreNo* novoNo, int RRN) {
-    fseek(currArvore->arquivoIndice, (RRN + 1) * 77, 0);
-
-    fwrite(&novoNo->folha, sizeof(char), 1, currArvore->arquivoIndice);
-    fwrite(&novoNo->nroChavesIndexadas, sizeof(int), 1, currArvore->arquivoIndice);
-    fwrite(&novoNo->RRNdoNo, sizeof(int), 1, currArvore->arquivoIndice);
+    CONTA(nosSalvos, 1);
+    int indice = buscaQuadroBuffer(currArvore, RRN);
+    if (indice == -1) indice = liberaQuadroBuffer(currArvore);
 
-    fwrite(&novoNo->registros[0].P_ant, sizeof(int), 1, currArvore->arquivoIndice);
+    quadroBuffer* quadro = &currArvore->buffer.quadros[indice];
+    copiaNoArvore(currArvore, &quadro->no, novoNo);
 
-    for (int i = 0; i < ORDEM_ARVORE - 1; i++) {
-        fwrite(&novoNo->registros[i].C, sizeof(int), 1, currArvore->arquivoIndice);
-        fwrite(&novoNo->registros[i].Pr, sizeof(long int), 1, currArvore->arquivoIndice);
-        fwrite(&novoNo->registros[i].P_prox, sizeof(int), 1, currArvore->arquivoIndice);
+    // no arquivo apenas o primeiro P_ant é salvo, os demais são reconstruidos a partir dos P_prox
+    for (int i = 0; i < currArvore->header.ordem - 2; i++) {
+        quadro->no.registros[i + 1].P_ant = quadro->no.registros[i].P_prox;
     }
+
+    quadro->RRN = RRN;
+    quadro->sujo = '1';
+    quadro->referencia = '1';
 }
 
 /**
@@ -257,7 +654,7 @@ void insereRegistroOrdenado(registro registros[], registro novoRegistro, int tam
     }
 
     registros[i] = novoRegistro;
-    if (i + 1 < ORDEM_ARVORE - 1) registros[i + 1].P_ant = novoRegistro.P_prox;
+    if (i < tamanho) registros[i + 1].P_ant = novoRegistro.P_prox;
 }
 
 /**
@@ -293,26 +690,31 @@ registro buscaBinariaRegistro(registro registros[], int chave, int tamanho) {
  * @return ponteiro para o registro que foi eleito
  */
 registro* splitNo(arvore* currArvore, arvoreNo* currNo, registro novoRegistro) {
+    CONTA(splits, 1);
     registro* registroEleito = (registro*)malloc(sizeof(registro));
+    int ordem = currArvore->header.ordem;
 
     //cria um novo nó a direita
     //no caso no raiz=folha ele deixa de ser raiz e passa a ser folha
     currNo->folha = (currArvore->header.noRaiz == 0) ? '1' : currNo->folha;
-    arvoreNo novoNoEsquerda = criarNovoNo(currNo->folha, currNo->RRNdoNo);
-    arvoreNo novoNoDireita = criarNovoNo(currNo->folha, currArvore->header.RRNproxNo);
+    arvoreNo novoNoEsquerda, novoNoDireita;
+    iniciaNoArvore(currArvore, &novoNoEsquerda);
+    iniciaNoArvore(currArvore, &novoNoDireita);
+    criarNovoNo(currArvore, &novoNoEsquerda, currNo->folha, currNo->RRNdoNo);
+    criarNovoNo(currArvore, &novoNoDireita, currNo->folha, currArvore->header.RRNproxNo);
 
     //copia os antigos e insere o novo registro no array temporário, na ordem correta
-    registro* tempSplitArray = (registro*)malloc(ORDEM_ARVORE * sizeof(registro));
-    for (int i = 0; i < ORDEM_ARVORE - 1; i++) tempSplitArray[i] = currNo->registros[i];
-    insereRegistroOrdenado(tempSplitArray, novoRegistro, ORDEM_ARVORE - 1);
+    registro* tempSplitArray = (registro*)malloc(ordem * sizeof(registro));
+    for (int i = 0; i < ordem - 1; i++) tempSplitArray[i] = currNo->registros[i];
+    insereRegistroOrdenado(tempSplitArray, novoRegistro, ordem - 1);
 
     // distribui os registros,já ordenados, entre os dois nós
-    for (int i = 0; i < ORDEM_ARVORE / 2; i++) {
+    for (int i = 0; i < ordem / 2; i++) {
         novoNoEsquerda.registros[i] = tempSplitArray[i];
         novoNoEsquerda.nroChavesIndexadas++;
     }
 
-    for (int i = ORDEM_ARVORE / 2 + 1, j = 0; i < ORDEM_ARVORE; i++, j++) {
+    for (int i = ordem / 2 + 1, j = 0; i < ordem; i++, j++) {
         novoNoDireita.registros[j] = tempSplitArray[i];
         novoNoDireita.nroChavesIndexadas++;
     }
@@ -321,11 +723,13 @@ registro* splitNo(arvore* currArvore, arvoreNo* currNo, registro novoRegistro) {
     salvaNoArvore(currArvore, &novoNoDireita, novoNoDireita.RRNdoNo);
 
     // elege um registro
-    registroEleito->C = tempSplitArray[ORDEM_ARVORE / 2].C;
-    registroEleito->Pr = tempSplitArray[ORDEM_ARVORE / 2].Pr;
+    registroEleito->C = tempSplitArray[ordem / 2].C;
+    registroEleito->Pr = tempSplitArray[ordem / 2].Pr;
     registroEleito->P_ant = novoNoEsquerda.RRNdoNo;
     registroEleito->P_prox = novoNoDireita.RRNdoNo;
 
+    liberaNoArvore(&novoNoEsquerda);
+    liberaNoArvore(&novoNoDireita);
     free(tempSplitArray);
     currArvore->header.RRNproxNo++;
 
@@ -340,7 +744,7 @@ registro* splitNo(arvore* currArvore, arvoreNo* currNo, registro novoRegistro) {
  * @return ponteiro para o registro que foi eleito ou NULL caso nenhum seja eleito
  */
 registro* insereNovoRegistro(arvore* currArvore, arvoreNo* currNo, registro novoRegistro) {
-    if (currNo->nroChavesIndexadas < ORDEM_ARVORE - 1) {
+    if (currNo->nroChavesIndexadas < currArvore->header.ordem - 1) {
         insereRegistroOrdenado(currNo->registros, novoRegistro, currNo->nroChavesIndexadas);
         currNo->nroChavesIndexadas++;
         salvaNoArvore(currArvore, currNo, currNo->RRNdoNo);
@@ -365,10 +769,12 @@ registro* buscaInsersaoRecursao(arvore* currArvore, arvoreNo* currNo, registro n
     //busca  o próximo nó por onde se deve continuar a busca
     registro registroPai = buscaBinariaRegistro(currNo->registros, novoRegistro.C, currNo->nroChavesIndexadas);
     arvoreNo proxNo;
+    iniciaNoArvore(currArvore, &proxNo);
     int RRNproxReg = registroPai.C > novoRegistro.C ? registroPai.P_ant : registroPai.P_prox;
     lerNoArvore(currArvore, &proxNo, RRNproxReg);
 
     registro* registroEleito = buscaInsersaoRecursao(currArvore, &proxNo, novoRegistro);
+    liberaNoArvore(&proxNo);
 
     //testa se algum registro foi eleito no processo
     if (registroEleito != NULL) {
@@ -376,6 +782,124 @@ registro* buscaInsersaoRecursao(arvore* currArvore, arvoreNo* currNo, registro n
         free(registroEleito);
         return novoRegistroEleito;
     }
+    return NULL;
+}
+
+/**
+ * Insere um registro em uma folha da arvore B+, dividindo a folha caso esteja cheia
+ * na divisão a primeira chave da nova folha é copiada para o nó pai, sem byteOffset
+ * @param currArvore arvore que contem a folha
+ * @param folha folha onde o registro será inserido
+ * @param novoRegistro registro que será inserido
+ * @return ponteiro para o registro que sobe para o pai ou NULL caso a folha não seja dividida
+ */
+registro* insereFolhaMais(arvore* currArvore, arvoreNo* folha, registro novoRegistro) {
+    int ordem = currArvore->header.ordem;
+
+    if (folha->nroChavesIndexadas < ordem - 1) {
+        insereRegistroOrdenado(folha->registros, novoRegistro, folha->nroChavesIndexadas);
+        folha->nroChavesIndexadas++;
+        salvaNoArvore(currArvore, folha, folha->RRNdoNo);
+        return NULL;
+    }
+
+    CONTA(splits, 1);
+
+    registro* tempSplitArray = (registro*)malloc(ordem * sizeof(registro));
+    for (int i = 0; i < ordem - 1; i++) tempSplitArray[i] = folha->registros[i];
+    insereRegistroOrdenado(tempSplitArray, novoRegistro, ordem - 1);
+
+    arvoreNo novaFolhaEsquerda, novaFolhaDireita;
+    iniciaNoArvore(currArvore, &novaFolhaEsquerda);
+    iniciaNoArvore(currArvore, &novaFolhaDireita);
+    criarNovoNo(currArvore, &novaFolhaEsquerda, '1', folha->RRNdoNo);
+    criarNovoNo(currArvore, &novaFolhaDireita, '1', currArvore->header.RRNproxNo);
+    currArvore->header.RRNproxNo++;
+
+    // as duas folhas ficam com metade dos registros cada e continuam encadeadas
+    for (int i = 0; i < ordem / 2; i++) {
+        novaFolhaEsquerda.registros[novaFolhaEsquerda.nroChavesIndexadas++] = tempSplitArray[i];
+    }
+    for (int i = ordem / 2; i < ordem; i++) {
+        novaFolhaDireita.registros[novaFolhaDireita.nroChavesIndexadas++] = tempSplitArray[i];
+    }
+    novaFolhaDireita.proximaFolha = folha->proximaFolha;
+    novaFolhaEsquerda.proximaFolha = novaFolhaDireita.RRNdoNo;
+
+    salvaNoArvore(currArvore, &novaFolhaEsquerda, novaFolhaEsquerda.RRNdoNo);
+    salvaNoArvore(currArvore, &novaFolhaDireita, novaFolhaDireita.RRNdoNo);
+    copiaNoArvore(currArvore, folha, &novaFolhaEsquerda);
+
+    registro* registroEleito = (registro*)malloc(sizeof(registro));
+    registroEleito->C = novaFolhaDireita.registros[0].C;
+    registroEleito->Pr = -1;
+    registroEleito->P_ant = novaFolhaEsquerda.RRNdoNo;
+    registroEleito->P_prox = novaFolhaDireita.RRNdoNo;
+
+    liberaNoArvore(&novaFolhaEsquerda);
+    liberaNoArvore(&novaFolhaDireita);
+    free(tempSplitArray);
+    return registroEleito;
+}
+
+/**
+ * Busca recursivamente a folha da arvore B+ onde o novo registro deve ser inserido
+ * chaves iguais à chave de um nó interno ficam na subárvore da direita
+ * @param currArvore arvore que contem o nó que receberá o novo registro
+ * @param currNo nó atual da busca
+ * @param novoRegistro registro que será inserido
+ * @return ponteiro para o registro que foi eleito ou NULL caso nenhum seja eleito
+ */
+registro* buscaInsercaoMaisRecursao(arvore* currArvore, arvoreNo* currNo, registro novoRegistro) {
+    if (currNo->folha == '1') return insereFolhaMais(currArvore, currNo, novoRegistro);
+
+    int nroChaves = currNo->nroChavesIndexadas;
+    int i = 0;
+    while (i < nroChaves && novoRegistro.C >= currNo->registros[i].C) i++;
+    int RRNproxNo = (i < nroChaves) ? currNo->registros[i].P_ant : currNo->registros[nroChaves - 1].P_prox;
+
+    arvoreNo proxNo;
+    iniciaNoArvore(currArvore, &proxNo);
+    lerNoArvore(currArvore, &proxNo, RRNproxNo);
+
+    registro* registroEleito = buscaInsercaoMaisRecursao(currArvore, &proxNo, novoRegistro);
+    liberaNoArvore(&proxNo);
+
+    // os nós internos da arvore B+ se dividem da mesma forma que os da arvore B
+    if (registroEleito != NULL) {
+        registro* novoRegistroEleito = insereNovoRegistro(currArvore, currNo, *registroEleito);
+        free(registroEleito);
+        return novoRegistroEleito;
+    }
+    return NULL;
+}
+
+/**
+ * Insere um novo registro na arvore B+
+ * @param currArvore arvore que receberá o novo registro
+ * @param novoRegistro registro que será inserido
+ */
+void insereRegistroMais(arvore* currArvore, registro novoRegistro) {
+    novoRegistro.P_ant = -1;
+    novoRegistro.P_prox = -1;
+
+    if (currArvore->header.noRaiz == -1) {  // a primeira raiz é uma folha
+        criarNovoNo(currArvore, &currArvore->raiz, '1', currArvore->header.RRNproxNo);
+        currArvore->header.noRaiz = currArvore->raiz.RRNdoNo;
+        salvaNoArvore(currArvore, &currArvore->raiz, currArvore->header.RRNproxNo);
+        currArvore->header.RRNproxNo++;
+    }
+
+    registro* registroEleitoParaRaiz = buscaInsercaoMaisRecursao(currArvore, &currArvore->raiz, novoRegistro);
+
+    if (registroEleitoParaRaiz != NULL) {
+        criarNovoNo(currArvore, &currArvore->raiz, '0', currArvore->header.RRNproxNo);
+        currArvore->header.noRaiz = currArvore->raiz.RRNdoNo;
+        currArvore->header.RRNproxNo++;
+
+        insereNovoRegistro(currArvore, &currArvore->raiz, *registroEleitoParaRaiz);
+        free(registroEleitoParaRaiz);
+    }
 }
 
 /**
@@ -384,8 +908,13 @@ registro* buscaInsersaoRecursao(arvore* currArvore, arvoreNo* currNo, registro n
  * @param novoRegistro registro que será inserido
  */
 void insereRegistro(arvore* currArvore, registro novoRegistro) {
+    if (currArvore->header.versao == VERSAO_ARVORE_MAIS) {
+        insereRegistroMais(currArvore, novoRegistro);
+        return;
+    }
+
     if (currArvore->header.noRaiz == -1) {  // testa se já existe uma raiz, caso não exista ela será criada
-        currArvore->raiz = criarNovoNo('0', currArvore->header.RRNproxNo);
+        criarNovoNo(currArvore, &currArvore->raiz, '0', currArvore->header.RRNproxNo);
         currArvore->header.noRaiz = currArvore->raiz.RRNdoNo;
         salvaNoArvore(currArvore, &currArvore->raiz, currArvore->header.RRNproxNo);
         currArvore->header.RRNproxNo++;
@@ -395,7 +924,7 @@ void insereRegistro(arvore* currArvore, registro novoRegistro) {
 
     //testa se um registro foi eleito, nesse caso a raiz deve ser atualizada
     if (registroEleitoParaRaiz != NULL) {
-        currArvore->raiz = criarNovoNo('0', currArvore->header.RRNproxNo);  //cria uma nova raiz
+        criarNovoNo(currArvore, &currArvore->raiz, '0', currArvore->header.RRNproxNo);  //cria uma nova raiz
         currArvore->header.noRaiz = currArvore->raiz.RRNdoNo;
         currArvore->header.RRNproxNo++;
 
@@ -423,8 +952,11 @@ long int buscaRegistroRecursao(arvore* currArvore, arvoreNo* currNo, int chaveRe
         return -1;
     } else {  //continua a busca
         arvoreNo proxNo;
+        iniciaNoArvore(currArvore, &proxNo);
         lerNoArvore(currArvore, &proxNo, RRNproxReg);
-        return buscaRegistroRecursao(currArvore, &proxNo, chaveRegistro);
+        long int byteOffset = buscaRegistroRecursao(currArvore, &proxNo, chaveRegistro);
+        liberaNoArvore(&proxNo);
+        return byteOffset;
     }
 }
 
@@ -438,5 +970,431 @@ long int buscaRegistro(arvore* currArvore, int chave) {
     if (currArvore->header.noRaiz == -1) {
         return -1;
     }
+
+    // na arvore B+ o byteOffset só existe nas folhas
+    if (currArvore->header.versao == VERSAO_ARVORE_MAIS) {
+        iteradorArvore iterador;
+        int chaveEncontrada;
+        long int byteOffset;
+
+        posicionaIterador(currArvore, &iterador, chave);
+        int encontrou = proximoIterador(&iterador, &chaveEncontrada, &byteOffset) && chaveEncontrada == chave;
+        finalizaIterador(&iterador);
+        return encontrou ? byteOffset : -1;
+    }
+
     return buscaRegistroRecursao(currArvore, &currArvore->raiz, chave);
-}
\ No newline at end of file
+}
+
+/**
+ * Posiciona um iterador na primeira chave maior ou igual à chave passada, descendo sempre
+ * pelo filho mais à esquerda possivel para não pular chaves repetidas
+ * @param currArvore arvore B+ que será percorrida
+ * @param iterador iterador a ser posicionado
+ * @param chave menor chave desejada
+ */
+void posicionaIterador(arvore* currArvore, iteradorArvore* iterador, int chave) {
+    iterador->arvore = currArvore;
+    iterador->posicao = 0;
+    iniciaNoArvore(currArvore, &iterador->folha);
+
+    if (currArvore->header.noRaiz == -1) {
+        criarNovoNo(currArvore, &iterador->folha, '1', -1);
+        return;
+    }
+
+    copiaNoArvore(currArvore, &iterador->folha, &currArvore->raiz);
+    while (iterador->folha.folha != '1') {
+        arvoreNo* currNo = &iterador->folha;
+        int nroChaves = currNo->nroChavesIndexadas;
+        int i = 0;
+        while (i < nroChaves && chave > currNo->registros[i].C) i++;
+        int RRNproxNo = (i < nroChaves) ? currNo->registros[i].P_ant : currNo->registros[nroChaves - 1].P_prox;
+        lerNoArvore(currArvore, &iterador->folha, RRNproxNo);
+    }
+
+    while (iterador->posicao < iterador->folha.nroChavesIndexadas && iterador->folha.registros[iterador->posicao].C < chave) {
+        iterador->posicao++;
+    }
+}
+
+/**
+ * Devolve o próximo registro do iterador, passando para a próxima folha quando a atual acabar
+ * @param iterador iterador já posicionado
+ * @param chave variável onde a chave será salva
+ * @param byteOffset variável onde o byteOffset será salvo
+ * @return retorna 1 caso exista um próximo registro e 0 caso a arvore tenha acabado
+ */
+int proximoIterador(iteradorArvore* iterador, int* chave, long int* byteOffset) {
+    while (iterador->posicao >= iterador->folha.nroChavesIndexadas) {
+        if (iterador->folha.proximaFolha == -1) return 0;
+        lerNoArvore(iterador->arvore, &iterador->folha, iterador->folha.proximaFolha);
+        iterador->posicao = 0;
+    }
+
+    *chave = iterador->folha.registros[iterador->posicao].C;
+    *byteOffset = iterador->folha.registros[iterador->posicao].Pr;
+    iterador->posicao++;
+    return 1;
+}
+
+/**
+ * Libera a folha mantida pelo iterador
+ * @param iterador iterador posicionado por posicionaIterador
+ */
+void finalizaIterador(iteradorArvore* iterador) {
+    liberaNoArvore(&iterador->folha);
+}
+
+/**
+ * Compara duas chaves de uma busca em lote
+ * @param chaveA primeira chave
+ * @param chaveB segunda chave
+ * @return retorna um valor negativo, zero ou positivo caso A seja menor, igual ou maior que B
+ */
+int compararChavesLote(const void* chaveA, const void* chaveB) {
+    int a = (*(chaveLote*)chaveA).chave;
+    int b = (*(chaveLote*)chaveB).chave;
+    return (a > b) - (a < b);
+}
+
+/**
+ * Resolve recursivamente um intervalo de chaves ordenadas e sem repetição dentro de uma subárvore,
+ * as chaves são divididas entre os filhos do nó e cada filho é lido uma única vez
+ * @param currArvore arvore onde a busca ocorrerá
+ * @param currNo raiz da subárvore
+ * @param chaves chaves ordenadas e sem repetição
+ * @param byteOffsets byteOffset encontrado para cada chave, ou -1 caso não exista
+ * @param inicio primeira chave do intervalo
+ * @param fim posição logo após a última chave do intervalo
+ */
+void buscaLoteRecursao(arvore* currArvore, arvoreNo* currNo, int chaves[], long int byteOffsets[], int inicio, int fim) {
+    int nroChaves = currNo->nroChavesIndexadas;
+    int atual = inicio;
+
+    if (nroChaves <= 0) {
+        for (; atual < fim; atual++) byteOffsets[atual] = -1;
+        return;
+    }
+
+    // nos nós internos da arvore B+ a chave é só uma cópia e a busca continua no filho da direita
+    int guardaByteOffset = currArvore->header.versao != VERSAO_ARVORE_MAIS || currNo->folha == '1';
+
+    // o filho i recebe as chaves menores que a i-ésima chave do nó, e o último filho as maiores que todas
+    for (int i = 0; i <= nroChaves && atual < fim; i++) {
+        int limite = fim;
+        if (i < nroChaves) {
+            limite = atual;
+            while (limite < fim && chaves[limite] < currNo->registros[i].C) limite++;
+        }
+
+        if (limite > atual) {
+            int RRNfilho = (i < nroChaves) ? currNo->registros[i].P_ant : currNo->registros[nroChaves - 1].P_prox;
+
+            if (RRNfilho == -1) {  // não existe o próximo nó, então nenhuma dessas chaves está na arvore
+                for (int k = atual; k < limite; k++) byteOffsets[k] = -1;
+            } else {
+                arvoreNo proxNo;
+                iniciaNoArvore(currArvore, &proxNo);
+                lerNoArvore(currArvore, &proxNo, RRNfilho);
+                buscaLoteRecursao(currArvore, &proxNo, chaves, byteOffsets, atual, limite);
+                liberaNoArvore(&proxNo);
+            }
+            atual = limite;
+        }
+
+        if (guardaByteOffset && i < nroChaves && atual < fim && chaves[atual] == currNo->registros[i].C) {
+            byteOffsets[atual] = currNo->registros[i].Pr;
+            atual++;
+        }
+    }
+}
+
+/**
+ * Busca várias chaves de uma vez, as chaves são ordenadas e as repetidas são buscadas uma única vez,
+ * assim cada nó da arvore é lido no máximo uma vez para todo o lote
+ * @param currArvore arvore onde a busca ocorrerá
+ * @param chaves chaves buscadas, na ordem do chamador (podem se repetir)
+ * @param byteOffsets byteOffset do registro de cada chave, na mesma ordem das chaves, ou -1 caso não encontre
+ * @param quantidade quantidade de chaves
+ */
+void buscaRegistrosEmLote(arvore* currArvore, int chaves[], long int byteOffsets[], int quantidade) {
+    if (quantidade <= 0) return;
+
+    chaveLote* ordenadas = (chaveLote*)malloc(quantidade * sizeof(chaveLote));
+    for (int i = 0; i < quantidade; i++) {
+        ordenadas[i].chave = chaves[i];
+        ordenadas[i].posicao = i;
+    }
+    qsort(ordenadas, quantidade, sizeof(chaveLote), compararChavesLote);
+
+    // remove as chaves repetidas
+    int* unicas = (int*)malloc(quantidade * sizeof(int));
+    long int* resultados = (long int*)malloc(quantidade * sizeof(long int));
+    int nroUnicas = 0;
+
+    for (int i = 0; i < quantidade; i++) {
+        if (i == 0 || ordenadas[i].chave != ordenadas[i - 1].chave) unicas[nroUnicas++] = ordenadas[i].chave;
+    }
+
+    if (currArvore->header.noRaiz == -1) {
+        for (int i = 0; i < nroUnicas; i++) resultados[i] = -1;
+    } else {
+        buscaLoteRecursao(currArvore, &currArvore->raiz, unicas, resultados, 0, nroUnicas);
+    }
+
+    // devolve os resultados na ordem original
+    for (int i = 0, u = -1; i < quantidade; i++) {
+        if (i == 0 || ordenadas[i].chave != ordenadas[i - 1].chave) u++;
+        byteOffsets[ordenadas[i].posicao] = resultados[u];
+    }
+
+    free(ordenadas);
+    free(unicas);
+    free(resultados);
+}
+
+/**
+ * Compara dois registros pela chave
+ * @param registroA primeiro registro
+ * @param registroB segundo registro
+ * @return retorna um valor negativo, zero ou positivo caso a chave de A seja menor, igual ou maior que a de B
+ */
+int compararRegistros(const void* registroA, const void* registroB) {
+    int a = (*(registro*)registroA).C;
+    int b = (*(registro*)registroB).C;
+    return (a > b) - (a < b);
+}
+
+/**
+ * Calcula quantos nós um nível da árvore construida em lote terá
+ * @param nroItens quantidade de registros disponiveis para o nível
+ * @param chavesPorNo quantidade desejada de chaves em cada nó
+ * @param maximoChaves quantidade máxima de chaves de um nó
+ * @return quantidade de nós do nível
+ */
+int calculaNosDoNivel(int nroItens, int chavesPorNo, int maximoChaves) {
+    if (nroItens <= maximoChaves) return 1;  // cabe inteiro em um único nó
+
+    // cada nó recebe chavesPorNo registros e um registro é promovido entre dois nós vizinhos
+    int nroNos = (nroItens + 1 + chavesPorNo) / (chavesPorNo + 1);
+
+    // garante que nenhum nó fique vazio
+    if (nroNos > (nroItens + 1) / 2) nroNos = (nroItens + 1) / 2;
+
+    return nroNos;
+}
+
+/**
+ * Constroi uma arvore B+ de baixo para cima a partir de registros já ordenados,
+ * as folhas recebem todos os registros e são encadeadas em RRNs consecutivos,
+ * cada nó interno recebe a menor chave de cada filho, exceto do primeiro
+ * @param currArvore arvore B+ vazia que receberá os registros
+ * @param registros array ordenado com os registros
+ * @param quantidade quantidade de registros do array
+ * @param chavesPorNo quantidade desejada de chaves em cada nó
+ */
+void constroiArvoreMaisEmLote(arvore* currArvore, registro registros[], int quantidade, int chavesPorNo) {
+    int nroNos = (quantidade + chavesPorNo - 1) / chavesPorNo;
+    int chavesBase = quantidade / nroNos;
+    int chavesExtras = quantidade % nroNos;
+
+    int* filhos = (int*)malloc(nroNos * sizeof(int));
+    int* menoresChaves = (int*)malloc(nroNos * sizeof(int));
+    int posItem = 0;
+
+    arvoreNo novoNo;
+    iniciaNoArvore(currArvore, &novoNo);
+
+    // folhas
+    for (int n = 0; n < nroNos; n++) {
+        criarNovoNo(currArvore, &novoNo, '1', currArvore->header.RRNproxNo);
+        currArvore->header.RRNproxNo++;
+
+        novoNo.nroChavesIndexadas = chavesBase + (n < chavesExtras ? 1 : 0);
+        for (int c = 0; c < novoNo.nroChavesIndexadas; c++) {
+            novoNo.registros[c].C = registros[posItem].C;
+            novoNo.registros[c].Pr = registros[posItem].Pr;
+            posItem++;
+        }
+        novoNo.proximaFolha = (n < nroNos - 1) ? novoNo.RRNdoNo + 1 : -1;
+
+        salvaNoArvore(currArvore, &novoNo, novoNo.RRNdoNo);
+        filhos[n] = novoNo.RRNdoNo;
+        menoresChaves[n] = novoNo.registros[0].C;
+
+        if (nroNos == 1) copiaNoArvore(currArvore, &currArvore->raiz, &novoNo);
+    }
+
+    // niveis internos, até sobrar um único nó
+    while (nroNos > 1) {
+        int nroPais = (nroNos + chavesPorNo) / (chavesPorNo + 1);
+        if (nroPais > nroNos / 2) nroPais = nroNos / 2;  // todo nó interno tem ao menos dois filhos
+
+        int filhosBase = nroNos / nroPais;
+        int filhosExtras = nroNos % nroPais;
+
+        int* novosFilhos = (int*)malloc(nroPais * sizeof(int));
+        int* novasMenoresChaves = (int*)malloc(nroPais * sizeof(int));
+        int posFilho = 0;
+
+        for (int n = 0; n < nroPais; n++) {
+            criarNovoNo(currArvore, &novoNo, '0', currArvore->header.RRNproxNo);
+            currArvore->header.RRNproxNo++;
+
+            int nroFilhos = filhosBase + (n < filhosExtras ? 1 : 0);
+            novoNo.nroChavesIndexadas = nroFilhos - 1;
+            novasMenoresChaves[n] = menoresChaves[posFilho];
+
+            for (int c = 0; c < nroFilhos - 1; c++) {
+                novoNo.registros[c].C = menoresChaves[posFilho + c + 1];
+                novoNo.registros[c].Pr = -1;
+                novoNo.registros[c].P_ant = filhos[posFilho + c];
+                novoNo.registros[c].P_prox = filhos[posFilho + c + 1];
+            }
+            posFilho += nroFilhos;
+
+            salvaNoArvore(currArvore, &novoNo, novoNo.RRNdoNo);
+            novosFilhos[n] = novoNo.RRNdoNo;
+
+            if (nroPais == 1) copiaNoArvore(currArvore, &currArvore->raiz, &novoNo);
+        }
+
+        free(filhos);
+        free(menoresChaves);
+        filhos = novosFilhos;
+        menoresChaves = novasMenoresChaves;
+        nroNos = nroPais;
+    }
+
+    currArvore->header.noRaiz = filhos[0];
+    liberaNoArvore(&novoNo);
+    free(filhos);
+    free(menoresChaves);
+}
+
+/**
+ * Constroi a árvore de baixo para cima a partir de todos os registros de uma vez,
+ * os registros são ordenados e os nós são escritos nivel a nivel, começando pelas folhas,
+ * sempre em RRNs crescentes
+ * @param currArvore arvore vazia que receberá os registros
+ * @param registros array com os registros (chave e byteOffset), será ordenado
+ * @param quantidade quantidade de registros do array
+ * @param fatorPreenchimento fração (0,1] de cada nó que será ocupada, deixando espaço para inserções futuras
+ */
+void constroiArvoreEmLote(arvore* currArvore, registro registros[], int quantidade, double fatorPreenchimento) {
+    if (quantidade <= 0) return;
+
+    qsort(registros, quantidade, sizeof(registro), compararRegistros);
+
+    int maximoChaves = currArvore->header.ordem - 1;
+    int chavesPorNo = (int)(fatorPreenchimento * maximoChaves + 0.5);
+    if (chavesPorNo < 1) chavesPorNo = 1;
+    if (chavesPorNo > maximoChaves) chavesPorNo = maximoChaves;
+
+    if (currArvore->header.versao == VERSAO_ARVORE_MAIS) {
+        constroiArvoreMaisEmLote(currArvore, registros, quantidade, chavesPorNo);
+        return;
+    }
+
+    registro* itens = registros;  // registros que serão distribuidos no nível atual
+    int nroItens = quantidade;
+    int* filhos = NULL;  // RRNs dos nós do nível de baixo, NULL no nível das folhas
+    char folha = '1';
+
+    arvoreNo novoNo;
+    iniciaNoArvore(currArvore, &novoNo);
+
+    while (1) {
+        int nroNos = calculaNosDoNivel(nroItens, chavesPorNo, maximoChaves);
+        int chavesBase = (nroItens - (nroNos - 1)) / nroNos;
+        int chavesExtras = (nroItens - (nroNos - 1)) % nroNos;
+
+        registro* promovidos = (registro*)malloc(nroNos * sizeof(registro));
+        int* novosFilhos = (int*)malloc(nroNos * sizeof(int));
+        int posItem = 0;
+        int posFilho = 0;
+
+        // a raiz única segue a mesma convenção da inserção, onde a raiz que também é folha é marcada com '0'
+        if (nroNos == 1 && filhos == NULL) folha = '0';
+
+        for (int n = 0; n < nroNos; n++) {
+            criarNovoNo(currArvore, &novoNo, folha, currArvore->header.RRNproxNo);
+            currArvore->header.RRNproxNo++;
+
+            novoNo.nroChavesIndexadas = chavesBase + (n < chavesExtras ? 1 : 0);
+
+            for (int c = 0; c < novoNo.nroChavesIndexadas; c++) {
+                novoNo.registros[c].C = itens[posItem].C;
+                novoNo.registros[c].Pr = itens[posItem].Pr;
+                posItem++;
+
+                if (filhos != NULL) {
+                    novoNo.registros[c].P_ant = filhos[posFilho++];
+                    if (c > 0) novoNo.registros[c - 1].P_prox = novoNo.registros[c].P_ant;
+                }
+            }
+            if (filhos != NULL) novoNo.registros[novoNo.nroChavesIndexadas - 1].P_prox = filhos[posFilho++];
+
+            salvaNoArvore(currArvore, &novoNo, novoNo.RRNdoNo);
+            novosFilhos[n] = novoNo.RRNdoNo;
+
+            // o registro seguinte separa este nó do próximo e sobe para o nível de cima
+            if (n < nroNos - 1) promovidos[n] = itens[posItem++];
+
+            if (nroNos == 1) copiaNoArvore(currArvore, &currArvore->raiz, &novoNo);
+        }
+
+        if (itens != registros) free(itens);
+        free(filhos);
+
+        if (nroNos == 1) {
+            currArvore->header.noRaiz = novosFilhos[0];
+            liberaNoArvore(&novoNo);
+            free(novosFilhos);
+            free(promovidos);
+            return;
+        }
+
+        itens = promovidos;
+        nroItens = nroNos - 1;
+        filhos = novosFilhos;
+        folha = '0';
+    }
+}
+
+/**
+ * Troca os byteOffsets de todos os registros da arvore depois que o arquivo de dados foi reescrito,
+ * percorrendo cada nó do arquivo uma única vez
+ * @param currArvore arvore que terá os byteOffsets trocados
+ * @param antigos byteOffsets antigos em ordem crescente
+ * @param novos novo byteOffset de cada byteOffset antigo
+ * @param quantidade quantidade de byteOffsets da tabela
+ */
+void remapeiaByteOffsets(arvore* currArvore, long int antigos[], long int novos[], int quantidade) {
+    arvoreNo currNo;
+    iniciaNoArvore(currArvore, &currNo);
+
+    for (int RRN = 0; RRN < currArvore->header.RRNproxNo; RRN++) {
+        lerNoArvore(currArvore, &currNo, RRN);
+
+        for (int i = 0; i < currNo.nroChavesIndexadas; i++) {
+            if (currNo.registros[i].Pr == -1) continue;  // chaves dos nós internos da arvore B+
+
+            int inicio = 0, fim = quantidade;
+            while (inicio < fim) {
+                int meio = (inicio + fim) / 2;
+                if (antigos[meio] < currNo.registros[i].Pr)
+                    inicio = meio + 1;
+                else
+                    fim = meio;
+            }
+            if (inicio < quantidade && antigos[inicio] == currNo.registros[i].Pr) currNo.registros[i].Pr = novos[inicio];
+        }
+
+        salvaNoArvore(currArvore, &currNo, RRN);
+    }
+    liberaNoArvore(&currNo);
+
+    if (currArvore->header.noRaiz != -1) lerNoArvore(currArvore, &currArvore->raiz, currArvore->header.noRaiz);
+}
@@ -4,14 +4,31 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-#define ORDEM_ARVORE 5  // ordem da arvore b
+#define ORDEM_ARVORE 5                // ordem da arvore b no formato original (versão 1)
+#define TAMANHO_NO_ARVORE 77          // tamanho do header e de cada nó no formato original
+#define TAMANHO_PAGINA_ARVORE 4096    // tamanho de cada nó no formato paginado (versão 2)
+#define ORDEM_PAGINADA ((TAMANHO_PAGINA_ARVORE - 13) / 16 + 1)  // maior ordem cujo nó cabe em uma página
+#define ORDEM_MAXIMA ORDEM_PAGINADA
+#define VERSAO_ARVORE_MAIS 3          // versão do formato paginado em que a arvore é uma arvore B+
+#define TAMANHO_BUFFER_ARVORE 64      // quantidade de nós mantidos em memória pelo buffer
+#define TAMANHO_LOTE_BUSCA 4096       // quantidade de chaves que as junções resolvem em cada busca em lote
+#define TAMANHO_SESSAO_ARVORES 16     // quantidade de arvores mantidas abertas entre comandos de uma sessão
 
+/**
+ * No formato original o lixo é todo preenchido com '@', a partir da versão 2 o primeiro byte
+ * do lixo guarda a versão e os 8 bytes seguintes a ordem e o tamanho dos nós
+ * na versão 3 (arvore B+) os byteOffsets ficam apenas nas folhas e os nós internos guardam
+ * cópias das chaves, com Pr = -1
+ */
 typedef struct arvoreHeader {
     char status;
     int noRaiz;
     int RRNproxNo;
     char lixo[69];  //levando em consideração o /0
 
+    int versao;
+    int ordem;
+    int tamanhoNo;  // nó de RRN n começa no byte (n + 1) * tamanhoNo
 } arvoreHeader;
 
 typedef struct registro {
@@ -21,6 +38,14 @@ typedef struct registro {
     int P_prox;  // P[n+1]
 } registro;
 
+/**
+ * Chave de uma busca em lote junto da sua posição no array original do chamador
+ */
+typedef struct chaveLote {
+    int chave;
+    int posicao;
+} chaveLote;
+
 /**
  * Para facilitar a implementação os registros foram separados em structs próprias, sendo assim
  * P_ant e P_prox são equivalentes aos P's originais
@@ -32,30 +57,87 @@ typedef struct registro {
  * P5 = registros[3].P_prox
  */
 
+/**
+ * Na arvore B+ as folhas são encadeadas, no arquivo o RRN da próxima folha é guardado
+ * no último P da folha (P[ordem]), que nunca é usado por uma folha
+ *
+ * os registros têm ordem - 1 posições, alocadas por iniciaNoArvore de acordo com a arvore dona do nó,
+ * então um nó não deve ser copiado por atribuição e sim por copiaNoArvore
+ */
 typedef struct arvoreNo {
     char folha;
     int nroChavesIndexadas;
     int RRNdoNo;
-    registro registros[ORDEM_ARVORE - 1];
+    registro* registros;
+    int proximaFolha;  // apenas na arvore B+, -1 nos demais casos
 } arvoreNo;
 
+/**
+ * Cada quadro do buffer guarda uma cópia de um nó do arquivo de indices
+ * RRN = -1 indica um quadro livre
+ * sujo = '1' indica que o nó foi alterado e ainda não foi escrito no disco
+ * referencia é o bit usado pelo algoritmo do relógio na escolha de qual quadro substituir
+ */
+typedef struct quadroBuffer {
+    arvoreNo no;
+    int RRN;
+    char sujo;
+    char referencia;
+} quadroBuffer;
+
+typedef struct bufferArvore {
+    quadroBuffer quadros[TAMANHO_BUFFER_ARVORE];
+    registro* registros;  // registros de todos os quadros em um único bloco
+    int ponteiroRelogio;
+} bufferArvore;
+
 typedef struct arvore {
     FILE* arquivoIndice;
     arvoreHeader header;
     arvoreNo raiz;
+    bufferArvore buffer;
 } arvore;
 
+/**
+ * Percorre as folhas de uma arvore B+ em ordem crescente de chave
+ * posicao é o próximo registro da folha atual a ser devolvido
+ * a folha é alocada por posicionaIterador e liberada por finalizaIterador
+ */
+typedef struct iteradorArvore {
+    arvore* arvore;
+    arvoreNo folha;
+    int posicao;
+} iteradorArvore;
+
 arvore* criaArvore(char* nomeArquivoIndice);
+arvore* criaArvorePaginada(char* nomeArquivoIndice);
+arvore* criaArvoreMais(char* nomeArquivoIndice);
 arvore* carregaArvore(char* nomeArquivoIndice);
+void iniciaSessaoArvores();
+void encerraSessaoArvores();
 
 void alteraStatusArvore(arvore* currArvore);
 void lerHeaderArvore(FILE* arquivoIndice, arvoreHeader* header);
 void salvaHeaderArvore(arvore* currArvore);
 void imprimeArvore(arvore* currArvore);
 
+void iniciaBufferArvore(arvore* currArvore);
+void iniciaNoArvore(arvore* currArvore, arvoreNo* no);
+void copiaNoArvore(arvore* currArvore, arvoreNo* destino, arvoreNo* origem);
+void liberaNoArvore(arvoreNo* no);
+void criarNovoNo(arvore* currArvore, arvoreNo* noCriado, char isFolha, int RRndoNo);
+
 void lerNoArvore(arvore* currArvore, arvoreNo* novoNo, int RRN);
+void salvaNoArvore(arvore* currArvore, arvoreNo* novoNo, int RRN);
+void descarregaBufferArvore(arvore* currArvore);
 void insereRegistro(arvore* currArvore, registro novoRegistro);
+void constroiArvoreEmLote(arvore* currArvore, registro registros[], int quantidade, double fatorPreenchimento);
 long int buscaRegistro(arvore* currArvore, int chave);
+void buscaRegistrosEmLote(arvore* currArvore, int chaves[], long int byteOffsets[], int quantidade);
+void posicionaIterador(arvore* currArvore, iteradorArvore* iterador, int chave);
+int proximoIterador(iteradorArvore* iterador, int* chave, long int* byteOffset);
+void finalizaIterador(iteradorArvore* iterador);
+void remapeiaByteOffsets(arvore* currArvore, long int antigos[], long int novos[], int quantidade);
 void leRegistro(FILE* arquivoIndice, arvoreNo* registro);
 void finalizaArvore(arvore* currArvore);
 
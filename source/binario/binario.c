@@ -1,6 +1,9 @@
 #include "binario.h"
 
 #include <stdio.h>
+#include <string.h>
+
+#include "../estatisticas/estatisticas.h"
 
 /**
  * Lê uma string de um arquivo binário
@@ -25,3 +28,157 @@ int lerInteiroBin(FILE* arquivo) {
     fread(&inteiroLido, sizeof(int), 1, arquivo);
     return inteiroLido;
 }
+
+/**
+ * Inicia um buffer de escrita vazio
+ * @param buffer buffer a ser iniciado
+ * @param arquivo arquivo onde os dados serão gravados
+ * @param posicaoArquivo byteOffset onde a próxima gravação será feita
+ */
+void iniciaBufferEscrita(bufferEscrita* buffer, FILE* arquivo, long int posicaoArquivo) {
+    buffer->arquivo = arquivo;
+    buffer->tamanho = 0;
+    buffer->posicaoArquivo = posicaoArquivo;
+    buffer->formato = FORMATO_FLUXO;
+    buffer->tamanhoHeader = 0;
+}
+
+/**
+ * Inicia um buffer de escrita para os registros de um arquivo de dados no formato indicado
+ * no formato em blocos o bloco onde byteProxReg está é carregado, ou um bloco vazio é criado logo
+ * após o header caso o arquivo ainda não tenha nenhum
+ * @param buffer buffer a ser iniciado
+ * @param arquivo arquivo onde os dados serão gravados
+ * @param formato FORMATO_FLUXO ou FORMATO_BLOCOS
+ * @param tamanhoHeader tamanho do header do arquivo
+ * @param byteProxReg byteOffset onde o próximo registro será gravado
+ */
+void iniciaBufferEscritaFormato(bufferEscrita* buffer, FILE* arquivo, int formato, int tamanhoHeader, long int byteProxReg) {
+    iniciaBufferEscrita(buffer, arquivo, byteProxReg);
+    if (formato != FORMATO_BLOCOS) return;
+
+    buffer->formato = FORMATO_BLOCOS;
+    buffer->tamanhoHeader = tamanhoHeader;
+
+    if (byteProxReg <= tamanhoHeader) {
+        buffer->posicaoArquivo = tamanhoHeader;
+        iniciaBlocoVazio(buffer->dados);
+        return;
+    }
+
+    buffer->posicaoArquivo = inicioDoBloco(byteProxReg, tamanhoHeader);
+    fseek(arquivo, buffer->posicaoArquivo, SEEK_SET);
+    if (fread(buffer->dados, sizeof(char), TAMANHO_BLOCO_DADOS, arquivo) < TAMANHO_BLOCO_DADOS) iniciaBlocoVazio(buffer->dados);
+}
+
+/**
+ * @param buffer buffer de escrita
+ * @return byteOffset onde o próximo registro confirmado ficará, também válido logo após a reserva
+ */
+long int posicaoLivreBufferEscrita(bufferEscrita* buffer) {
+    if (buffer->formato == FORMATO_BLOCOS) return buffer->posicaoArquivo + fimRegistrosBloco(buffer->dados);
+    return buffer->posicaoArquivo + buffer->tamanho;
+}
+
+/**
+ * Reserva espaço no final do buffer para um registro, gravando o buffer no arquivo caso não haja espaço
+ * @param buffer buffer de escrita
+ * @param tamanhoMaximo maior quantidade de bytes que o registro pode ocupar
+ * @return retorna a região onde o registro deve ser codificado
+ */
+char* reservaBufferEscrita(bufferEscrita* buffer, int tamanhoMaximo) {
+    if (buffer->formato == FORMATO_BLOCOS) {
+        // o registro não atravessa o fim do bloco, ele vai para o inicio do próximo
+        if (!cabeNoBloco(buffer->dados, tamanhoMaximo)) {
+            descarregaBufferEscrita(buffer);
+            buffer->posicaoArquivo += TAMANHO_BLOCO_DADOS;
+            iniciaBlocoVazio(buffer->dados);
+        }
+        return buffer->dados + fimRegistrosBloco(buffer->dados);
+    }
+
+    if (buffer->tamanho + tamanhoMaximo > TAMANHO_BUFFER_ESCRITA) descarregaBufferEscrita(buffer);
+    return buffer->dados + buffer->tamanho;
+}
+
+/**
+ * Confirma os bytes codificados na região reservada
+ * @param buffer buffer de escrita
+ * @param tamanho quantidade de bytes realmente usados
+ */
+void confirmaBufferEscrita(bufferEscrita* buffer, int tamanho) {
+    if (buffer->formato == FORMATO_BLOCOS) {
+        registraNoBloco(buffer->dados, tamanho);
+        return;
+    }
+    buffer->tamanho += tamanho;
+}
+
+/**
+ * Grava todo o conteúdo do buffer no arquivo com uma única escrita
+ * no formato em blocos o bloco inteiro é gravado e continua no buffer, recebendo os próximos registros
+ * @param buffer buffer de escrita
+ */
+void descarregaBufferEscrita(bufferEscrita* buffer) {
+    if (buffer->formato == FORMATO_BLOCOS) {
+        fseek(buffer->arquivo, buffer->posicaoArquivo, SEEK_SET);
+        fwrite(buffer->dados, sizeof(char), TAMANHO_BLOCO_DADOS, buffer->arquivo);
+        return;
+    }
+
+    if (buffer->tamanho == 0) return;
+
+    if (ftell(buffer->arquivo) != buffer->posicaoArquivo) fseek(buffer->arquivo, buffer->posicaoArquivo, SEEK_SET);
+    fwrite(buffer->dados, sizeof(char), buffer->tamanho, buffer->arquivo);
+
+    buffer->posicaoArquivo += buffer->tamanho;
+    buffer->tamanho = 0;
+}
+
+/**
+ * Sobrescreve bytes em uma posição anterior do arquivo, caso a posição ainda esteja
+ * no buffer a escrita é feita na memória para não ser desfeita quando o buffer for descarregado
+ * @param buffer buffer de escrita do arquivo
+ * @param posicao posição do arquivo onde os dados serão escritos
+ * @param dados bytes a serem escritos
+ * @param tamanho quantidade de bytes
+ */
+void escreveBufferEscritaEm(bufferEscrita* buffer, long int posicao, char* dados, int tamanho) {
+    if (posicao >= buffer->posicaoArquivo) {  // em blocos, a posição está no bloco guardado no buffer
+        memcpy(buffer->dados + (posicao - buffer->posicaoArquivo), dados, tamanho);
+        return;
+    }
+
+    fseek(buffer->arquivo, posicao, SEEK_SET);
+    fwrite(dados, sizeof(char), tamanho, buffer->arquivo);
+}
+
+/**
+ * Acrescenta uma sequência de registros já codificados, como os convertidos pela carga do CSV
+ * no formato em fluxo a sequência é gravada de uma vez, no formato em blocos ela é separada em registros pelo
+ * tamanhoRegistro (que não conta os 5 bytes de removido e tamanhoRegistro) para que nenhum atravesse um bloco
+ * @param buffer buffer de escrita
+ * @param registros inicio do primeiro registro
+ * @param tamanho quantidade de bytes da sequência
+ */
+void acrescentaRegistrosBufferEscrita(bufferEscrita* buffer, char* registros, long int tamanho) {
+    if (buffer->formato != FORMATO_BLOCOS) {
+        descarregaBufferEscrita(buffer);
+        if (ftell(buffer->arquivo) != buffer->posicaoArquivo) fseek(buffer->arquivo, buffer->posicaoArquivo, SEEK_SET);
+        fwrite(registros, sizeof(char), tamanho, buffer->arquivo);
+        buffer->posicaoArquivo += tamanho;
+        return;
+    }
+
+    long int posicao = 0;
+    while (posicao < tamanho) {
+        int tamanhoRegistro;
+        memcpy(&tamanhoRegistro, registros + posicao + 1, sizeof(int));
+
+        char* destino = reservaBufferEscrita(buffer, 5 + tamanhoRegistro);
+        memcpy(destino, registros + posicao, 5 + tamanhoRegistro);
+        confirmaBufferEscrita(buffer, 5 + tamanhoRegistro);
+
+        posicao += 5 + tamanhoRegistro;
+    }
+}
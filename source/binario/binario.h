@@ -2,7 +2,38 @@
 #define _BIN_H_
 #include <stdio.h>
 
+#include "../bloco/bloco.h"
+
+#define TAMANHO_BUFFER_ESCRITA 65536  // bytes acumulados antes de uma escrita no arquivo
+
+#if TAMANHO_BLOCO_DADOS > TAMANHO_BUFFER_ESCRITA
+#error "o buffer de escrita precisa comportar um bloco de dados inteiro"
+#endif
+
+/**
+ * Buffer que junta vários registros já codificados para gravá-los com uma única escrita
+ * posicaoArquivo é o byteOffset onde o primeiro byte do buffer será gravado
+ * em um arquivo no formato em blocos o buffer guarda o bloco inteiro que começa em posicaoArquivo,
+ * tamanhoHeader é usado apenas nesse formato
+ */
+typedef struct bufferEscrita {
+    FILE* arquivo;
+    char dados[TAMANHO_BUFFER_ESCRITA];
+    int tamanho;
+    long int posicaoArquivo;
+    int formato;
+    int tamanhoHeader;
+} bufferEscrita;
+
 int lerInteiroBin(FILE* arquivo);
 int lerStringBin(FILE* arquivo, char* string, int tamanho);
+void iniciaBufferEscrita(bufferEscrita* buffer, FILE* arquivo, long int posicaoArquivo);
+void iniciaBufferEscritaFormato(bufferEscrita* buffer, FILE* arquivo, int formato, int tamanhoHeader, long int byteProxReg);
+long int posicaoLivreBufferEscrita(bufferEscrita* buffer);
+char* reservaBufferEscrita(bufferEscrita* buffer, int tamanhoMaximo);
+void confirmaBufferEscrita(bufferEscrita* buffer, int tamanho);
+void descarregaBufferEscrita(bufferEscrita* buffer);
+void escreveBufferEscritaEm(bufferEscrita* buffer, long int posicao, char* dados, int tamanho);
+void acrescentaRegistrosBufferEscrita(bufferEscrita* buffer, char* registros, long int tamanho);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,150 @@
+#include "bloco.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../estatisticas/estatisticas.h"
+
+/**
+ * Descobre o formato de um arquivo de dados pelo primeiro byte depois do header e posiciona
+ * o arquivo no primeiro registro
+ * @param arquivo arquivo de dados
+ * @param tamanhoHeader tamanho do header do arquivo
+ * @return FORMATO_BLOCOS ou FORMATO_FLUXO
+ */
+int formatoArquivoDados(FILE* arquivo, int tamanhoHeader) {
+    char marca;
+    fseek(arquivo, tamanhoHeader, SEEK_SET);
+    int formato = (fread(&marca, sizeof(char), 1, arquivo) == 1 && marca == MARCA_BLOCO) ? FORMATO_BLOCOS : FORMATO_FLUXO;
+
+    fseek(arquivo, tamanhoHeader, SEEK_SET);
+    pulaEspacoLivre(arquivo, tamanhoHeader);
+    return formato;
+}
+
+/**
+ * @param posicao byteOffset dentro de um bloco
+ * @param tamanhoHeader tamanho do header do arquivo
+ * @return byteOffset do inicio do bloco que contém a posição
+ */
+long int inicioDoBloco(long int posicao, int tamanhoHeader) {
+    return tamanhoHeader + (posicao - tamanhoHeader) / TAMANHO_BLOCO_DADOS * TAMANHO_BLOCO_DADOS;
+}
+
+/**
+ * Avança a leitura sequencial sobre cabeçalhos e espaços livres de blocos até o próximo registro,
+ * em um arquivo em fluxo a posição não muda
+ * @param arquivo arquivo posicionado no inicio de um registro, de um bloco ou de um espaço livre
+ * @param tamanhoHeader tamanho do header do arquivo
+ * @return retorna 1 caso seja o final do arquivo e 0 caso contrário
+ */
+int pulaEspacoLivre(FILE* arquivo, int tamanhoHeader) {
+    char marca;
+
+    while (fread(&marca, sizeof(char), 1, arquivo) == 1) {
+        if (marca == MARCA_BLOCO) {
+            fseek(arquivo, TAMANHO_CABECALHO_BLOCO - 1, SEEK_CUR);
+        } else if (marca == MARCA_FIM_BLOCO) {
+            fseek(arquivo, inicioDoBloco(ftell(arquivo) - 1, tamanhoHeader) + TAMANHO_BLOCO_DADOS, SEEK_SET);
+        } else {
+            fseek(arquivo, -1, SEEK_CUR);  //volta 1 byte, é o inicio de um registro
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Equivalente ao pulaEspacoLivre para um arquivo mapeado
+ * @param mapa mapeamento posicionado no inicio de um registro, de um bloco ou de um espaço livre
+ * @param tamanhoHeader tamanho do header do arquivo
+ * @return retorna 1 caso seja o final do arquivo e 0 caso contrário
+ */
+int pulaEspacoLivreMapa(arquivoMapeado* mapa, int tamanhoHeader) {
+    while (!fimDoMapa(mapa)) {
+        char marca = mapa->dados[mapa->posicao];
+
+        if (marca == MARCA_BLOCO)
+            mapa->posicao += TAMANHO_CABECALHO_BLOCO;
+        else if (marca == MARCA_FIM_BLOCO)
+            mapa->posicao = inicioDoBloco(mapa->posicao, tamanhoHeader) + TAMANHO_BLOCO_DADOS;
+        else
+            return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Prepara um bloco sem registros, com todo o espaço marcado como livre
+ * @param bloco região de TAMANHO_BLOCO_DADOS bytes
+ */
+void iniciaBlocoVazio(char* bloco) {
+    int nroRegistros = 0;
+    int fimRegistros = TAMANHO_CABECALHO_BLOCO;
+
+    memset(bloco, MARCA_FIM_BLOCO, TAMANHO_BLOCO_DADOS);
+    bloco[0] = MARCA_BLOCO;
+    memcpy(bloco + 1, &nroRegistros, sizeof(int));
+    memcpy(bloco + 5, &fimRegistros, sizeof(int));
+}
+
+/**
+ * @param bloco bloco em memória
+ * @return quantidade de registros do bloco, removidos inclusive
+ */
+int nroRegistrosBloco(char* bloco) {
+    int nroRegistros;
+    memcpy(&nroRegistros, bloco + 1, sizeof(int));
+    return nroRegistros;
+}
+
+/**
+ * @param bloco bloco em memória
+ * @return posição, relativa ao inicio do bloco, onde o próximo registro será gravado
+ */
+int fimRegistrosBloco(char* bloco) {
+    int fimRegistros;
+    memcpy(&fimRegistros, bloco + 5, sizeof(int));
+    return fimRegistros;
+}
+
+/**
+ * Consulta o diretório do bloco
+ * @param bloco bloco em memória
+ * @param indice ordem do registro no bloco, começando em 0
+ * @return posição do registro relativa ao inicio do bloco
+ */
+int posicaoRegistroBloco(char* bloco, int indice) {
+    int posicao;
+    memcpy(&posicao, bloco + TAMANHO_BLOCO_DADOS - (indice + 1) * sizeof(int), sizeof(int));
+    return posicao;
+}
+
+/**
+ * @param bloco bloco em memória
+ * @param tamanho quantidade de bytes do registro
+ * @return retorna 1 caso o registro e sua entrada no diretório caibam no bloco, mantendo um byte livre
+ */
+int cabeNoBloco(char* bloco, int tamanho) {
+    long int diretorio = (long int)(nroRegistrosBloco(bloco) + 1) * sizeof(int);
+    return fimRegistrosBloco(bloco) + tamanho + 1 + diretorio <= TAMANHO_BLOCO_DADOS;
+}
+
+/**
+ * Registra no cabeçalho e no diretório um registro que acabou de ser gravado em fimRegistrosBloco
+ * @param bloco bloco em memória
+ * @param tamanho quantidade de bytes do registro
+ */
+void registraNoBloco(char* bloco, int tamanho) {
+    int nroRegistros = nroRegistrosBloco(bloco);
+    int fimRegistros = fimRegistrosBloco(bloco);
+
+    memcpy(bloco + TAMANHO_BLOCO_DADOS - (nroRegistros + 1) * sizeof(int), &fimRegistros, sizeof(int));
+    nroRegistros++;
+    fimRegistros += tamanho;
+
+    memcpy(bloco + 1, &nroRegistros, sizeof(int));
+    memcpy(bloco + 5, &fimRegistros, sizeof(int));
+}
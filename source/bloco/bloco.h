@@ -0,0 +1,40 @@
+#ifndef _BLOCO_H_
+#define _BLOCO_H_
+#include <stdio.h>
+
+#include "../mapeamento/mapeamento.h"
+
+#define FORMATO_FLUXO 1   // registros gravados um após o outro logo depois do header (formato original)
+#define FORMATO_BLOCOS 2  // registros agrupados em blocos de tamanho fixo, cada um com seu diretório
+
+#define TAMANHO_BLOCO_DADOS 65536
+#define TAMANHO_CABECALHO_BLOCO 9  // marca, nroRegistros e fimRegistros
+#define MARCA_BLOCO 'B'            // primeiro byte de todo bloco
+#define MARCA_FIM_BLOCO '#'        // bytes livres do bloco, nunca confundidos com o campo removido ('0' ou '1')
+
+/**
+ * Bloco de um arquivo de dados no formato em blocos, o bloco i começa em tamanhoHeader + i * TAMANHO_BLOCO_DADOS
+ *
+ * [marca][nroRegistros][fimRegistros][registros ...][livre ...][diretório]
+ *
+ * Os registros são gravados em sequência logo após o cabeçalho, no mesmo formato do arquivo em fluxo, e nunca
+ * atravessam o fim de um bloco. O diretório fica no final do bloco e cresce para trás: a entrada i guarda a
+ * posição do registro i relativa ao inicio do bloco. Entre os registros e o diretório sempre sobra ao menos
+ * um byte livre, assim uma leitura sequencial sabe onde os registros do bloco acabam
+ *
+ * Os registros de um bloco nunca mudam de posição, então byteOffsets guardados em indices continuam válidos
+ */
+
+int formatoArquivoDados(FILE* arquivo, int tamanhoHeader);
+long int inicioDoBloco(long int posicao, int tamanhoHeader);
+int pulaEspacoLivre(FILE* arquivo, int tamanhoHeader);
+int pulaEspacoLivreMapa(arquivoMapeado* mapa, int tamanhoHeader);
+
+void iniciaBlocoVazio(char* bloco);
+int nroRegistrosBloco(char* bloco);
+int fimRegistrosBloco(char* bloco);
+int posicaoRegistroBloco(char* bloco, int indice);
+int cabeNoBloco(char* bloco, int tamanho);
+void registraNoBloco(char* bloco, int tamanho);
+
+#endif
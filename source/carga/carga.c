@@ -0,0 +1,178 @@
+#include "carga.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../csv/csv.h"
+#include "../estatisticas/estatisticas.h"
+#include "../utils/utils.h"
+
+/**
+ * Divide o CSV em blocos de aproximadamente TAMANHO_BLOCO_CARGA bytes, sempre cortando logo após um '\n'
+ * para que nenhum registro fique dividido entre dois blocos
+ * @param dados inicio dos registros do CSV
+ * @param tamanho quantidade de bytes dos registros
+ * @param blocos vetor alocado com os blocos
+ * @return retorna a quantidade de blocos
+ */
+int divideBlocos(char* dados, long int tamanho, blocoCarga** blocos) {
+    int capacidade = tamanho / TAMANHO_BLOCO_CARGA + 1;
+    int nroBlocos = 0;
+    *blocos = (blocoCarga*)malloc(capacidade * sizeof(blocoCarga));
+
+    long int inicio = 0;
+    while (inicio < tamanho) {
+        long int fim = inicio + TAMANHO_BLOCO_CARGA;
+
+        if (fim >= tamanho) {
+            fim = tamanho;
+        } else {
+            char* quebra = (char*)memchr(dados + fim - 1, '\n', tamanho - fim + 1);
+            fim = (quebra == NULL) ? tamanho : quebra - dados + 1;
+        }
+
+        if (nroBlocos == capacidade) {
+            capacidade *= 2;
+            *blocos = (blocoCarga*)realloc(*blocos, capacidade * sizeof(blocoCarga));
+        }
+
+        blocoCarga* bloco = &(*blocos)[nroBlocos++];
+        bloco->inicio = dados + inicio;
+        bloco->tamanho = fim - inicio;
+        bloco->saida = NULL;
+        bloco->tamanhoSaida = 0;
+        bloco->nroRegistros = 0;
+        bloco->nroRegRemovidos = 0;
+        bloco->pronto = 0;
+
+        inicio = fim;
+    }
+
+    return nroBlocos;
+}
+
+/**
+ * Converte todos os registros de um bloco do CSV para o formato do binário
+ * @param carga estado da carga
+ * @param bloco bloco a ser convertido
+ */
+void codificaBloco(cargaParalela* carga, blocoCarga* bloco) {
+    leitorCSV leitor;
+    iniciaLeitorCSVMemoria(&leitor, bloco->inicio, bloco->tamanho);
+
+    long int capacidade = bloco->tamanho + carga->tamanhoMaximoRegistro;
+    bloco->saida = (char*)malloc(capacidade);
+
+    int isFinalDoBloco = fimLeitorCSV(&leitor);
+    while (!isFinalDoBloco) {
+        if (capacidade - bloco->tamanhoSaida < carga->tamanhoMaximoRegistro) {
+            capacidade *= 2;
+            bloco->saida = (char*)realloc(bloco->saida, capacidade);
+        }
+
+        char removido;
+        bloco->tamanhoSaida += carga->codificar(&leitor, carga->contexto, bloco->saida + bloco->tamanhoSaida, &removido);
+        bloco->nroRegRemovidos += (removido == '0') ? 1 : 0;
+        bloco->nroRegistros += (removido == '0') ? 0 : 1;
+
+        isFinalDoBloco = fimLeitorCSV(&leitor);
+    }
+
+    finalizaLeitorCSV(&leitor);
+}
+
+/**
+ * Rotina das threads: pega o próximo bloco livre, converte e avisa a escrita
+ * uma thread não pega blocos muito à frente da escrita, limitando a memória usada pelas saidas
+ * @param argumento estado da carga
+ * @return retorna sempre NULL
+ */
+void* processaBlocos(void* argumento) {
+    cargaParalela* carga = (cargaParalela*)argumento;
+
+    while (1) {
+        pthread_mutex_lock(&carga->trava);
+        while (carga->proximoBloco < carga->nroBlocos && carga->proximoBloco >= carga->blocosEscritos + carga->janela) {
+            pthread_cond_wait(&carga->blocoEscrito, &carga->trava);
+        }
+        if (carga->proximoBloco >= carga->nroBlocos) {
+            pthread_mutex_unlock(&carga->trava);
+            return NULL;
+        }
+        int indice = carga->proximoBloco++;
+        pthread_mutex_unlock(&carga->trava);
+
+        codificaBloco(carga, &carga->blocos[indice]);
+
+        pthread_mutex_lock(&carga->trava);
+        carga->blocos[indice].pronto = 1;
+        pthread_cond_broadcast(&carga->blocoPronto);
+        pthread_mutex_unlock(&carga->trava);
+    }
+}
+
+/**
+ * Converte os registros de um CSV em memória para o binário usando várias threads
+ * os blocos são convertidos em paralelo e escritos na ordem original a partir da posição atual do binário,
+ * então o resultado é idêntico ao da conversão registro a registro
+ * a quantidade de threads pode ser alterada pela variável de ambiente THREADS_CARGA
+ * @param dados inicio dos registros do CSV (logo após o header)
+ * @param tamanho quantidade de bytes dos registros
+ * @param buffer buffer de escrita do binário, iniciado onde o primeiro registro será escrito
+ * @param codificar função que lê e codifica um registro
+ * @param contexto valor repassado a cada chamada de codificar (como o dicionário do arquivo), pode ser NULL
+ * @param tamanhoMaximoRegistro maior quantidade de bytes que um registro codificado pode ocupar
+ * @param nroRegistros contador de registros do header, incrementado com os registros escritos
+ * @param nroRegRemovidos contador de removidos do header, incrementado com os removidos escritos
+ */
+void carregaCSVParalelo(char* dados, long int tamanho, bufferEscrita* buffer, codificaRegistroCSV codificar, void* contexto,
+                        int tamanhoMaximoRegistro, int* nroRegistros, int* nroRegRemovidos) {
+    cargaParalela carga;
+    carga.nroBlocos = divideBlocos(dados, tamanho, &carga.blocos);
+    carga.proximoBloco = 0;
+    carga.blocosEscritos = 0;
+    carga.codificar = codificar;
+    carga.contexto = contexto;
+    carga.tamanhoMaximoRegistro = tamanhoMaximoRegistro;
+    pthread_mutex_init(&carga.trava, NULL);
+    pthread_cond_init(&carga.blocoPronto, NULL);
+    pthread_cond_init(&carga.blocoEscrito, NULL);
+
+    long int nroThreads = lerConfiguracao("THREADS_CARGA", sysconf(_SC_NPROCESSORS_ONLN));
+    if (nroThreads > carga.nroBlocos) nroThreads = carga.nroBlocos;
+    if (nroThreads < 1) nroThreads = 1;
+    carga.janela = nroThreads * BLOCOS_POR_THREAD;
+
+    pthread_t* threads = (pthread_t*)malloc(nroThreads * sizeof(pthread_t));
+    for (int i = 0; i < nroThreads; i++) pthread_create(&threads[i], NULL, processaBlocos, &carga);
+
+    // escreve os blocos na ordem do CSV conforme ficam prontos
+    for (int i = 0; i < carga.nroBlocos; i++) {
+        blocoCarga* bloco = &carga.blocos[i];
+
+        pthread_mutex_lock(&carga.trava);
+        while (!bloco->pronto) pthread_cond_wait(&carga.blocoPronto, &carga.trava);
+        pthread_mutex_unlock(&carga.trava);
+
+        acrescentaRegistrosBufferEscrita(buffer, bloco->saida, bloco->tamanhoSaida);
+        *nroRegistros += bloco->nroRegistros;
+        *nroRegRemovidos += bloco->nroRegRemovidos;
+        free(bloco->saida);
+
+        pthread_mutex_lock(&carga.trava);
+        carga.blocosEscritos++;
+        pthread_cond_broadcast(&carga.blocoEscrito);
+        pthread_mutex_unlock(&carga.trava);
+    }
+
+    for (int i = 0; i < nroThreads; i++) pthread_join(threads[i], NULL);
+
+    pthread_mutex_destroy(&carga.trava);
+    pthread_cond_destroy(&carga.blocoPronto);
+    pthread_cond_destroy(&carga.blocoEscrito);
+    free(threads);
+    free(carga.blocos);
+}
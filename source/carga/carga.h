@@ -0,0 +1,52 @@
+#ifndef _CARGA_H_
+#define _CARGA_H_
+#include <pthread.h>
+#include <stdio.h>
+
+#include "../binario/binario.h"
+#include "../csv/csv.h"
+
+#define TAMANHO_BLOCO_CARGA 1048576  // tamanho aproximado de cada pedaço do CSV entregue a uma thread
+#define BLOCOS_POR_THREAD 2          // quantos blocos cada thread pode adiantar em relação à escrita
+
+/**
+ * Lê o próximo registro do CSV e escreve o registro já no formato do binário em destino
+ * contexto é o mesmo valor recebido por carregaCSVParalelo, compartilhado por todas as threads
+ * @return retorna a quantidade de bytes escritos
+ */
+typedef int (*codificaRegistroCSV)(leitorCSV* leitor, void* contexto, char* destino, char* removido);
+
+/**
+ * Pedaço do CSV que começa e termina em uma quebra de linha, junto dos registros já codificados
+ */
+typedef struct blocoCarga {
+    char* inicio;
+    long int tamanho;
+    char* saida;
+    long int tamanhoSaida;
+    int nroRegistros;
+    int nroRegRemovidos;
+    int pronto;  // 1 quando a saida já pode ser escrita
+} blocoCarga;
+
+/**
+ * Estado compartilhado entre as threads que codificam os blocos e a escrita
+ */
+typedef struct cargaParalela {
+    blocoCarga* blocos;
+    int nroBlocos;
+    int proximoBloco;    // próximo bloco ainda não pego por nenhuma thread
+    int blocosEscritos;  // blocos já escritos no binário, sempre em ordem
+    int janela;          // máximo de blocos à frente da escrita
+    codificaRegistroCSV codificar;
+    void* contexto;
+    int tamanhoMaximoRegistro;
+    pthread_mutex_t trava;
+    pthread_cond_t blocoPronto;
+    pthread_cond_t blocoEscrito;
+} cargaParalela;
+
+void carregaCSVParalelo(char* dados, long int tamanho, bufferEscrita* buffer, codificaRegistroCSV codificar, void* contexto,
+                        int tamanhoMaximoRegistro, int* nroRegistros, int* nroRegRemovidos);
+
+#endif
@@ -1,34 +1,161 @@
 #include "csv.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../estatisticas/estatisticas.h"
 
 #include "../utils/utils.h"
 
+#define BYTES_UM 0x0101010101010101ULL
+#define BYTES_OITENTA 0x8080808080808080ULL
+
+/**
+ * Inicia um leitor sobre um arquivo CSV aberto, o arquivo continua sendo do chamador
+ * @param leitor leitor a ser iniciado
+ * @param arquivo arquivo CSV de onde os blocos serão lidos
+ */
+void iniciaLeitorCSV(leitorCSV* leitor, FILE* arquivo) {
+    leitor->arquivo = arquivo;
+    leitor->capacidade = TAMANHO_BUFFER_CSV;
+    leitor->buffer = (char*)malloc(leitor->capacidade);
+    leitor->tamanho = 0;
+    leitor->posicao = 0;
+    leitor->fimArquivo = 0;
+}
+
+/**
+ * Inicia um leitor sobre um trecho de CSV que já está em memória (como um arquivo mapeado)
+ * a região não é copiada nem alterada e continua sendo do chamador
+ * @param leitor leitor a ser iniciado
+ * @param dados inicio do trecho
+ * @param tamanho quantidade de bytes do trecho
+ */
+void iniciaLeitorCSVMemoria(leitorCSV* leitor, char* dados, long int tamanho) {
+    leitor->arquivo = NULL;
+    leitor->capacidade = tamanho;
+    leitor->buffer = dados;
+    leitor->tamanho = tamanho;
+    leitor->posicao = 0;
+    leitor->fimArquivo = 1;
+}
+
+/**
+ * Libera o buffer de um leitor
+ * @param leitor leitor a ser finalizado
+ */
+void finalizaLeitorCSV(leitorCSV* leitor) {
+    if (leitor->arquivo != NULL) free(leitor->buffer);
+    leitor->buffer = NULL;
+}
+
+/**
+ * Descarta os bytes já consumidos e completa o buffer com o próximo bloco do arquivo
+ * caso o buffer esteja cheio de bytes ainda não consumidos ele é dobrado
+ * @param leitor leitor a ser recarregado
+ * @return retorna a quantidade de bytes novos no buffer
+ */
+long int recarregaLeitorCSV(leitorCSV* leitor) {
+    if (leitor->fimArquivo) return 0;
+
+    long int restantes = leitor->tamanho - leitor->posicao;
+    if (leitor->posicao > 0) memmove(leitor->buffer, leitor->buffer + leitor->posicao, restantes);
+    leitor->tamanho = restantes;
+    leitor->posicao = 0;
+
+    if (leitor->tamanho == leitor->capacidade) {
+        leitor->capacidade *= 2;
+        leitor->buffer = (char*)realloc(leitor->buffer, leitor->capacidade);
+    }
+
+    long int lidos = fread(leitor->buffer + leitor->tamanho, sizeof(char), leitor->capacidade - leitor->tamanho, leitor->arquivo);
+    if (lidos == 0) leitor->fimArquivo = 1;
+    leitor->tamanho += lidos;
+
+    return lidos;
+}
+
+/**
+ * Determina se todo o arquivo já foi consumido, equivalente ao finalDoArquivo
+ * @param leitor leitor a ser analisado
+ * @return retorna 1 caso seja o final e 0 caso não seja
+ */
+int fimLeitorCSV(leitorCSV* leitor) {
+    if (leitor->posicao < leitor->tamanho) return 0;
+    return recarregaLeitorCSV(leitor) == 0;
+}
+
 /**
- * Lê um campo CSV byte a byte
- * @param arquivo arquivo a ser lido
- * @param string string onde o conteúdo será salvo
+ * Procura o primeiro ',' ou '\n' de uma região comparando 8 bytes por vez (SWAR)
+ * um byte igual ao delimitador vira zero após o xor, e a expressão (x - 0x01..) & ~x & 0x80..
+ * marca o bit mais alto do primeiro byte zero de cada palavra
+ * @param inicio inicio da região
+ * @param tamanho quantidade de bytes da região
+ * @return retorna a posição do delimitador ou tamanho caso não encontre
+ */
+long int procuraDelimitador(char* inicio, long int tamanho) {
+    const unsigned long long virgulas = BYTES_UM * ',';
+    const unsigned long long quebras = BYTES_UM * '\n';
+    long int i = 0;
+
+    for (; i + 8 <= tamanho; i += 8) {
+        unsigned long long palavra;
+        memcpy(&palavra, inicio + i, sizeof(palavra));
+
+        unsigned long long x = palavra ^ virgulas;
+        unsigned long long y = palavra ^ quebras;
+        unsigned long long encontrados = ((x - BYTES_UM) & ~x) | ((y - BYTES_UM) & ~y);
+        encontrados &= BYTES_OITENTA;
+
+        if (encontrados) {
+            // os bytes da palavra estão em ordem little-endian
+            return i + __builtin_ctzll(encontrados) / 8;
+        }
+    }
+
+    for (; i < tamanho; i++) {
+        if (inicio[i] == ',' || inicio[i] == '\n') return i;
+    }
+    return tamanho;
+}
+
+/**
+ * Localiza o próximo campo do CSV e consome o seu delimitador
+ * @param leitor leitor do arquivo
+ * @param campo ponteiro para o inicio do campo no buffer, válido até a próxima leitura
  * @return tamanho do campo lido
  */
-int lerByteAByte(FILE* arquivo, char* string) {
-    int posicao = -1;
+int proximoCampo(leitorCSV* leitor, char** campo) {
+    long int inicioBusca = 0;
+    long int fimCampo;
+
+    while (1) {
+        long int disponiveis = leitor->tamanho - leitor->posicao;
+        fimCampo = inicioBusca + procuraDelimitador(leitor->buffer + leitor->posicao + inicioBusca, disponiveis - inicioBusca);
+        if (fimCampo < disponiveis) break;
 
-    do {
-        posicao++;
-        fread(&string[posicao], sizeof(char), 1, arquivo);
-    } while (string[posicao] != '\n' && string[posicao] != ',');
+        // o campo continua no próximo bloco do arquivo
+        inicioBusca = disponiveis;
+        if (recarregaLeitorCSV(leitor) == 0) break;
+    }
 
-    return posicao;
+    *campo = leitor->buffer + leitor->posicao;
+    leitor->posicao += fimCampo;
+    if (leitor->posicao < leitor->tamanho) leitor->posicao++;  // pula o delimitador
+
+    return (int)fimCampo;
 }
 
 /**
  * Testa se o valor lido é equivalente a NULO
- * @param string string a ser testada
+ * @param campo campo a ser testado
+ * @param tamanho tamanho do campo
  * @return 1 para válido e 0 para inválido
  */
-int validarValorLido(char string[11]) {
-    if (string[0] == 'N' && string[1] == 'U' && string[2] == 'L' &&
-        string[3] == 'O') {
+int validarValorLido(char* campo, int tamanho) {
+    if (tamanho >= 4 && campo[0] == 'N' && campo[1] == 'U' && campo[2] == 'L' &&
+        campo[3] == 'O') {
         return 0;
     }
     return 1;
@@ -36,54 +163,54 @@ int validarValorLido(char string[11]) {
 
 /**
  * Lê um campo de string do csv e adiciona \0 no final
- * @param arquivo arquivo a ser lido
+ * @param leitor leitor do arquivo
  * @param string local onde o conteudo será salvo
  * @return retorna o tamanho da string lida
  */
-int lerString(FILE* arquivo, char* string) {
-    int tamanho = lerByteAByte(arquivo, string);
-    if (!validarValorLido(string)) tamanho = 0;
+int lerString(leitorCSV* leitor, char* string) {
+    char* campo;
+    int tamanho = proximoCampo(leitor, &campo);
+    if (!validarValorLido(campo, tamanho)) tamanho = 0;
+    memcpy(string, campo, tamanho);
     string[tamanho] = '\0';
     return tamanho;
 }
 
 /**
  * Lê um campo de string do csv de tamanho fixo
- * @param arquivo arquivo a ser lido
+ * @param leitor leitor do arquivo
  * @param string local onde o conteudo será salvo
  * @param tamanhoMaximo tamanho máximo aceito
  * @return retorna o tamanho real da string lida
  */
-int lerStringFixa(FILE* arquivo, char* string, int tamanhoMaximo) {
-    int tamanhoReal = lerString(arquivo, string);
+int lerStringFixa(leitorCSV* leitor, char* string, int tamanhoMaximo) {
+    int tamanhoReal = lerString(leitor, string);
     for (int i = tamanhoReal + 1; i < tamanhoMaximo; i++) string[i] = '@';  //completa de @ após o \0 caso necessário
     return tamanhoReal;
 }
 
 /**
  * Testa se um campo do CSV foi removido ou não
- * @param arquivo arquivo a ser analisado
+ * @param leitor leitor do arquivo
  * @return retorna '0' para removido e '1' para não removido
  */
-char foiRemovido(FILE* arquivo) {
-    char primeiroChar;
-    fread(&primeiroChar, sizeof(char), 1, arquivo);
-    primeiroChar = (primeiroChar == '*') ? '0' : '1';
-    if (primeiroChar == '1') fseek(arquivo, -1, SEEK_CUR);
-    return primeiroChar;
+char foiRemovido(leitorCSV* leitor) {
+    if (fimLeitorCSV(leitor)) return '1';
+    if (leitor->buffer[leitor->posicao] != '*') return '1';
+    leitor->posicao++;
+    return '0';
 }
 
 /**
- * Lê um campo de inteiro de um CSV
- * @param arquivo arquivo a ser analisado
+ * Lê um campo de inteiro de um CSV convertendo direto do buffer
+ * @param leitor leitor do arquivo
  * @return retorna o próprio valor lido ou -1 caso seja nulo
  */
-int lerInteiro(FILE* arquivo) {
-    char string[11];  // tamanho do maior inteiro possivel
-
-    int tamanho = lerByteAByte(arquivo, string);
+int lerInteiro(leitorCSV* leitor) {
+    char* campo;
+    int tamanho = proximoCampo(leitor, &campo);
 
-    if (validarValorLido(string) == 0) return -1;
+    if (validarValorLido(campo, tamanho) == 0) return -1;
 
-    return stringToInt(string, tamanho);
+    return stringToInt(campo, tamanho);
 }
@@ -2,9 +2,28 @@
 #define _CSV_H_
 #include <stdio.h>
 
-int lerString(FILE* arquivo, char* string);
-int lerInteiro(FILE* arquivo);
-int lerStringFixa(FILE* arquivo, char* string, int tamanho);
-char foiRemovido(FILE* arquivo);
+#define TAMANHO_BUFFER_CSV 65536  // bytes lidos do arquivo a cada recarga do buffer
 
-#endif
\ No newline at end of file
+/**
+ * Leitor de CSV que consome o arquivo em blocos grandes em vez de byte a byte
+ * os campos são localizados e convertidos diretamente no buffer
+ */
+typedef struct leitorCSV {
+    FILE* arquivo;  // NULL quando o leitor percorre uma região já em memória
+    char* buffer;
+    long int capacidade;  // tamanho alocado do buffer
+    long int tamanho;     // bytes válidos no buffer
+    long int posicao;     // próximo byte a ser consumido
+    int fimArquivo;       // 1 caso o arquivo não tenha mais bytes para o buffer
+} leitorCSV;
+
+void iniciaLeitorCSV(leitorCSV* leitor, FILE* arquivo);
+void iniciaLeitorCSVMemoria(leitorCSV* leitor, char* dados, long int tamanho);
+void finalizaLeitorCSV(leitorCSV* leitor);
+int fimLeitorCSV(leitorCSV* leitor);
+int lerString(leitorCSV* leitor, char* string);
+int lerInteiro(leitorCSV* leitor);
+int lerStringFixa(leitorCSV* leitor, char* string, int tamanho);
+char foiRemovido(leitorCSV* leitor);
+
+#endif
@@ -0,0 +1,320 @@
+#include "dicionario.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../binario/binario.h"
+#include "../estatisticas/estatisticas.h"
+#include "../hash/hash.h"
+
+/**
+ * Monta o nome do arquivo do dicionário, que fica ao lado do arquivo de dados
+ * @param nomeArquivo nome do arquivo de dados
+ * @param nomeDicionario onde o nome do dicionário será escrito
+ */
+void nomeArquivoDicionario(char* nomeArquivo, char* nomeDicionario) {
+    sprintf(nomeDicionario, "%s.dic", nomeArquivo);
+}
+
+/**
+ * Cria um dicionário sem nenhum valor, ainda não salvo
+ * @param nroCampos quantidade de campos codificados, no máximo MAXIMO_CAMPOS_DICIONARIO
+ * @return ponteiro para o dicionário criado
+ */
+dicionario* criaDicionario(int nroCampos) {
+    dicionario* dic = (dicionario*)malloc(sizeof(dicionario));
+    dic->nroCampos = nroCampos;
+    dic->alterado = 1;
+
+    for (int i = 0; i < nroCampos; i++) {
+        campoDicionario* campo = &dic->campos[i];
+        campo->quantidade = 0;
+        campo->capacidade = 16;
+        campo->valores = (char**)malloc(campo->capacidade * sizeof(char*));
+        campo->tamanhos = (int*)malloc(campo->capacidade * sizeof(int));
+        campo->tamanhoTabela = TAMANHO_TABELA_DICIONARIO;
+        campo->tabela = (int*)malloc(campo->tamanhoTabela * sizeof(int));
+        memset(campo->tabela, -1, campo->tamanhoTabela * sizeof(int));
+    }
+
+    return dic;
+}
+
+/**
+ * Encontra a posição da tabela onde o valor está ou onde deve ser colocado (sondagem linear)
+ * @param campo campo do dicionário
+ * @param valor bytes do valor
+ * @param tamanho quantidade de bytes
+ * @return posição da tabela
+ */
+int posicaoTabelaDicionario(campoDicionario* campo, char* valor, int tamanho) {
+    int mascara = campo->tamanhoTabela - 1;
+    int posicao = espalhaString(valor, tamanho) & mascara;
+
+    while (campo->tabela[posicao] != -1) {
+        int codigo = campo->tabela[posicao];
+        if (campo->tamanhos[codigo] == tamanho && memcmp(campo->valores[codigo], valor, tamanho) == 0) break;
+        posicao = (posicao + 1) & mascara;
+    }
+
+    return posicao;
+}
+
+/**
+ * Dobra a tabela de busca de um campo e reposiciona todos os códigos
+ * @param campo campo do dicionário
+ */
+void dobraTabelaDicionario(campoDicionario* campo) {
+    free(campo->tabela);
+    campo->tamanhoTabela *= 2;
+    campo->tabela = (int*)malloc(campo->tamanhoTabela * sizeof(int));
+    memset(campo->tabela, -1, campo->tamanhoTabela * sizeof(int));
+
+    for (int codigo = 0; codigo < campo->quantidade; codigo++)
+        campo->tabela[posicaoTabelaDicionario(campo, campo->valores[codigo], campo->tamanhos[codigo])] = codigo;
+}
+
+/**
+ * Obtém o código de um valor, acrescentando o valor ao dicionário caso ele ainda não exista
+ * @param dic dicionário
+ * @param campo posição do campo no dicionário
+ * @param valor bytes do valor, não necessariamente terminados em \0
+ * @param tamanho quantidade de bytes do valor
+ * @return código do valor
+ */
+int codigoDicionario(dicionario* dic, int campo, char* valor, int tamanho) {
+    campoDicionario* atual = &dic->campos[campo];
+    int posicao = posicaoTabelaDicionario(atual, valor, tamanho);
+    if (atual->tabela[posicao] != -1) return atual->tabela[posicao];
+
+    if (atual->quantidade == atual->capacidade) {
+        atual->capacidade *= 2;
+        atual->valores = (char**)realloc(atual->valores, atual->capacidade * sizeof(char*));
+        atual->tamanhos = (int*)realloc(atual->tamanhos, atual->capacidade * sizeof(int));
+    }
+
+    int codigo = atual->quantidade++;
+    atual->valores[codigo] = (char*)malloc(tamanho > 0 ? tamanho : 1);
+    memcpy(atual->valores[codigo], valor, tamanho);
+    atual->tamanhos[codigo] = tamanho;
+    atual->tabela[posicao] = codigo;
+    dic->alterado = 1;
+
+    // a tabela fica sempre com menos da metade das posições ocupadas
+    if (2 * atual->quantidade > atual->tamanhoTabela) dobraTabelaDicionario(atual);
+    return codigo;
+}
+
+/**
+ * Procura o código de um valor sem alterar o dicionário, pode ser usada por várias threads ao mesmo tempo
+ * @param dic dicionário
+ * @param campo posição do campo no dicionário
+ * @param valor bytes do valor
+ * @param tamanho quantidade de bytes do valor
+ * @return código do valor ou -1 caso ele não esteja no dicionário
+ */
+int procuraDicionario(dicionario* dic, int campo, char* valor, int tamanho) {
+    campoDicionario* atual = &dic->campos[campo];
+    return atual->tabela[posicaoTabelaDicionario(atual, valor, tamanho)];
+}
+
+/**
+ * @param dic dicionário
+ * @param campo posição do campo no dicionário
+ * @param codigo código gravado no registro
+ * @param tamanho onde a quantidade de bytes do valor será escrita
+ * @return valor do código (não terminado em \0) ou NULL, com tamanho 0, para um código desconhecido
+ */
+char* valorDicionario(dicionario* dic, int campo, int codigo, int* tamanho) {
+    campoDicionario* atual = &dic->campos[campo];
+    if (codigo < 0 || codigo >= atual->quantidade) {
+        *tamanho = 0;
+        return NULL;
+    }
+
+    *tamanho = atual->tamanhos[codigo];
+    return atual->valores[codigo];
+}
+
+/**
+ * Carrega o dicionário salvo ao lado do arquivo de dados
+ * @param nomeArquivo nome do arquivo de dados
+ * @param nroCampos quantidade de campos codificados
+ * @return ponteiro para o dicionário ou NULL caso o arquivo não use dicionário
+ */
+dicionario* carregaDicionario(char* nomeArquivo, int nroCampos) {
+    char nomeDicionario[300];
+    nomeArquivoDicionario(nomeArquivo, nomeDicionario);
+
+    FILE* arquivoDicionario = fopen(nomeDicionario, "rb");
+    if (arquivoDicionario == NULL) return NULL;
+
+    int nroCamposGuardado = -1;
+    if (fread(&nroCamposGuardado, sizeof(int), 1, arquivoDicionario) != 1 || nroCamposGuardado != nroCampos) {
+        fclose(arquivoDicionario);
+        return NULL;
+    }
+
+    dicionario* dic = criaDicionario(nroCampos);
+    char valor[TAMANHO_MAXIMO_DICIONARIO];
+    int integro = 1;
+
+    for (int campo = 0; campo < nroCampos && integro; campo++) {
+        int quantidade = -1;
+        integro = fread(&quantidade, sizeof(int), 1, arquivoDicionario) == 1 && quantidade >= 0;
+
+        for (int i = 0; i < quantidade && integro; i++) {
+            int tamanho = -1;
+            integro = fread(&tamanho, sizeof(int), 1, arquivoDicionario) == 1 && tamanho >= 0 && tamanho <= TAMANHO_MAXIMO_DICIONARIO &&
+                      fread(valor, sizeof(char), tamanho, arquivoDicionario) == (size_t)tamanho;
+            if (integro) codigoDicionario(dic, campo, valor, tamanho);
+        }
+    }
+
+    fclose(arquivoDicionario);
+    if (!integro) {
+        liberaDicionario(dic);
+        return NULL;
+    }
+    dic->alterado = 0;
+    return dic;
+}
+
+/**
+ * Salva o dicionário ao lado do arquivo de dados, depois disso ele deixa de estar alterado
+ * @param dic dicionário
+ * @param nomeArquivo nome do arquivo de dados
+ */
+void salvaDicionario(dicionario* dic, char* nomeArquivo) {
+    char nomeDicionario[300];
+    nomeArquivoDicionario(nomeArquivo, nomeDicionario);
+
+    FILE* arquivoDicionario = fopen(nomeDicionario, "wb");
+    if (arquivoDicionario == NULL) return;
+
+    fwrite(&dic->nroCampos, sizeof(int), 1, arquivoDicionario);
+    for (int campo = 0; campo < dic->nroCampos; campo++) {
+        campoDicionario* atual = &dic->campos[campo];
+        fwrite(&atual->quantidade, sizeof(int), 1, arquivoDicionario);
+
+        for (int codigo = 0; codigo < atual->quantidade; codigo++) {
+            fwrite(&atual->tamanhos[codigo], sizeof(int), 1, arquivoDicionario);
+            fwrite(atual->valores[codigo], sizeof(char), atual->tamanhos[codigo], arquivoDicionario);
+        }
+    }
+
+    fclose(arquivoDicionario);
+    dic->alterado = 0;
+}
+
+/**
+ * Remove o dicionário de um arquivo de dados que passou a ser gravado por extenso
+ * @param nomeArquivo nome do arquivo de dados
+ */
+void removeDicionario(char* nomeArquivo) {
+    char nomeDicionario[300];
+    nomeArquivoDicionario(nomeArquivo, nomeDicionario);
+    remove(nomeDicionario);
+}
+
+/**
+ * Libera a memória usada pelo dicionário
+ * @param dic dicionário, pode ser NULL
+ */
+void liberaDicionario(dicionario* dic) {
+    if (dic == NULL) return;
+
+    for (int campo = 0; campo < dic->nroCampos; campo++) {
+        campoDicionario* atual = &dic->campos[campo];
+        for (int codigo = 0; codigo < atual->quantidade; codigo++) free(atual->valores[codigo]);
+        free(atual->valores);
+        free(atual->tamanhos);
+        free(atual->tabela);
+    }
+
+    free(dic);
+}
+
+/**
+ * @param dic dicionário do arquivo ou NULL caso os campos sejam gravados por extenso
+ * @param tamanho tamanho do valor do campo
+ * @return quantidade de bytes que o valor ocupa no registro, sem contar o inteiro do tamanho
+ */
+int bytesCampoDicionario(dicionario* dic, int tamanho) {
+    return (dic != NULL && tamanho > 0) ? 0 : tamanho;
+}
+
+/**
+ * Escreve um campo de texto variável no formato do registro, como código quando há dicionário
+ * o valor é acrescentado ao dicionário caso ainda não exista, quem grava em paralelo deve ter
+ * acrescentado antes todos os valores para que o dicionário só seja lido
+ * @param destino região onde o campo será escrito
+ * @param dic dicionário do arquivo ou NULL caso os campos sejam gravados por extenso
+ * @param campo posição do campo no dicionário
+ * @param valor bytes do valor
+ * @param tamanho tamanho do valor, 0 para nulo
+ * @return retorna a posição logo após o ultimo byte escrito
+ */
+char* codificaCampoDicionario(char* destino, dicionario* dic, int campo, char* valor, int tamanho) {
+    int marcador = tamanho;
+    if (bytesCampoDicionario(dic, tamanho) == 0 && tamanho > 0) {
+        int codigo = procuraDicionario(dic, campo, valor, tamanho);
+        if (codigo == -1) codigo = codigoDicionario(dic, campo, valor, tamanho);
+        marcador = -(codigo + 1);
+    }
+
+    memcpy(destino, &marcador, sizeof(int));
+    destino += sizeof(int);
+    if (marcador > 0) {
+        memcpy(destino, valor, marcador);
+        destino += marcador;
+    }
+    return destino;
+}
+
+/**
+ * Lê um campo de texto variável de um arquivo mapeado, decodificando o código gravado no lugar do tamanho
+ * @param mapa mapeamento posicionado no tamanho do campo
+ * @param dic dicionário do arquivo ou NULL caso os campos sejam gravados por extenso
+ * @param campo posição do campo no dicionário
+ * @param tamanho onde o tamanho do valor será escrito
+ * @param codigo onde o código do valor será escrito, -1 para um valor gravado por extenso
+ * @return ponteiro para o valor, no mapeamento ou no dicionário, não terminado em \0
+ */
+char* lerCampoDicionarioMapa(arquivoMapeado* mapa, dicionario* dic, int campo, int* tamanho, int* codigo) {
+    *tamanho = lerInteiroMapa(mapa);
+    *codigo = -1;
+    if (*tamanho >= 0) return lerStringMapa(mapa, *tamanho);
+
+    // sem o dicionário o código não pode ser lido e o campo fica nulo
+    *codigo = -(*tamanho) - 1;
+    if (dic == NULL) {
+        *tamanho = 0;
+        return NULL;
+    }
+    return valorDicionario(dic, campo, *codigo, tamanho);
+}
+
+/**
+ * Lê um campo de texto variável de um arquivo binário para uma string, decodificando o código gravado no lugar do tamanho
+ * @param arquivo arquivo posicionado no tamanho do campo
+ * @param dic dicionário do arquivo ou NULL caso os campos sejam gravados por extenso
+ * @param campo posição do campo no dicionário
+ * @param destino string onde o valor será copiado, terminado em \0
+ * @param tamanho onde o tamanho do valor será escrito
+ * @return retorna a quantidade de bytes que o valor ocupava no arquivo
+ */
+int lerCampoDicionarioBin(FILE* arquivo, dicionario* dic, int campo, char* destino, int* tamanho) {
+    *tamanho = lerInteiroBin(arquivo);
+    if (*tamanho >= 0) {
+        lerStringBin(arquivo, destino, *tamanho);
+        return *tamanho;
+    }
+
+    char* valor = (dic != NULL) ? valorDicionario(dic, campo, -(*tamanho) - 1, tamanho) : NULL;
+    if (valor == NULL) *tamanho = 0;
+    else memcpy(destino, valor, *tamanho);
+    destino[*tamanho] = '\0';
+    return 0;
+}
@@ -0,0 +1,50 @@
+#ifndef _DICIONARIO_H_
+#define _DICIONARIO_H_
+#include <stdio.h>
+
+#include "../mapeamento/mapeamento.h"
+
+#define MAXIMO_CAMPOS_DICIONARIO 2  // campos de texto codificados por arquivo
+#define TAMANHO_TABELA_DICIONARIO 64  // posições iniciais da tabela de busca de cada campo (potência de 2)
+#define TAMANHO_MAXIMO_DICIONARIO 99  // maior valor aceito, cabe nos campos de 100 bytes das structs
+#define CODIGO_AUSENTE_DICIONARIO -2  // código de um valor procurado que não está no dicionário, não é igual a nenhum registro
+
+/**
+ * Com DICIONARIO=1 na criação da tabela, campos de texto com poucos valores distintos (modelo e categoria dos
+ * veiculos, cor das linhas) deixam de ser gravados por extenso: cada valor distinto fica uma única vez em
+ * <arquivo>.dic e o registro guarda apenas o código do valor no lugar do tamanho do campo, como -(codigo + 1),
+ * sem nenhum byte depois. Campos nulos continuam com tamanho 0
+ *
+ * Os códigos são dados na ordem em que os valores aparecem pela primeira vez, então o mesmo CSV gera sempre
+ * o mesmo arquivo. O dicionário faz parte da tabela, sem ele os campos codificados não podem ser lidos
+ */
+typedef struct campoDicionario {
+    char** valores;   // valores[codigo], não terminados em \0
+    int* tamanhos;
+    int quantidade;
+    int capacidade;
+    int* tabela;      // códigos espalhados pelo hash do valor, -1 nas posições vazias
+    int tamanhoTabela;
+} campoDicionario;
+
+typedef struct dicionario {
+    campoDicionario campos[MAXIMO_CAMPOS_DICIONARIO];
+    int nroCampos;
+    int alterado;  // 1 quando há valores que ainda não foram salvos no .dic
+} dicionario;
+
+void nomeArquivoDicionario(char* nomeArquivo, char* nomeDicionario);
+dicionario* criaDicionario(int nroCampos);
+dicionario* carregaDicionario(char* nomeArquivo, int nroCampos);
+void salvaDicionario(dicionario* dic, char* nomeArquivo);
+void removeDicionario(char* nomeArquivo);
+void liberaDicionario(dicionario* dic);
+int codigoDicionario(dicionario* dic, int campo, char* valor, int tamanho);
+int procuraDicionario(dicionario* dic, int campo, char* valor, int tamanho);
+char* valorDicionario(dicionario* dic, int campo, int codigo, int* tamanho);
+int bytesCampoDicionario(dicionario* dic, int tamanho);
+char* codificaCampoDicionario(char* destino, dicionario* dic, int campo, char* valor, int tamanho);
+char* lerCampoDicionarioMapa(arquivoMapeado* mapa, dicionario* dic, int campo, int* tamanho, int* codigo);
+int lerCampoDicionarioBin(FILE* arquivo, dicionario* dic, int campo, char* destino, int* tamanho);
+
+#endif
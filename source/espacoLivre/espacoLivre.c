@@ -0,0 +1,203 @@
+#include "espacoLivre.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "../estatisticas/estatisticas.h"
+
+/**
+ * Monta o nome do arquivo da lista de espaços livres, que fica ao lado do arquivo de dados
+ * @param destino string onde o nome será salvo
+ * @param nomeArquivoBin nome do arquivo de dados
+ */
+void nomeListaEspacoLivre(char destino[], char* nomeArquivoBin) {
+    sprintf(destino, "%s.livres", nomeArquivoBin);
+}
+
+/**
+ * Cria uma lista de espaços livres vazia
+ * @return ponteiro para a lista criada
+ */
+listaEspacoLivre* criaListaEspacoLivre() {
+    listaEspacoLivre* lista = (listaEspacoLivre*)malloc(sizeof(listaEspacoLivre));
+    lista->quantidade = 0;
+    lista->capacidade = 64;
+    lista->espacos = (espacoLivre*)malloc(lista->capacidade * sizeof(espacoLivre));
+    return lista;
+}
+
+/**
+ * Estado do arquivo de dados guardado no header da lista
+ */
+typedef struct estadoEspacoLivre {
+    long int tamanhoArquivo;
+    long int modificacaoSegundos;
+    long int modificacaoNanossegundos;
+    unsigned long int inode;
+} estadoEspacoLivre;
+
+/**
+ * @param nomeArquivoBin nome do arquivo de dados
+ * @param estado onde o estado atual do arquivo será escrito
+ * @return retorna 1 caso o arquivo exista e 0 caso contrário
+ */
+int estadoArquivoEspacoLivre(char* nomeArquivoBin, estadoEspacoLivre* estado) {
+    struct stat informacoes;
+    if (stat(nomeArquivoBin, &informacoes) != 0) return 0;
+
+    estado->tamanhoArquivo = informacoes.st_size;
+    estado->modificacaoSegundos = informacoes.st_mtim.tv_sec;
+    estado->modificacaoNanossegundos = informacoes.st_mtim.tv_nsec;
+    estado->inode = informacoes.st_ino;
+    return 1;
+}
+
+/**
+ * Carrega a lista de espaços livres salva ao lado do arquivo de dados
+ * @param nomeArquivoLista nome do arquivo da lista
+ * @param nomeArquivoBin nome do arquivo de dados, ainda não alterado
+ * @return ponteiro para a lista ou NULL caso ela não exista ou não corresponda ao arquivo de dados
+ */
+listaEspacoLivre* carregaListaEspacoLivre(char* nomeArquivoLista, char* nomeArquivoBin) {
+    estadoEspacoLivre atual;
+    if (!estadoArquivoEspacoLivre(nomeArquivoBin, &atual)) return NULL;
+
+    FILE* arquivoLista = fopen(nomeArquivoLista, "rb");
+    if (arquivoLista == NULL) return NULL;
+
+    estadoEspacoLivre guardado;
+    int quantidade = -1;
+    int lido = fread(&guardado.tamanhoArquivo, sizeof(long int), 1, arquivoLista) == 1 &&
+               fread(&guardado.modificacaoSegundos, sizeof(long int), 1, arquivoLista) == 1 &&
+               fread(&guardado.modificacaoNanossegundos, sizeof(long int), 1, arquivoLista) == 1 &&
+               fread(&guardado.inode, sizeof(unsigned long int), 1, arquivoLista) == 1 &&
+               fread(&quantidade, sizeof(int), 1, arquivoLista) == 1;
+
+    if (!lido || guardado.tamanhoArquivo != atual.tamanhoArquivo || guardado.modificacaoSegundos != atual.modificacaoSegundos ||
+        guardado.modificacaoNanossegundos != atual.modificacaoNanossegundos || guardado.inode != atual.inode || quantidade < 0) {
+        fclose(arquivoLista);
+        return NULL;
+    }
+
+    listaEspacoLivre* lista = criaListaEspacoLivre();
+    for (int i = 0; i < quantidade; i++) {
+        long int byteOffset;
+        int tamanho;
+        if (fread(&byteOffset, sizeof(long int), 1, arquivoLista) != 1 || fread(&tamanho, sizeof(int), 1, arquivoLista) != 1) {
+            liberaListaEspacoLivre(lista);
+            fclose(arquivoLista);
+            return NULL;
+        }
+        adicionaEspacoLivre(lista, byteOffset, tamanho);
+    }
+
+    fclose(arquivoLista);
+    return lista;
+}
+
+/**
+ * Salva a lista de espaços livres junto do estado atual do arquivo de dados, que já deve estar fechado
+ * @param lista lista a ser salva
+ * @param nomeArquivoLista nome do arquivo da lista
+ * @param nomeArquivoBin nome do arquivo de dados
+ */
+void salvaListaEspacoLivre(listaEspacoLivre* lista, char* nomeArquivoLista, char* nomeArquivoBin) {
+    estadoEspacoLivre atual;
+    if (!estadoArquivoEspacoLivre(nomeArquivoBin, &atual)) return;
+
+    FILE* arquivoLista = fopen(nomeArquivoLista, "wb");
+    if (arquivoLista == NULL) return;
+
+    fwrite(&atual.tamanhoArquivo, sizeof(long int), 1, arquivoLista);
+    fwrite(&atual.modificacaoSegundos, sizeof(long int), 1, arquivoLista);
+    fwrite(&atual.modificacaoNanossegundos, sizeof(long int), 1, arquivoLista);
+    fwrite(&atual.inode, sizeof(unsigned long int), 1, arquivoLista);
+    fwrite(&lista->quantidade, sizeof(int), 1, arquivoLista);
+
+    for (int i = 0; i < lista->quantidade; i++) {
+        fwrite(&lista->espacos[i].byteOffset, sizeof(long int), 1, arquivoLista);
+        fwrite(&lista->espacos[i].tamanho, sizeof(int), 1, arquivoLista);
+    }
+
+    fclose(arquivoLista);
+}
+
+/**
+ * Remove a lista de espaços livres de um arquivo de dados que foi recriado
+ * @param nomeArquivoBin nome do arquivo de dados
+ */
+void removeListaEspacoLivre(char* nomeArquivoBin) {
+    char nomeArquivoLista[256];
+    nomeListaEspacoLivre(nomeArquivoLista, nomeArquivoBin);
+    remove(nomeArquivoLista);
+}
+
+/**
+ * Libera a memória usada pela lista
+ * @param lista lista a ser liberada
+ */
+void liberaListaEspacoLivre(listaEspacoLivre* lista) {
+    free(lista->espacos);
+    free(lista);
+}
+
+/**
+ * Encontra a primeira posição da lista cujo espaço não é menor que o tamanho (busca binária)
+ * @param lista lista ordenada por tamanho e byteOffset
+ * @param tamanho tamanho procurado
+ * @param byteOffset byteOffset usado para desempatar espaços de mesmo tamanho
+ * @return posição encontrada, ou a quantidade de espaços caso todos sejam menores
+ */
+int posicaoEspacoLivre(listaEspacoLivre* lista, int tamanho, long int byteOffset) {
+    int inicio = 0, fim = lista->quantidade;
+    while (inicio < fim) {
+        int meio = (inicio + fim) / 2;
+        espacoLivre* espaco = &lista->espacos[meio];
+        if (espaco->tamanho < tamanho || (espaco->tamanho == tamanho && espaco->byteOffset < byteOffset))
+            inicio = meio + 1;
+        else
+            fim = meio;
+    }
+    return inicio;
+}
+
+/**
+ * Adiciona um espaço livre mantendo a lista ordenada
+ * @param lista lista que receberá o espaço
+ * @param byteOffset inicio do registro removido
+ * @param tamanho tamanhoRegistro do registro removido
+ */
+void adicionaEspacoLivre(listaEspacoLivre* lista, long int byteOffset, int tamanho) {
+    if (lista->quantidade == lista->capacidade) {
+        lista->capacidade *= 2;
+        lista->espacos = (espacoLivre*)realloc(lista->espacos, lista->capacidade * sizeof(espacoLivre));
+    }
+
+    int posicao = posicaoEspacoLivre(lista, tamanho, byteOffset);
+    memmove(&lista->espacos[posicao + 1], &lista->espacos[posicao], (lista->quantidade - posicao) * sizeof(espacoLivre));
+
+    lista->espacos[posicao].byteOffset = byteOffset;
+    lista->espacos[posicao].tamanho = tamanho;
+    lista->quantidade++;
+}
+
+/**
+ * Retira da lista o menor espaço onde um registro cabe (melhor encaixe)
+ * @param lista lista de espaços livres
+ * @param tamanhoNecessario tamanhoRegistro do registro que será salvo
+ * @param byteOffset variável onde o inicio do espaço será salvo
+ * @param tamanho variável onde o tamanho do espaço será salvo
+ * @return retorna 1 caso exista um espaço grande o bastante e 0 caso contrário
+ */
+int retiraMelhorEspaco(listaEspacoLivre* lista, int tamanhoNecessario, long int* byteOffset, int* tamanho) {
+    int posicao = posicaoEspacoLivre(lista, tamanhoNecessario, -1);
+    if (posicao == lista->quantidade) return 0;
+
+    *byteOffset = lista->espacos[posicao].byteOffset;
+    *tamanho = lista->espacos[posicao].tamanho;
+
+    lista->quantidade--;
+    memmove(&lista->espacos[posicao], &lista->espacos[posicao + 1], (lista->quantidade - posicao) * sizeof(espacoLivre));
+    return 1;
+}
@@ -0,0 +1,35 @@
+#ifndef _ESPACO_LIVRE_H_
+#define _ESPACO_LIVRE_H_
+
+#include <stdio.h>
+
+/**
+ * Espaço ocupado por um registro removido, tamanho segue a convenção do campo tamanhoRegistro
+ * (bytes depois do removido e do próprio tamanho)
+ */
+typedef struct espacoLivre {
+    long int byteOffset;
+    int tamanho;
+} espacoLivre;
+
+/**
+ * Lista dos espaços livres de um arquivo de dados, ordenada por tamanho para a escolha do melhor encaixe
+ * no arquivo (ao lado do arquivo de dados) também são guardados tamanho, data de modificação e inode do arquivo
+ * de dados de quando a lista foi salva, se o arquivo mudar por outro caminho a lista é descartada e remontada
+ */
+typedef struct listaEspacoLivre {
+    espacoLivre* espacos;
+    int quantidade;
+    int capacidade;
+} listaEspacoLivre;
+
+void nomeListaEspacoLivre(char destino[], char* nomeArquivoBin);
+listaEspacoLivre* criaListaEspacoLivre();
+listaEspacoLivre* carregaListaEspacoLivre(char* nomeArquivoLista, char* nomeArquivoBin);
+void salvaListaEspacoLivre(listaEspacoLivre* lista, char* nomeArquivoLista, char* nomeArquivoBin);
+void removeListaEspacoLivre(char* nomeArquivoBin);
+void liberaListaEspacoLivre(listaEspacoLivre* lista);
+void adicionaEspacoLivre(listaEspacoLivre* lista, long int byteOffset, int tamanho);
+int retiraMelhorEspaco(listaEspacoLivre* lista, int tamanhoNecessario, long int* byteOffset, int* tamanho);
+
+#endif
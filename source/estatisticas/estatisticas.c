@@ -0,0 +1,175 @@
+#define _ESTATISTICAS_IMPLEMENTACAO_
+#include "estatisticas.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../soma/soma.h"
+
+/**
+ * Tempo de parede de uma fase, profundidade indica quantas fases a envolvem
+ */
+typedef struct fase {
+    char nome[64];
+    int profundidade;
+    struct timespec inicio;
+    double segundos;
+} fase;
+
+contadores estatisticas = {0};
+
+fase fases[MAXIMO_FASES];
+int nroFases = 0;
+int fasesAbertas[PROFUNDIDADE_MAXIMA_FASES];
+int nroFasesAbertas = 0;
+struct timespec inicioExecucao;
+
+size_t freadContado(void* dados, size_t tamanho, size_t quantidade, FILE* arquivo) {
+    size_t lidos = fread(dados, tamanho, quantidade, arquivo);
+    CONTA(chamadasLeitura, 1);
+    CONTA(bytesLidos, (long int)(lidos * tamanho));
+    return lidos;
+}
+
+size_t fwriteContado(const void* dados, size_t tamanho, size_t quantidade, FILE* arquivo) {
+    registraEscritaSoma(arquivo, (long int)(tamanho * quantidade));
+    size_t escritos = fwrite(dados, tamanho, quantidade, arquivo);
+    CONTA(chamadasEscrita, 1);
+    CONTA(bytesEscritos, (long int)(escritos * tamanho));
+    return escritos;
+}
+
+int fseekContado(FILE* arquivo, long int deslocamento, int origem) {
+    CONTA(chamadasPosicionamento, 1);
+    return fseek(arquivo, deslocamento, origem);
+}
+
+FILE* fopenContado(const char* nomeArquivo, const char* modo) {
+    FILE* arquivo = fopen(nomeArquivo, modo);
+    registraAberturaSoma(arquivo, nomeArquivo, modo);
+    return arquivo;
+}
+
+int fcloseContado(FILE* arquivo) {
+    registraFechamentoSoma(arquivo);
+    return fclose(arquivo);
+}
+
+/**
+ * @param inicio instante inicial
+ * @return segundos passados desde o instante inicial
+ */
+double segundosDesde(struct timespec* inicio) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (agora.tv_sec - inicio->tv_sec) + (agora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+/**
+ * Guarda a altura de uma arvore usada na execução, o relatório mostra a maior delas
+ * @param altura quantidade de niveis da arvore
+ */
+void registraAlturaArvore(int altura) {
+    if (altura > estatisticas.alturaArvore) estatisticas.alturaArvore = altura;
+}
+
+/**
+ * Começa a medir o tempo de uma fase, que termina no próximo encerraFase
+ * @param nome nome da fase no relatório
+ */
+void iniciaFase(char* nome) {
+    if (nroFasesAbertas == PROFUNDIDADE_MAXIMA_FASES) return;
+    if (nroFases == MAXIMO_FASES) {
+        fasesAbertas[nroFasesAbertas++] = -1;
+        return;
+    }
+
+    fase* novaFase = &fases[nroFases];
+    strncpy(novaFase->nome, nome, sizeof(novaFase->nome) - 1);
+    novaFase->nome[sizeof(novaFase->nome) - 1] = '\0';
+    novaFase->profundidade = nroFasesAbertas;
+    novaFase->segundos = 0;
+    clock_gettime(CLOCK_MONOTONIC, &novaFase->inicio);
+
+    fasesAbertas[nroFasesAbertas++] = nroFases++;
+}
+
+/**
+ * Encerra a fase aberta mais recentemente
+ */
+void encerraFase() {
+    if (nroFasesAbertas == 0) return;
+
+    int posicao = fasesAbertas[--nroFasesAbertas];
+    if (posicao != -1) fases[posicao].segundos = segundosDesde(&fases[posicao].inicio);
+}
+
+/**
+ * Escreve o relatório em JSON
+ * @param saida arquivo de destino
+ */
+void escreveEstatisticas(FILE* saida) {
+    contadores* c = &estatisticas;
+
+    fprintf(saida, "{\n");
+    fprintf(saida, "  \"segundos\": %.6f,\n", segundosDesde(&inicioExecucao));
+    fprintf(saida, "  \"chamadasFread\": %ld,\n  \"bytesLidos\": %ld,\n", c->chamadasLeitura, c->bytesLidos);
+    fprintf(saida, "  \"chamadasFwrite\": %ld,\n  \"bytesEscritos\": %ld,\n", c->chamadasEscrita, c->bytesEscritos);
+    fprintf(saida, "  \"chamadasFseek\": %ld,\n  \"bytesMapeados\": %ld,\n", c->chamadasPosicionamento, c->bytesMapeados);
+    fprintf(saida, "  \"nosLidos\": %ld,\n  \"nosLidosDisco\": %ld,\n", c->nosLidos, c->nosLidosDisco);
+    fprintf(saida, "  \"nosSalvos\": %ld,\n  \"nosSalvosDisco\": %ld,\n", c->nosSalvos, c->nosSalvosDisco);
+    fprintf(saida, "  \"splits\": %ld,\n  \"alturaArvore\": %d,\n", c->splits, c->alturaArvore);
+    fprintf(saida, "  \"registrosLidos\": %ld,\n  \"registrosCSV\": %ld,\n", c->registrosLidos, c->registrosCSV);
+    fprintf(saida, "  \"registrosDevolvidos\": %ld,\n  \"blocosDescartados\": %ld,\n", c->registrosDevolvidos,
+            c->blocosDescartados);
+
+    // fases ainda abertas (por exemplo quando o programa termina no meio de um comando) vão até agora
+    for (int i = 0; i < nroFasesAbertas; i++)
+        if (fasesAbertas[i] != -1) fases[fasesAbertas[i]].segundos = segundosDesde(&fases[fasesAbertas[i]].inicio);
+
+    fprintf(saida, "  \"fases\": [");
+    for (int i = 0; i < nroFases; i++) {
+        fprintf(saida, "%s\n    {\"nome\": \"%s\", \"profundidade\": %d, \"segundos\": %.6f}", i ? "," : "",
+                fases[i].nome, fases[i].profundidade, fases[i].segundos);
+    }
+    fprintf(saida, "%s]\n}\n", nroFases ? "\n  " : "");
+}
+
+/**
+ * @return 1 caso o relatório vá ser escrito ao fim do programa
+ */
+int estatisticasAtivas() {
+    char* destino = getenv("ESTATISTICAS");
+    return destino != NULL && destino[0] != '\0';
+}
+
+/**
+ * Escreve o relatório no destino configurado pela variável ESTATISTICAS, chamada ao fim do programa
+ */
+void relataEstatisticas() {
+    char* destino = getenv("ESTATISTICAS");
+
+    if (strcmp(destino, "1") == 0) {
+        escreveEstatisticas(stderr);
+        return;
+    }
+
+    FILE* arquivo = fopen(destino, "w");
+    if (arquivo == NULL) {
+        fprintf(stderr, "Falha ao escrever as estatisticas em %s\n", destino);
+        return;
+    }
+    escreveEstatisticas(arquivo);
+    fclose(arquivo);
+}
+
+/**
+ * Começa a medir a execução e, caso a variável ESTATISTICAS esteja definida, agenda o relatório para o fim do programa
+ */
+void iniciaEstatisticas() {
+    clock_gettime(CLOCK_MONOTONIC, &inicioExecucao);
+
+    if (estatisticasAtivas()) atexit(relataEstatisticas);
+}
@@ -0,0 +1,69 @@
+#ifndef _ESTATISTICAS_H_
+#define _ESTATISTICAS_H_
+#include <stdio.h>
+
+#define MAXIMO_FASES 64             // fases guardadas por execução, as demais são ignoradas
+#define PROFUNDIDADE_MAXIMA_FASES 8  // fases abertas ao mesmo tempo (uma dentro da outra)
+
+/**
+ * Contadores de uma execução do programa
+ * São sempre contados e apenas relatados quando a variável de ambiente ESTATISTICAS está definida:
+ * ESTATISTICAS=1 escreve o relatório em JSON na saída de erro, qualquer outro valor é usado como nome
+ * do arquivo JSON. A saída padrão nunca é alterada
+ */
+typedef struct contadores {
+    long int chamadasLeitura;  // fread
+    long int bytesLidos;
+    long int chamadasEscrita;  // fwrite
+    long int bytesEscritos;
+    long int chamadasPosicionamento;  // fseek
+    long int bytesMapeados;           // arquivos lidos por mmap não passam pelo fread
+
+    long int nosLidos;         // leituras de nós da arvore B, inclusive as resolvidas pelo buffer
+    long int nosLidosDisco;    // leituras que foram ao disco
+    long int nosSalvos;        // escritas de nós da arvore B, inclusive as que ficaram no buffer
+    long int nosSalvosDisco;   // escritas que foram ao disco
+    long int splits;
+    int alturaArvore;          // maior altura entre as arvores usadas
+
+    long int registrosLidos;      // registros lidos dos arquivos binários
+    long int registrosCSV;        // registros lidos dos CSVs
+    long int registrosDevolvidos; // registros impressos como resultado
+    long int blocosDescartados;   // blocos de dados pulados pelo mapa de zonas
+} contadores;
+
+extern contadores estatisticas;
+
+#define CONTA(campo, valor) (estatisticas.campo += (valor))
+
+/**
+ * Incrementa um contador que também é alterado pelas threads da carga paralela
+ */
+#define CONTA_CONCORRENTE(campo, valor) __atomic_fetch_add(&estatisticas.campo, (valor), __ATOMIC_RELAXED)
+
+size_t freadContado(void* dados, size_t tamanho, size_t quantidade, FILE* arquivo);
+size_t fwriteContado(const void* dados, size_t tamanho, size_t quantidade, FILE* arquivo);
+int fseekContado(FILE* arquivo, long int deslocamento, int origem);
+FILE* fopenContado(const char* nomeArquivo, const char* modo);
+int fcloseContado(FILE* arquivo);
+
+void iniciaEstatisticas();
+int estatisticasAtivas();
+void registraAlturaArvore(int altura);
+void iniciaFase(char* nome);
+void encerraFase();
+
+/*
+ * Os módulos incluem este header depois dos headers do sistema, assim toda leitura, escrita e
+ * posicionamento feito por eles passa pelas versões contadas. Abertura, fechamento e escrita também
+ * avisam o módulo soma, que acompanha as páginas alteradas de cada arquivo
+ */
+#ifndef _ESTATISTICAS_IMPLEMENTACAO_
+#define fread(dados, tamanho, quantidade, arquivo) freadContado(dados, tamanho, quantidade, arquivo)
+#define fwrite(dados, tamanho, quantidade, arquivo) fwriteContado(dados, tamanho, quantidade, arquivo)
+#define fseek(arquivo, deslocamento, origem) fseekContado(arquivo, deslocamento, origem)
+#define fopen(nomeArquivo, modo) fopenContado(nomeArquivo, modo)
+#define fclose(arquivo) fcloseContado(arquivo)
+#endif
+
+#endif
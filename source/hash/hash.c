@@ -0,0 +1,138 @@
+#include "hash.h"
+
+#include <stdlib.h>
+
+/**
+ * Mistura os bits de uma chave para que chaves próximas fiquem distantes na tabela
+ * @param chave chave original
+ * @return valor de hash da chave
+ */
+unsigned int espalhaChave(int chave) {
+    unsigned int h = (unsigned int)chave;
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+/**
+ * Calcula o hash (FNV-1a) de uma string que não é necessariamente terminada em \0
+ * @param valor inicio da string
+ * @param tamanho quantidade de bytes da string
+ * @return valor de hash da string
+ */
+unsigned int espalhaString(char* valor, int tamanho) {
+    unsigned int h = 2166136261U;
+    for (int i = 0; i < tamanho; i++) {
+        h ^= (unsigned char)valor[i];
+        h *= 16777619U;
+    }
+    return h;
+}
+
+/**
+ * Aloca as posições de uma tabela vazia
+ * @param tabela tabela que receberá as posições
+ * @param capacidade quantidade de posições, potência de 2
+ */
+void alocaPosicoesHash(tabelaHash* tabela, int capacidade) {
+    tabela->capacidade = capacidade;
+    tabela->quantidade = 0;
+    tabela->chaves = (int*)malloc(capacidade * sizeof(int));
+    tabela->valores = (long int*)malloc(capacidade * sizeof(long int));
+    tabela->ocupado = (char*)malloc(capacidade * sizeof(char));
+    for (int i = 0; i < capacidade; i++) tabela->ocupado[i] = '0';
+}
+
+/**
+ * Cria uma tabela hash vazia
+ * @param quantidadeEsperada quantidade de chaves que deve ser inserida, usada para evitar redimensionamentos
+ * @return ponteiro para a tabela criada
+ */
+tabelaHash* criaTabelaHash(int quantidadeEsperada) {
+    tabelaHash* tabela = (tabelaHash*)malloc(sizeof(tabelaHash));
+
+    int capacidade = CAPACIDADE_INICIAL_HASH;
+    while (capacidade < 2 * quantidadeEsperada) capacidade *= 2;  // mantém no máximo metade ocupada
+
+    alocaPosicoesHash(tabela, capacidade);
+    return tabela;
+}
+
+/**
+ * Encontra a posição da chave ou a posição livre onde ela deve ficar
+ * @param tabela tabela onde a busca ocorrerá
+ * @param chave chave buscada
+ * @return indice da posição
+ */
+int posicaoTabelaHash(tabelaHash* tabela, int chave) {
+    int posicao = espalhaChave(chave) & (tabela->capacidade - 1);
+    while (tabela->ocupado[posicao] == '1' && tabela->chaves[posicao] != chave) {
+        posicao = (posicao + 1) & (tabela->capacidade - 1);
+    }
+    return posicao;
+}
+
+/**
+ * Dobra a capacidade da tabela reinserindo todas as chaves
+ * @param tabela tabela a ser redimensionada
+ */
+void redimensionaTabelaHash(tabelaHash* tabela) {
+    int* chaves = tabela->chaves;
+    long int* valores = tabela->valores;
+    char* ocupado = tabela->ocupado;
+    int capacidade = tabela->capacidade;
+
+    alocaPosicoesHash(tabela, capacidade * 2);
+    for (int i = 0; i < capacidade; i++) {
+        if (ocupado[i] == '1') insereTabelaHash(tabela, chaves[i], valores[i]);
+    }
+
+    free(chaves);
+    free(valores);
+    free(ocupado);
+}
+
+/**
+ * Insere uma chave na tabela, caso ela já exista o valor antigo é mantido
+ * @param tabela tabela onde a chave será inserida
+ * @param chave chave a ser inserida
+ * @param valor valor associado à chave
+ * @return retorna 1 caso a chave tenha sido inserida e 0 caso já existisse
+ */
+int insereTabelaHash(tabelaHash* tabela, int chave, long int valor) {
+    if (2 * (tabela->quantidade + 1) > tabela->capacidade) redimensionaTabelaHash(tabela);
+
+    int posicao = posicaoTabelaHash(tabela, chave);
+    if (tabela->ocupado[posicao] == '1') return 0;
+
+    tabela->ocupado[posicao] = '1';
+    tabela->chaves[posicao] = chave;
+    tabela->valores[posicao] = valor;
+    tabela->quantidade++;
+    return 1;
+}
+
+/**
+ * Busca o valor associado a uma chave
+ * @param tabela tabela onde a busca ocorrerá
+ * @param chave chave buscada
+ * @return retorna o valor associado ou -1 caso a chave não exista
+ */
+long int buscaTabelaHash(tabelaHash* tabela, int chave) {
+    int posicao = posicaoTabelaHash(tabela, chave);
+    return (tabela->ocupado[posicao] == '1') ? tabela->valores[posicao] : -1;
+}
+
+/**
+ * Libera a memória usada pela tabela
+ * @param tabela tabela a ser liberada
+ */
+void liberaTabelaHash(tabelaHash* tabela) {
+    free(tabela->chaves);
+    free(tabela->valores);
+    free(tabela->ocupado);
+    free(tabela);
+}
@@ -0,0 +1,26 @@
+#ifndef _HASH_H_
+#define _HASH_H_
+
+#define CAPACIDADE_INICIAL_HASH 1024  // quantidade inicial de posições da tabela, sempre potência de 2
+#define MEMORIA_JUNCAO_HASH 67108864L  // memória padrão (64 MiB) da tabela antes da junção particionar os arquivos
+#define MAXIMO_PARTICOES_JUNCAO 128    // cada partição mantém dois arquivos temporários abertos durante a junção
+
+/**
+ * Tabela hash com endereçamento aberto (sondagem linear) que associa uma chave inteira a um byteOffset
+ */
+typedef struct tabelaHash {
+    int* chaves;
+    long int* valores;
+    char* ocupado;  // '1' caso a posição esteja ocupada
+    int capacidade;
+    int quantidade;
+} tabelaHash;
+
+tabelaHash* criaTabelaHash(int quantidadeEsperada);
+int insereTabelaHash(tabelaHash* tabela, int chave, long int valor);
+long int buscaTabelaHash(tabelaHash* tabela, int chave);
+void liberaTabelaHash(tabelaHash* tabela);
+unsigned int espalhaChave(int chave);
+unsigned int espalhaString(char* valor, int tamanho);
+
+#endif
@@ -0,0 +1,467 @@
+#include "hashLinear.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "../estatisticas/estatisticas.h"
+
+#include "../hash/hash.h"
+
+/**
+ * Monta o nome do indice hash de um campo, que fica ao lado do arquivo de dados
+ * @param destino string onde o nome será salvo, com espaço para os dois nomes
+ * @param nomeArquivoBin nome do arquivo de dados
+ * @param campo nome do campo indexado
+ */
+void nomeHashLinear(char destino[], char* nomeArquivoBin, char* campo) {
+    sprintf(destino, "%s.%s.hash", nomeArquivoBin, campo);
+}
+
+/**
+ * Monta o nome do arquivo que guarda o estado do arquivo de dados de um indice, fica ao lado do indice
+ * para que o conteúdo do indice dependa apenas dos registros indexados
+ * @param destino string onde o nome será salvo
+ * @param nomeArquivoIndice nome do arquivo do indice
+ */
+void nomeEstadoHashLinear(char destino[], char* nomeArquivoIndice) {
+    sprintf(destino, "%s.estado", nomeArquivoIndice);
+}
+
+/**
+ * Remove o indice hash de um campo, usado sempre que o arquivo de dados é alterado
+ * @param nomeArquivoBin nome do arquivo de dados
+ * @param campo nome do campo indexado
+ */
+void removeHashLinear(char* nomeArquivoBin, char* campo) {
+    char nomeIndice[256], nomeEstado[270];
+    nomeHashLinear(nomeIndice, nomeArquivoBin, campo);
+    nomeEstadoHashLinear(nomeEstado, nomeIndice);
+    remove(nomeIndice);
+    remove(nomeEstado);
+}
+
+/**
+ * Estado do arquivo de dados quando o indice foi construido
+ */
+typedef struct estadoHashLinear {
+    long int tamanhoArquivo;
+    long int modificacaoSegundos;
+    long int modificacaoNanossegundos;
+    unsigned long int inode;
+} estadoHashLinear;
+
+/**
+ * @param nomeArquivoBin nome do arquivo de dados
+ * @param estado onde o estado atual do arquivo será escrito
+ * @return retorna 1 caso o arquivo exista e 0 caso contrário
+ */
+int estadoArquivoHashLinear(char* nomeArquivoBin, estadoHashLinear* estado) {
+    struct stat informacoes;
+    if (stat(nomeArquivoBin, &informacoes) != 0) return 0;
+
+    estado->tamanhoArquivo = informacoes.st_size;
+    estado->modificacaoSegundos = informacoes.st_mtim.tv_sec;
+    estado->modificacaoNanossegundos = informacoes.st_mtim.tv_nsec;
+    estado->inode = informacoes.st_ino;
+    return 1;
+}
+
+/**
+ * Confere se o arquivo de dados está no mesmo estado guardado ao lado do indice
+ * @param nomeArquivoIndice nome do arquivo do indice
+ * @param nomeArquivoBin nome do arquivo de dados
+ * @return retorna 1 caso o indice corresponda ao arquivo de dados e 0 caso contrário
+ */
+int confereEstadoHashLinear(char* nomeArquivoIndice, char* nomeArquivoBin) {
+    estadoHashLinear atual;
+    if (!estadoArquivoHashLinear(nomeArquivoBin, &atual)) return 0;
+
+    char nomeEstado[270];
+    nomeEstadoHashLinear(nomeEstado, nomeArquivoIndice);
+    FILE* arquivoEstado = fopen(nomeEstado, "rb");
+    if (arquivoEstado == NULL) return 0;
+
+    estadoHashLinear guardado;
+    int lido = fread(&guardado.tamanhoArquivo, sizeof(long int), 1, arquivoEstado) == 1 &&
+               fread(&guardado.modificacaoSegundos, sizeof(long int), 1, arquivoEstado) == 1 &&
+               fread(&guardado.modificacaoNanossegundos, sizeof(long int), 1, arquivoEstado) == 1 &&
+               fread(&guardado.inode, sizeof(unsigned long int), 1, arquivoEstado) == 1;
+    fclose(arquivoEstado);
+
+    return lido && guardado.tamanhoArquivo == atual.tamanhoArquivo && guardado.modificacaoSegundos == atual.modificacaoSegundos &&
+           guardado.modificacaoNanossegundos == atual.modificacaoNanossegundos && guardado.inode == atual.inode;
+}
+
+/**
+ * Salva ao lado do indice o estado atual do arquivo de dados
+ * @param nomeArquivoIndice nome do arquivo do indice
+ * @param nomeArquivoBin nome do arquivo de dados, já fechado
+ */
+void salvaEstadoHashLinear(char* nomeArquivoIndice, char* nomeArquivoBin) {
+    estadoHashLinear atual;
+    if (!estadoArquivoHashLinear(nomeArquivoBin, &atual)) return;
+
+    char nomeEstado[270];
+    nomeEstadoHashLinear(nomeEstado, nomeArquivoIndice);
+    FILE* arquivoEstado = fopen(nomeEstado, "wb");
+    if (arquivoEstado == NULL) return;
+
+    fwrite(&atual.tamanhoArquivo, sizeof(long int), 1, arquivoEstado);
+    fwrite(&atual.modificacaoSegundos, sizeof(long int), 1, arquivoEstado);
+    fwrite(&atual.modificacaoNanossegundos, sizeof(long int), 1, arquivoEstado);
+    fwrite(&atual.inode, sizeof(unsigned long int), 1, arquivoEstado);
+    fclose(arquivoEstado);
+}
+
+/**
+ * Salva o header do indice na primeira página do arquivo
+ * @param indice indice que terá seu header salvo
+ */
+void salvaHeaderHashLinear(hashLinear* indice) {
+    char pagina[TAMANHO_PAGINA_HASH];
+    memset(pagina, '@', TAMANHO_PAGINA_HASH);
+    char* atual = pagina;
+
+    *atual++ = indice->header.status;
+    memcpy(atual, &indice->header.nivel, sizeof(int));
+    atual += sizeof(int);
+    memcpy(atual, &indice->header.proximoBalde, sizeof(int));
+    atual += sizeof(int);
+    memcpy(atual, &indice->header.nroBaldes, sizeof(int));
+    atual += sizeof(int);
+    memcpy(atual, &indice->header.nroEntradas, sizeof(int));
+    atual += sizeof(int);
+    memcpy(atual, &indice->header.nroPaginas, sizeof(int));
+
+    fseek(indice->arquivoIndice, 0, 0);
+    fwrite(pagina, sizeof(char), TAMANHO_PAGINA_HASH, indice->arquivoIndice);
+}
+
+/**
+ * Le o header do indice a partir da primeira página do arquivo
+ * @param indice indice que terá seu header lido
+ * @return retorna 1 caso a página tenha sido lida por completo e 0 caso contrário
+ */
+int leHeaderHashLinear(hashLinear* indice) {
+    char pagina[TAMANHO_PAGINA_HASH];
+
+    fseek(indice->arquivoIndice, 0, 0);
+    if (fread(pagina, sizeof(char), TAMANHO_PAGINA_HASH, indice->arquivoIndice) != TAMANHO_PAGINA_HASH) return 0;
+    char* atual = pagina;
+
+    indice->header.status = *atual++;
+    memcpy(&indice->header.nivel, atual, sizeof(int));
+    atual += sizeof(int);
+    memcpy(&indice->header.proximoBalde, atual, sizeof(int));
+    atual += sizeof(int);
+    memcpy(&indice->header.nroBaldes, atual, sizeof(int));
+    atual += sizeof(int);
+    memcpy(&indice->header.nroEntradas, atual, sizeof(int));
+    atual += sizeof(int);
+    memcpy(&indice->header.nroPaginas, atual, sizeof(int));
+
+    return 1;
+}
+
+/**
+ * Le uma página do arquivo
+ * @param indice indice dono da página
+ * @param pagina variável onde a página será salva
+ * @param RRN RRN da página
+ */
+void lerPaginaHash(hashLinear* indice, paginaHash* pagina, int RRN) {
+    char dados[TAMANHO_PAGINA_HASH];
+
+    memset(dados, 0, TAMANHO_PAGINA_HASH);
+    fseek(indice->arquivoIndice, (long int)(RRN + 1) * TAMANHO_PAGINA_HASH, 0);
+    fread(dados, sizeof(char), TAMANHO_PAGINA_HASH, indice->arquivoIndice);
+    char* atual = dados;
+
+    memcpy(&pagina->nroEntradas, atual, sizeof(int));
+    atual += sizeof(int);
+    memcpy(&pagina->proximaPagina, atual, sizeof(int));
+    atual += sizeof(int);
+
+    for (int i = 0; i < pagina->nroEntradas; i++) {
+        memcpy(&pagina->hashes[i], atual, sizeof(int));
+        atual += sizeof(int);
+        memcpy(&pagina->byteOffsets[i], atual, sizeof(long int));
+        atual += sizeof(long int);
+    }
+}
+
+/**
+ * Salva uma página no arquivo, o espaço das entradas não usadas é preenchido com '@'
+ * @param indice indice dono da página
+ * @param pagina página a ser salva
+ * @param RRN RRN da página
+ */
+void salvaPaginaHash(hashLinear* indice, paginaHash* pagina, int RRN) {
+    char dados[TAMANHO_PAGINA_HASH];
+    memset(dados, '@', TAMANHO_PAGINA_HASH);
+    char* atual = dados;
+
+    memcpy(atual, &pagina->nroEntradas, sizeof(int));
+    atual += sizeof(int);
+    memcpy(atual, &pagina->proximaPagina, sizeof(int));
+    atual += sizeof(int);
+
+    for (int i = 0; i < pagina->nroEntradas; i++) {
+        memcpy(atual, &pagina->hashes[i], sizeof(int));
+        atual += sizeof(int);
+        memcpy(atual, &pagina->byteOffsets[i], sizeof(long int));
+        atual += sizeof(long int);
+    }
+
+    fseek(indice->arquivoIndice, (long int)(RRN + 1) * TAMANHO_PAGINA_HASH, 0);
+    fwrite(dados, sizeof(char), TAMANHO_PAGINA_HASH, indice->arquivoIndice);
+}
+
+/**
+ * Calcula o balde de um hash, os baldes anteriores ao próximo a ser dividido já usam o nível seguinte
+ * @param indice indice onde o hash será procurado
+ * @param hash hash da chave
+ * @return número do balde
+ */
+int baldeDoHash(hashLinear* indice, unsigned int hash) {
+    unsigned int baldesDoNivel = (unsigned int)BALDES_INICIAIS_HASH << indice->header.nivel;
+    unsigned int balde = hash & (baldesDoNivel - 1);
+    if (balde < (unsigned int)indice->header.proximoBalde) balde = hash & (2 * baldesDoNivel - 1);
+    return (int)balde;
+}
+
+/**
+ * Cria um indice hash linear vazio, as entradas inseridas ficam em memória até finalizaHashLinear
+ * @param nomeArquivoIndice nome do arquivo onde o indice será salvo
+ * @return ponteiro para a struct do tipo hashLinear
+ */
+hashLinear* criaHashLinear(char* nomeArquivoIndice) {
+    char nomeEstado[270];
+    nomeEstadoHashLinear(nomeEstado, nomeArquivoIndice);
+    remove(nomeEstado);  // o estado antigo não vale para o indice que será construido
+
+    hashLinear* indice = (hashLinear*)malloc(sizeof(hashLinear));
+    indice->arquivoIndice = fopen(nomeArquivoIndice, "wb+");
+
+    if (indice->arquivoIndice == NULL) {
+        free(indice);
+        return NULL;
+    }
+    strcpy(indice->nomeArquivoIndice, nomeArquivoIndice);
+
+    indice->header.status = '0';
+    indice->header.nivel = 0;
+    indice->header.proximoBalde = 0;
+    indice->header.nroBaldes = BALDES_INICIAIS_HASH;
+    indice->header.nroEntradas = 0;
+    indice->header.nroPaginas = 0;
+
+    indice->paginaDoBalde = NULL;
+    indice->capacidadeEntradas = ENTRADAS_PAGINA_HASH;
+    indice->hashesEntradas = (unsigned int*)malloc(indice->capacidadeEntradas * sizeof(unsigned int));
+    indice->byteOffsetsEntradas = (long int*)malloc(indice->capacidadeEntradas * sizeof(long int));
+
+    salvaHeaderHashLinear(indice);
+
+    return indice;
+}
+
+/**
+ * Abre um indice hash linear já existente, sem mensagens de erro já que o indice é opcional
+ * @param nomeArquivoIndice nome do arquivo do indice
+ * @param nomeArquivoBin nome do arquivo de dados, que deve estar no mesmo estado de quando o indice foi construido
+ * @return ponteiro para a struct do tipo hashLinear ou NULL caso o indice não exista, esteja inconsistente
+ * ou não corresponda ao arquivo de dados
+ */
+hashLinear* carregaHashLinear(char* nomeArquivoIndice, char* nomeArquivoBin) {
+    if (!confereEstadoHashLinear(nomeArquivoIndice, nomeArquivoBin)) return NULL;
+
+    hashLinear* indice = (hashLinear*)malloc(sizeof(hashLinear));
+    indice->arquivoIndice = fopen(nomeArquivoIndice, "rb");
+
+    if (indice->arquivoIndice == NULL) {
+        free(indice);
+        return NULL;
+    }
+    strcpy(indice->nomeArquivoIndice, nomeArquivoIndice);
+
+    if (!leHeaderHashLinear(indice) || indice->header.status != '1' || indice->header.nroBaldes < BALDES_INICIAIS_HASH) {
+        fclose(indice->arquivoIndice);
+        free(indice);
+        return NULL;
+    }
+
+    indice->paginaDoBalde = (int*)malloc(indice->header.nroBaldes * sizeof(int));
+    indice->hashesEntradas = NULL;
+    indice->byteOffsetsEntradas = NULL;
+    indice->capacidadeEntradas = 0;
+
+    fseek(indice->arquivoIndice, (long int)(indice->header.nroPaginas + 1) * TAMANHO_PAGINA_HASH, 0);
+    int lidos = (int)fread(indice->paginaDoBalde, sizeof(int), indice->header.nroBaldes, indice->arquivoIndice);
+
+    if (lidos != indice->header.nroBaldes) {
+        fechaHashLinear(indice);
+        return NULL;
+    }
+
+    return indice;
+}
+
+/**
+ * Grava as entradas inseridas balde a balde, cada página é escrita uma única vez e as páginas de um
+ * mesmo balde ficam seguidas no arquivo, depois salva o mapa dos baldes e o header com status consistente,
+ * fecha o indice e guarda ao lado dele o estado do arquivo de dados
+ * @param indice indice criado por criaHashLinear a ser finalizado
+ * @param nomeArquivoBin nome do arquivo de dados indexado, já fechado
+ */
+void finalizaHashLinear(hashLinear* indice, char* nomeArquivoBin) {
+    int nroBaldes = indice->header.nroBaldes;
+    int nroEntradas = indice->header.nroEntradas;
+
+    // distribui as entradas pelos baldes finais mantendo a ordem de inserção dentro de cada balde,
+    // o mesmo conteúdo que dividir os baldes já gravados a cada inserção produziria
+    int* balde = (int*)malloc((nroEntradas + 1) * sizeof(int));
+    int* inicioDoBalde = (int*)calloc(nroBaldes + 1, sizeof(int));
+    for (int i = 0; i < nroEntradas; i++) {
+        balde[i] = baldeDoHash(indice, indice->hashesEntradas[i]);
+        inicioDoBalde[balde[i] + 1]++;
+    }
+    for (int b = 0; b < nroBaldes; b++) inicioDoBalde[b + 1] += inicioDoBalde[b];
+
+    int* ordem = (int*)malloc((nroEntradas + 1) * sizeof(int));
+    int* proximaPosicao = (int*)malloc(nroBaldes * sizeof(int));
+    memcpy(proximaPosicao, inicioDoBalde, nroBaldes * sizeof(int));
+    for (int i = 0; i < nroEntradas; i++) ordem[proximaPosicao[balde[i]]++] = i;
+
+    indice->paginaDoBalde = (int*)malloc(nroBaldes * sizeof(int));
+
+    paginaHash pagina;
+    for (int b = 0; b < nroBaldes; b++) {
+        int posicao = inicioDoBalde[b];
+        indice->paginaDoBalde[b] = indice->header.nroPaginas;
+
+        // todo balde tem ao menos uma página, mesmo que vazia
+        do {
+            pagina.nroEntradas = 0;
+            while (posicao < inicioDoBalde[b + 1] && pagina.nroEntradas < ENTRADAS_PAGINA_HASH) {
+                pagina.hashes[pagina.nroEntradas] = indice->hashesEntradas[ordem[posicao]];
+                pagina.byteOffsets[pagina.nroEntradas] = indice->byteOffsetsEntradas[ordem[posicao]];
+                pagina.nroEntradas++;
+                posicao++;
+            }
+
+            int RRN = indice->header.nroPaginas++;
+            pagina.proximaPagina = (posicao < inicioDoBalde[b + 1]) ? indice->header.nroPaginas : -1;
+            salvaPaginaHash(indice, &pagina, RRN);
+        } while (posicao < inicioDoBalde[b + 1]);
+    }
+
+    free(balde);
+    free(inicioDoBalde);
+    free(ordem);
+    free(proximaPosicao);
+
+    fseek(indice->arquivoIndice, (long int)(indice->header.nroPaginas + 1) * TAMANHO_PAGINA_HASH, 0);
+    fwrite(indice->paginaDoBalde, sizeof(int), indice->header.nroBaldes, indice->arquivoIndice);
+
+    indice->header.status = '1';
+    salvaHeaderHashLinear(indice);
+
+    // o nome do indice é guardado antes de fechá-lo, sem o estado o indice nunca é usado
+    char nomeArquivoIndice[256];
+    strcpy(nomeArquivoIndice, indice->nomeArquivoIndice);
+    fechaHashLinear(indice);
+    salvaEstadoHashLinear(nomeArquivoIndice, nomeArquivoBin);
+}
+
+/**
+ * Fecha um indice aberto apenas para leitura, sem alterar o arquivo
+ * @param indice indice a ser fechado
+ */
+void fechaHashLinear(hashLinear* indice) {
+    fclose(indice->arquivoIndice);
+    free(indice->paginaDoBalde);
+    free(indice->hashesEntradas);
+    free(indice->byteOffsetsEntradas);
+    free(indice);
+}
+
+/**
+ * Insere um valor em um indice criado por criaHashLinear, dividindo um balde caso a ocupação passe do limite
+ * a entrada fica em memória e só é gravada no seu balde por finalizaHashLinear, então uma divisão
+ * altera apenas o nível e o próximo balde a ser dividido
+ * @param indice indice que receberá a entrada
+ * @param valor valor do campo, não necessariamente terminado em \0
+ * @param tamanho quantidade de bytes do valor
+ * @param byteOffset byteOffset do registro que contém o valor
+ */
+void insereHashLinear(hashLinear* indice, char* valor, int tamanho, long int byteOffset) {
+    if (indice->header.nroEntradas == indice->capacidadeEntradas) {
+        indice->capacidadeEntradas *= 2;
+        indice->hashesEntradas = (unsigned int*)realloc(indice->hashesEntradas, indice->capacidadeEntradas * sizeof(unsigned int));
+        indice->byteOffsetsEntradas = (long int*)realloc(indice->byteOffsetsEntradas, indice->capacidadeEntradas * sizeof(long int));
+    }
+
+    indice->hashesEntradas[indice->header.nroEntradas] = espalhaString(valor, tamanho);
+    indice->byteOffsetsEntradas[indice->header.nroEntradas] = byteOffset;
+    indice->header.nroEntradas++;
+
+    if (indice->header.nroEntradas > CARGA_MAXIMA_HASH * indice->header.nroBaldes * ENTRADAS_PAGINA_HASH) {
+        indice->header.nroBaldes++;
+        indice->header.proximoBalde++;
+        if (indice->header.proximoBalde == BALDES_INICIAIS_HASH << indice->header.nivel) {
+            indice->header.nivel++;
+            indice->header.proximoBalde = 0;
+        }
+    }
+}
+
+/**
+ * Compara dois byteOffsets
+ * @param a primeiro byteOffset
+ * @param b segundo byteOffset
+ * @return retorna um valor negativo, zero ou positivo caso A seja menor, igual ou maior que B
+ */
+int compararByteOffsets(const void* a, const void* b) {
+    long int offsetA = *(long int*)a;
+    long int offsetB = *(long int*)b;
+    return (offsetA > offsetB) - (offsetA < offsetB);
+}
+
+/**
+ * Busca os registros candidatos a conter um valor, como o indice guarda apenas o hash
+ * o chamador ainda deve comparar o campo de cada registro com o valor
+ * @param indice indice onde a busca ocorrerá
+ * @param valor valor buscado
+ * @param tamanho quantidade de bytes do valor
+ * @param quantidade variável onde a quantidade de candidatos será salva
+ * @return array alocado com os byteOffsets dos candidatos em ordem crescente
+ */
+long int* buscaHashLinear(hashLinear* indice, char* valor, int tamanho, int* quantidade) {
+    unsigned int hash = espalhaString(valor, tamanho);
+
+    int capacidade = ENTRADAS_PAGINA_HASH;
+    long int* byteOffsets = (long int*)malloc(capacidade * sizeof(long int));
+    *quantidade = 0;
+
+    paginaHash pagina;
+    int RRNatual = indice->paginaDoBalde[baldeDoHash(indice, hash)];
+    while (RRNatual != -1) {
+        lerPaginaHash(indice, &pagina, RRNatual);
+
+        for (int i = 0; i < pagina.nroEntradas; i++) {
+            if (pagina.hashes[i] != hash) continue;
+
+            if (*quantidade == capacidade) {
+                capacidade *= 2;
+                byteOffsets = (long int*)realloc(byteOffsets, capacidade * sizeof(long int));
+            }
+            byteOffsets[(*quantidade)++] = pagina.byteOffsets[i];
+        }
+        RRNatual = pagina.proximaPagina;
+    }
+
+    qsort(byteOffsets, *quantidade, sizeof(long int), compararByteOffsets);
+    return byteOffsets;
+}
@@ -0,0 +1,56 @@
+#ifndef _HASH_LINEAR_H_
+#define _HASH_LINEAR_H_
+
+#include <stdio.h>
+
+#define TAMANHO_PAGINA_HASH 4096                               // tamanho do header e de cada página do arquivo
+#define ENTRADAS_PAGINA_HASH ((TAMANHO_PAGINA_HASH - 8) / 12)  // entradas (hash, byteOffset) que cabem em uma página
+#define BALDES_INICIAIS_HASH 4                                 // quantidade de baldes do nível 0, potência de 2
+#define CARGA_MAXIMA_HASH 0.75                                 // ocupação média dos baldes que provoca uma divisão
+
+/**
+ * Header do indice hash linear, ocupa a primeira página do arquivo
+ * o indice não é atualizado junto do arquivo de dados, toda operação que escreve no arquivo remove os seus indices,
+ * e o arquivo .estado ao lado do indice guarda o tamanho, a modificação e o inode do arquivo de dados quando o indice
+ * foi construido, então um arquivo alterado ou substituido por outro caminho também faz o indice deixar de ser usado
+ * depois da última página fica o RRN da primeira página de cada balde
+ */
+typedef struct hashLinearHeader {
+    char status;
+    int nivel;
+    int proximoBalde;  // próximo balde a ser dividido
+    int nroBaldes;
+    int nroEntradas;
+    int nroPaginas;
+} hashLinearHeader;
+
+/**
+ * Página de um balde, os baldes com mais entradas do que cabem em uma página são encadeados
+ */
+typedef struct paginaHash {
+    int nroEntradas;
+    int proximaPagina;
+    unsigned int hashes[ENTRADAS_PAGINA_HASH];
+    long int byteOffsets[ENTRADAS_PAGINA_HASH];
+} paginaHash;
+
+typedef struct hashLinear {
+    FILE* arquivoIndice;
+    char nomeArquivoIndice[256];
+    hashLinearHeader header;
+    int* paginaDoBalde;  // RRN da primeira página de cada balde
+    unsigned int* hashesEntradas;  // entradas de um indice em construção, na ordem de inserção
+    long int* byteOffsetsEntradas;
+    int capacidadeEntradas;
+} hashLinear;
+
+void nomeHashLinear(char destino[], char* nomeArquivoBin, char* campo);
+void removeHashLinear(char* nomeArquivoBin, char* campo);
+hashLinear* criaHashLinear(char* nomeArquivoIndice);
+hashLinear* carregaHashLinear(char* nomeArquivoIndice, char* nomeArquivoBin);
+void finalizaHashLinear(hashLinear* indice, char* nomeArquivoBin);
+void fechaHashLinear(hashLinear* indice);
+void insereHashLinear(hashLinear* indice, char* valor, int tamanho, long int byteOffset);
+long int* buscaHashLinear(hashLinear* indice, char* valor, int tamanho, int* quantidade);
+
+#endif
@@ -6,12 +6,25 @@
 
 #include "../arvore/arvore.h"
 #include "../binario/binario.h"
+#include "../bloco/bloco.h"
+#include "../carga/carga.h"
 #include "../csv/csv.h"
+#include "../dicionario/dicionario.h"
+#include "../espacoLivre/espacoLivre.h"
+#include "../estatisticas/estatisticas.h"
+#include "../hashLinear/hashLinear.h"
+#include "../ordenacao/ordenacao.h"
 #include "../utils/utils.h"
+#include "../varredura/varredura.h"
+#include "../zona/zona.h"
 #include "../veiculo/veiculo.h"
 
+#define CARTAO_SOMENTE "PAGAMENTO SOMENTE COM CARTAO SEM PRESENCA DE COBRADOR"
+#define CARTAO_E_DINHEIRO "PAGAMENTO EM CARTAO E DINHEIRO"
+#define CARTAO_FINAL_DE_SEMANA "PAGAMENTO EM CARTAO SOMENTE NO FINAL DE SEMANA"
+
 /**
- *  Valida o header de um arquivo
+ *  Valida o header de um arquivo, fechando o arquivo e liberando o dicionário do header caso ele seja recusado
  * @param arquivo arquivo de onde o header se origina
  * @param header header a ser verificado
  * @param verificaConsistencia flag que indica para testar a consistencia do arquivo
@@ -30,52 +43,59 @@ int validaHeader_linha(FILE** arquivo, linhaHeader header, int verificaConsisten
         printf("Registro inexistente.");
         correto = 0;
     }
-    if (!correto) fclose(*arquivo);
+    if (!correto) {
+        fclose(*arquivo);
+        liberaDicionario(header.dicionario);
+    }
     return correto;
 }
 
 /**
- * Imprime o tipo de pagamento no cartão no formato solicitado
+ * Escreve o tipo de pagamento no cartão no formato solicitado
+ * @param destino posição atual da saída
  * @param descricao descricao do campo
  * @param cartao string original no formato salvo
+ * @return posição seguinte ao texto escrito
  */
-void imprimirCartao(char* descricao, char* cartao) {
-    printf("%s: ", descricao);
-    switch (cartao[0]) {
+char* formataCartao(char* destino, char* descricao, char* cartao) {
+    destino = formataRotulo(destino, descricao);
+    switch (cartao == NULL ? '\0' : cartao[0]) {
         case 'S':
-            printf("PAGAMENTO SOMENTE COM CARTAO SEM PRESENCA DE COBRADOR");
+            destino = formataTexto(destino, CARTAO_SOMENTE, sizeof(CARTAO_SOMENTE) - 1);
             break;
         case 'N':
-            printf("PAGAMENTO EM CARTAO E DINHEIRO");
+            destino = formataTexto(destino, CARTAO_E_DINHEIRO, sizeof(CARTAO_E_DINHEIRO) - 1);
             break;
         case 'F':
-            printf("PAGAMENTO EM CARTAO SOMENTE NO FINAL DE SEMANA");
+            destino = formataTexto(destino, CARTAO_FINAL_DE_SEMANA, sizeof(CARTAO_FINAL_DE_SEMANA) - 1);
             break;
         default:
-            printf("campo com valor nulo");
+            destino = formataTexto(destino, VALOR_NULO, sizeof(VALOR_NULO) - 1);
             break;
     }
-    printf("\n");
+    *destino++ = '\n';
+    return destino;
 }
 
 /**
  * Lê um registro de uma linha do arquivo CSV lidando com campos nulos e os tamanhos
  * de registro total e dos campos variaveis
- * @param arquivoCSV nome do arquivo csv fonte dos dados
+ * @param leitor leitor do arquivo csv fonte dos dados
  * @param novaLinha variavel para salvar os dados
  * @return retorna 1 caso for o ultimo registro e 0 caso contrário
  */
-int lerLinha_CSV(FILE* arquivoCSV, linha* novaLinha) {
+int lerLinha_CSV(leitorCSV* leitor, linha* novaLinha) {
+    CONTA_CONCORRENTE(registrosCSV, 1);
     int tamanhoRegistro = 0;
 
-    novaLinha->removido = foiRemovido(arquivoCSV);
+    novaLinha->removido = foiRemovido(leitor);
 
-    novaLinha->codLinha = lerInteiro(arquivoCSV);
+    novaLinha->codLinha = lerInteiro(leitor);
 
-    lerStringFixa(arquivoCSV, novaLinha->aceitaCartao, 1);
+    lerStringFixa(leitor, novaLinha->aceitaCartao, 1);
 
-    int tamanhoNome = lerString(arquivoCSV, novaLinha->nomeLinha);
-    int tamanhoCor = lerString(arquivoCSV, novaLinha->corLinha);
+    int tamanhoNome = lerString(leitor, novaLinha->nomeLinha);
+    int tamanhoCor = lerString(leitor, novaLinha->corLinha);
 
     tamanhoRegistro += tamanhoNome + tamanhoCor;
     tamanhoRegistro += 13;  // tamanho da parte fixa da struct
@@ -84,18 +104,20 @@ int lerLinha_CSV(FILE* arquivoCSV, linha* novaLinha) {
     novaLinha->tamanhoCor = tamanhoCor;
     novaLinha->tamanhoRegistro = tamanhoRegistro;
 
-    return finalDoArquivo(arquivoCSV);
+    return fimLeitorCSV(leitor);
 }
 
 /**
  * Lê um registro de linha do arquivo binário lidando com campos nulos e os tamanhos
  * de registro total e dos campos variaveis
  * @param arquivoBin nome do arquivo binário fonte dos dados
+ * @param dic dicionário do arquivo (header.dicionario)
  * @param currL variavel para salvar os dados
  * @param pos indica se deve ler o próximo registro (-1) ou algum em especifico
- * @return retorna 1 caso for o ultimo registro e 0 caso contrário
+ * @return retorna 1 caso for o ultimo registro e 0 caso contrário, o arquivo fica no inicio do próximo registro
  */
-int lerLinha_Bin(FILE* arquivoBin, linha* currL, long int pos) {
+int lerLinha_Bin(FILE* arquivoBin, dicionario* dic, linha* currL, long int pos) {
+    CONTA(registrosLidos, 1);
     if (pos != -1) fseek(arquivoBin, pos, 0);
     if (lerStringBin(arquivoBin, &currL->removido, 1) == -1) return 1;
 
@@ -107,10 +129,86 @@ int lerLinha_Bin(FILE* arquivoBin, linha* currL, long int pos) {
     currL->tamanhoNome = lerInteiroBin(arquivoBin);
     lerStringBin(arquivoBin, currL->nomeLinha, currL->tamanhoNome);
 
-    currL->tamanhoCor = lerInteiroBin(arquivoBin);
-    lerStringBin(arquivoBin, currL->corLinha, currL->tamanhoCor);
+    // uma cor codificada não ocupa bytes no registro, só o código no lugar do tamanho
+    int tamanhoLido = 13 + currL->tamanhoNome;
+    tamanhoLido += lerCampoDicionarioBin(arquivoBin, dic, 0, currL->corLinha, &currL->tamanhoCor);
+
+    // um registro salvo no espaço de um removido maior tem bytes de sobra no fim
+    if (currL->tamanhoRegistro > tamanhoLido) {
+        fseek(arquivoBin, currL->tamanhoRegistro - tamanhoLido, SEEK_CUR);
+        currL->tamanhoRegistro = tamanhoLido;
+    }
+
+    return pulaEspacoLivre(arquivoBin, TAMANHO_HEADER_LINHA);
+}
+
+/**
+ * Lê um registro de linha de um arquivo mapeado sem copiar os campos variaveis,
+ * as strings da visão apontam para dentro da região mapeada
+ * @param mapa arquivo mapeado fonte dos dados
+ * @param dic dicionário do arquivo (header.dicionario)
+ * @param currL visão onde o registro será descrito
+ * @param pos indica se deve ler o próximo registro (-1) ou algum em especifico
+ * @return retorna 1 caso for o ultimo registro e 0 caso contrário, a posição fica no inicio do próximo registro
+ */
+int lerLinha_Mapa(arquivoMapeado* mapa, dicionario* dic, visaoLinha* currL, long int pos) {
+    CONTA_CONCORRENTE(registrosLidos, 1);
+    if (pos != -1) mapa->posicao = pos;
+    if (!restamBytesMapa(mapa, 1)) return 1;
+
+    currL->removido = mapa->dados[mapa->posicao++];
 
-    return finalDoArquivo(arquivoBin);
+    currL->tamanhoRegistro = lerInteiroMapa(mapa);
+    currL->codLinha = lerInteiroMapa(mapa);
+
+    currL->aceitaCartao = lerStringMapa(mapa, 1);
+
+    currL->tamanhoNome = lerInteiroMapa(mapa);
+    currL->nomeLinha = lerStringMapa(mapa, currL->tamanhoNome);
+
+    // uma cor codificada aponta para o valor no dicionário
+    long int inicioCor = mapa->posicao;
+    currL->corLinha = lerCampoDicionarioMapa(mapa, dic, 0, &currL->tamanhoCor, &currL->codigoCor);
+
+    // um registro salvo no espaço de um removido maior tem bytes de sobra no fim
+    int tamanhoLido = 9 + currL->tamanhoNome + (int)(mapa->posicao - inicioCor);
+    if (currL->tamanhoRegistro > tamanhoLido) {
+        mapa->posicao += currL->tamanhoRegistro - tamanhoLido;
+        currL->tamanhoRegistro = tamanhoLido;
+    }
+
+    return pulaEspacoLivreMapa(mapa, TAMANHO_HEADER_LINHA);
+}
+
+/**
+ * Posiciona a leitura sequencial de um arquivo mapeado no primeiro registro de dados
+ * @param mapa arquivo mapeado de linhas
+ * @return retorna 1 caso o arquivo não tenha registros e 0 caso contrário
+ */
+int posicionaPrimeiraLinha(arquivoMapeado* mapa) {
+    mapa->posicao = TAMANHO_HEADER_LINHA;
+    return pulaEspacoLivreMapa(mapa, TAMANHO_HEADER_LINHA);
+}
+
+/**
+ * Cria uma visão que aponta para os campos de uma linha já lida
+ * @param currL linha de onde os campos serão apontados
+ * @return visão da linha
+ */
+visaoLinha visaoDaLinha(linha* currL) {
+    visaoLinha visao;
+
+    visao.removido = currL->removido;
+    visao.tamanhoRegistro = currL->tamanhoRegistro;
+    visao.codLinha = currL->codLinha;
+    visao.aceitaCartao = currL->aceitaCartao;
+    visao.tamanhoNome = currL->tamanhoNome;
+    visao.nomeLinha = currL->nomeLinha;
+    visao.tamanhoCor = currL->tamanhoCor;
+    visao.corLinha = currL->corLinha;
+    visao.codigoCor = -1;
+
+    return visao;
 }
 
 /**
@@ -140,57 +238,355 @@ void lerLinha_Terminal(linha* currL) {
  * @param quebraLinha flag que indica se quebra de linha deve ser executada
  */
 void imprimeLinha(linha currLinha, linhaHeader header, int quebraLinha) {
-    imprimirCampo(header.descreveCodigo, &currLinha.codLinha, 1);
-    imprimirCampo(header.descreveNome, currLinha.nomeLinha, 0);
-    imprimirCampo(header.descreveLinha, currLinha.corLinha, 0);
-    imprimirCartao(header.descreveCartao, currLinha.aceitaCartao);  //o cartão recebe um tratamento diferente devido as excessões
-    if (quebraLinha) printf("\n");
+    visaoLinha visao = visaoDaLinha(&currLinha);
+    imprimeVisaoLinha(&visao, &header, quebraLinha);
 }
 
 /**
- * Salva uma nova linha em um arquivo binário na posição indicada pelo header
- * e atualiza quantidade de registros e próxima prosição de salvamento
- * @param arquivoBin arquivo onde a linha será lida
- * @param currL variavel onde a linha será salva
- * @param header header do arquivo binário
+ * Imprime os campos da visão de uma linha conforme a formatação requisitada
+ * @param currLinha visão da linha a ser impressa
+ * @param header header do arquivo
+ * @param quebraLinha flag que indica se quebra de linha deve ser executada
+ */
+void imprimeVisaoLinha(visaoLinha* currLinha, linhaHeader* header, int quebraLinha) {
+    CONTA(registrosDevolvidos, 1);
+
+    // o registro inteiro é montado em memória e entregue à saída com uma única escrita
+    char saidaLocal[TAMANHO_SAIDA_REGISTRO];
+    int tamanhoMaximo = tamanhoSaidaLinha(currLinha);
+    char* saida = (tamanhoMaximo <= TAMANHO_SAIDA_REGISTRO) ? saidaLocal : (char*)malloc(tamanhoMaximo);
+
+    char* fim = formataVisaoLinha(saida, currLinha, header, quebraLinha);
+
+    fwrite(saida, sizeof(char), fim - saida, stdout);
+    if (saida != saidaLocal) free(saida);
+}
+
+/**
+ * @param currLinha visão da linha a ser impressa
+ * @return retorna a maior quantidade de bytes que a impressão da linha pode ocupar
+ */
+int tamanhoSaidaLinha(visaoLinha* currLinha) {
+    return TAMANHO_SAIDA_FIXA + (currLinha->tamanhoNome > 0 ? currLinha->tamanhoNome : 0) +
+           (currLinha->tamanhoCor > 0 ? currLinha->tamanhoCor : 0);
+}
+
+/**
+ * Monta em memória a impressão de uma linha, no mesmo formato do imprimeVisaoLinha
+ * @param destino região com ao menos tamanhoSaidaLinha bytes
+ * @param currLinha visão da linha a ser impressa
+ * @param header header do arquivo
+ * @param quebraLinha flag que indica se quebra de linha deve ser executada
+ * @return retorna a posição logo após o ultimo byte escrito
+ */
+char* formataVisaoLinha(char* destino, visaoLinha* currLinha, linhaHeader* header, int quebraLinha) {
+    char* fim = destino;
+    fim = formataCampo(fim, header->descreveCodigo, currLinha->codLinha);
+    fim = formataCampoTamanho(fim, header->descreveNome, currLinha->nomeLinha, currLinha->tamanhoNome);
+    fim = formataCampoTamanho(fim, header->descreveLinha, currLinha->corLinha, currLinha->tamanhoCor);
+    fim = formataCartao(fim, header->descreveCartao, currLinha->aceitaCartao);  //o cartão recebe um tratamento diferente devido as excessões
+    if (quebraLinha) *fim++ = '\n';
+    return fim;
+}
+
+/**
+ * @param dic dicionário do arquivo de destino
+ * @param currL linha
+ * @return tamanhoRegistro da linha gravada, sem os bytes da cor codificada pelo dicionário
+ */
+int tamanhoGravadoLinha(dicionario* dic, linha* currL) {
+    return 13 + currL->tamanhoNome + bytesCampoDicionario(dic, currL->tamanhoCor);
+}
+
+/**
+ * Escreve os campos de uma linha em uma região de memória, no mesmo formato do arquivo binário
+ * atualiza o tamanhoRegistro da linha conforme a cor codificada pelo dicionário
+ * @param destino região onde a linha será escrita
+ * @param dic dicionário do arquivo de destino
+ * @param currL linha que será escrita
+ * @return retorna a quantidade de bytes escritos
  */
-void salvaLinha(FILE* arquivoBin, linha* currL, linhaHeader* header) {
-    fseek(arquivoBin, header->byteProxReg, SEEK_SET);
+int codificaLinha(char* destino, dicionario* dic, linha* currL) {
+    char* atual = destino;
+    currL->tamanhoRegistro = tamanhoGravadoLinha(dic, currL);
+
+    *atual++ = currL->removido;
+    memcpy(atual, &currL->tamanhoRegistro, sizeof(int));
+    atual += sizeof(int);
+    memcpy(atual, &currL->codLinha, sizeof(int));
+    atual += sizeof(int);
+    *atual++ = currL->aceitaCartao[0];
+
+    memcpy(atual, &currL->tamanhoNome, sizeof(int));
+    atual += sizeof(int);
+    memcpy(atual, currL->nomeLinha, currL->tamanhoNome);
+    atual += currL->tamanhoNome;
+
+    atual = codificaCampoDicionario(atual, dic, 0, currL->corLinha, currL->tamanhoCor);
 
-    fwrite(&currL->removido, sizeof(char), 1, arquivoBin);
-    fwrite(&currL->tamanhoRegistro, sizeof(int), 1, arquivoBin);
-    fwrite(&currL->codLinha, sizeof(int), 1, arquivoBin);
-    fwrite(&currL->aceitaCartao, sizeof(char), 1, arquivoBin);
+    return atual - destino;
+}
+
+/**
+ * Lê a próxima linha do CSV e a escreve já no formato do binário, usado pela carga paralela
+ * @param leitor leitor do trecho do CSV
+ * @param contexto dicionário do arquivo em criação, já com todas as cores do CSV
+ * @param destino região onde a linha será escrita
+ * @param removido variável onde será salvo se a linha foi removida
+ * @return retorna a quantidade de bytes escritos
+ */
+int codificaLinhaCSV(leitorCSV* leitor, void* contexto, char* destino, char* removido) {
+    linha novaLinha;
+    lerLinha_CSV(leitor, &novaLinha);
+    *removido = novaLinha.removido;
+    return codificaLinha(destino, (dicionario*)contexto, &novaLinha);
+}
 
-    fwrite(&currL->tamanhoNome, sizeof(int), 1, arquivoBin);
-    fwrite(&currL->nomeLinha, sizeof(char), currL->tamanhoNome, arquivoBin);
+/**
+ * Acrescenta uma nova linha ao buffer de escrita do binário, que será gravada junto dos próximos registros
+ * e atualiza quantidade de registros e próxima posição de salvamento
+ * com uma lista de espaços livres, uma linha não removida é gravada no menor registro removido onde cabe,
+ * mantendo o tamanhoRegistro do espaço para que as leituras pulem a sobra
+ * o header só é gravado pelo chamador, depois que o buffer for descarregado
+ * @param buffer buffer de escrita posicionado no fim do arquivo, no formato do arquivo
+ * @param currL linha que será salva
+ * @param header header do arquivo binário
+ * @param livres espaços livres do arquivo ou NULL para gravar sempre no fim
+ * @param zonas mapa de zonas do arquivo ou NULL caso ele não seja mantido
+ * @return retorna o byteOffset onde a linha foi salva
+ */
+long int salvaLinhaBuffer(bufferEscrita* buffer, linha* currL, linhaHeader* header, listaEspacoLivre* livres,
+                          mapaZonas* zonas) {
+    long int byteOffset;
+    int tamanhoEspaco;
+    currL->tamanhoRegistro = tamanhoGravadoLinha(header->dicionario, currL);
+
+    if (livres != NULL && currL->removido == '1' && retiraMelhorEspaco(livres, currL->tamanhoRegistro, &byteOffset, &tamanhoEspaco)) {
+        char* registroCodificado = (char*)malloc(sizeof(linha) + tamanhoEspaco);
+        int tamanho = codificaLinha(registroCodificado, header->dicionario, currL);
+
+        memcpy(registroCodificado + 1, &tamanhoEspaco, sizeof(int));
+        memset(registroCodificado + tamanho, '@', 5 + tamanhoEspaco - tamanho);
+        escreveBufferEscritaEm(buffer, byteOffset, registroCodificado, 5 + tamanhoEspaco);
+        free(registroCodificado);
+
+        header->nroRegRemovidos--;
+        header->nroRegistros++;
+        if (zonas != NULL) registraValoresZona(zonas, byteOffset, &currL->codLinha);
+        return byteOffset;
+    }
 
-    fwrite(&currL->tamanhoCor, sizeof(int), 1, arquivoBin);
-    fwrite(&currL->corLinha, sizeof(char), currL->tamanhoCor, arquivoBin);
+    char* destino = reservaBufferEscrita(buffer, sizeof(linha));
+    byteOffset = posicaoLivreBufferEscrita(buffer);
+    int tamanho = codificaLinha(destino, header->dicionario, currL);
+    confirmaBufferEscrita(buffer, tamanho);
 
-    header->byteProxReg = ftell(arquivoBin);
+    header->byteProxReg = posicaoLivreBufferEscrita(buffer);
     header->nroRegRemovidos += (currL->removido == '0') ? 1 : 0;
     header->nroRegistros += (currL->removido == '0') ? 0 : 1;
+
+    if (livres != NULL && currL->removido == '0') adicionaEspacoLivre(livres, byteOffset, currL->tamanhoRegistro);
+    if (zonas != NULL) registraValoresZona(zonas, byteOffset, &currL->codLinha);  // codLinha é o único campo resumido
+    return byteOffset;
+}
+
+/**
+ * Obtém a lista de espaços livres de um arquivo de linhas quando o reuso está ativo (REUSO_ESPACO=1),
+ * a lista salva ao lado do arquivo é usada se ainda corresponder a ele, senão o arquivo é percorrido
+ * @param arquivoBin arquivo de dados, ainda não alterado
+ * @param nomeArquivoBin nome do arquivo de dados
+ * @return lista de espaços livres ou NULL caso o reuso esteja desativado
+ */
+listaEspacoLivre* carregaEspacoLivre_Linha(FILE* arquivoBin, char nomeArquivoBin[100]) {
+    if (!lerConfiguracao("REUSO_ESPACO", 0)) return NULL;
+
+    char nomeLista[256];
+    nomeListaEspacoLivre(nomeLista, nomeArquivoBin);
+    listaEspacoLivre* livres = carregaListaEspacoLivre(nomeLista, nomeArquivoBin);
+    if (livres != NULL) return livres;
+
+    livres = criaListaEspacoLivre();
+
+    arquivoMapeado mapa;
+    if (!mapeiaConteudo(arquivoBin, &mapa, 1)) return livres;
+
+    visaoLinha linhaTemp;
+    int isFinalDoArquivo = posicionaPrimeiraLinha(&mapa);
+
+    // o espaço de cada removido é o tamanhoRegistro gravado, que inclui a sobra de um reuso anterior,
+    // só os tamanhos são usados e eles não dependem do dicionário
+    while (!isFinalDoArquivo) {
+        long int byteOffset = mapa.posicao;
+        isFinalDoArquivo = lerLinha_Mapa(&mapa, NULL, &linhaTemp, -1);
+        if (linhaTemp.removido != '0') continue;
+
+        int tamanhoEspaco;
+        memcpy(&tamanhoEspaco, mapa.dados + byteOffset + 1, sizeof(int));
+        adicionaEspacoLivre(livres, byteOffset, tamanhoEspaco);
+    }
+
+    desmapeiaArquivo(&mapa);
+    return livres;
+}
+
+/**
+ * Salva a lista de espaços livres ao lado do arquivo de dados, que já deve estar fechado, e a libera
+ * @param livres lista de espaços livres, NULL caso o reuso esteja desativado
+ * @param nomeArquivoBin nome do arquivo de dados
+ */
+void finalizaEspacoLivre_Linha(listaEspacoLivre* livres, char nomeArquivoBin[100]) {
+    if (livres == NULL) return;
+
+    char nomeLista[256];
+    nomeListaEspacoLivre(nomeLista, nomeArquivoBin);
+    salvaListaEspacoLivre(livres, nomeLista, nomeArquivoBin);
+    liberaListaEspacoLivre(livres);
+}
+
+/**
+ * Obtém o mapa de zonas de um arquivo de linhas para ser atualizado pelas inserções (MAPA_ZONAS=1),
+ * um mapa que não corresponde mais ao arquivo é deixado para ser remontado pela próxima busca
+ * @param nomeArquivoBin nome do arquivo de dados, ainda não alterado
+ * @param header header do arquivo de dados
+ * @return mapa de zonas ou NULL caso ele não seja mantido
+ */
+mapaZonas* carregaZonas_Linha(char nomeArquivoBin[100], linhaHeader* header) {
+    if (header->formato != FORMATO_BLOCOS || !mapaZonasAtivo()) return NULL;
+    return carregaMapaZonas(nomeArquivoBin, CAMPOS_ZONA_LINHA, TAMANHO_HEADER_LINHA);
+}
+
+/**
+ * Salva o mapa de zonas ao lado do arquivo de dados, que já deve estar fechado, e o libera
+ * @param zonas mapa de zonas, NULL caso ele não seja mantido
+ * @param nomeArquivoBin nome do arquivo de dados
+ */
+void finalizaZonas_Linha(mapaZonas* zonas, char nomeArquivoBin[100]) {
+    if (zonas == NULL) return;
+
+    salvaMapaZonas(zonas, nomeArquivoBin);
+    liberaMapaZonas(zonas);
+}
+
+/**
+ * Marca os blocos que podem ter linhas que atendem a busca, usando o mapa de zonas salvo ao lado do arquivo
+ * ou, caso ele não corresponda ao arquivo, remontando e salvando o mapa a partir do diretório de cada bloco
+ * @param nomeArquivoBin nome do arquivo de dados
+ * @param mapa arquivo de dados mapeado, no formato em blocos
+ * @param consulta condição da busca
+ * @return vetor alocado de blocosPossiveisZona ou NULL caso todos os blocos precisem ser lidos
+ */
+char* blocosPossiveis_Linha(char nomeArquivoBin[100], arquivoMapeado* mapa, consultaLinha* consulta) {
+    if (consulta->campo != 0 || !mapaZonasAtivo()) return NULL;  // só codLinha
+
+    long int nroBlocos = (mapa->tamanho - TAMANHO_HEADER_LINHA) / TAMANHO_BLOCO_DADOS;
+    mapaZonas* zonas = carregaMapaZonas(nomeArquivoBin, CAMPOS_ZONA_LINHA, TAMANHO_HEADER_LINHA);
+
+    if (zonas == NULL) {
+        zonas = criaMapaZonas(CAMPOS_ZONA_LINHA, TAMANHO_HEADER_LINHA);
+        arquivoMapeado leitura = *mapa;
+        visaoLinha linhaTemp;
+
+        for (long int i = 0; i < nroBlocos; i++) {
+            long int inicioBloco = TAMANHO_HEADER_LINHA + i * TAMANHO_BLOCO_DADOS;
+            char* bloco = mapa->dados + inicioBloco;
+
+            for (int j = 0; j < nroRegistrosBloco(bloco); j++) {
+                long int byteOffset = inicioBloco + posicaoRegistroBloco(bloco, j);
+                lerLinha_Mapa(&leitura, consulta->header->dicionario, &linhaTemp, byteOffset);
+                registraValoresZona(zonas, byteOffset, &linhaTemp.codLinha);
+            }
+        }
+
+        salvaMapaZonas(zonas, nomeArquivoBin);
+    }
+
+    char* possiveis = blocosPossiveisZona(zonas, 0, consulta->valorInteiro, nroBlocos);
+    liberaMapaZonas(zonas);
+    return possiveis;
+}
+
+// campos string que podem ter um indice hash
+#define NRO_CAMPOS_STRING_LINHA 3
+static char* camposString_Linha[NRO_CAMPOS_STRING_LINHA] = {"aceitaCartao", "nomeLinha", "corLinha"};
+
+/**
+ * Verifica se um campo da linha é uma string
+ * @param campo nome do campo
+ * @return retorna 1 caso o campo seja uma string e 0 caso contrário
+ */
+int campoEhString_Linha(char* campo) {
+    for (int i = 0; i < NRO_CAMPOS_STRING_LINHA; i++)
+        if (strcmp(campo, camposString_Linha[i]) == 0) return 1;
+    return 0;
+}
+
+/**
+ * Remove os indices hash de todos os campos string, que deixam de valer quando o arquivo de dados é alterado
+ * @param nomeArquivoBin nome do arquivo de dados
+ */
+void removeIndicesHash_Linha(char nomeArquivoBin[100]) {
+    for (int i = 0; i < NRO_CAMPOS_STRING_LINHA; i++) removeHashLinear(nomeArquivoBin, camposString_Linha[i]);
 }
 
 /**
  * Lê o header do CSV e salva em uma variável
- * @param arquivoCSV arquivo de onde o header será lido
+ * @param leitor leitor do arquivo de onde o header será lido
  * @param header header onde será salvo
  */
-void lerHeaderCSV_Linha(FILE* arquivoCSV, linhaHeader* header) {
-    lerString(arquivoCSV, header->descreveCodigo);
-    lerString(arquivoCSV, header->descreveCartao);
-    lerString(arquivoCSV, header->descreveNome);
-    lerString(arquivoCSV, header->descreveLinha);
+void lerHeaderCSV_Linha(leitorCSV* leitor, linhaHeader* header) {
+    lerString(leitor, header->descreveCodigo);
+    lerString(leitor, header->descreveCartao);
+    lerString(leitor, header->descreveNome);
+    lerString(leitor, header->descreveLinha);
+}
+
+/**
+ * Monta o dicionário das cores de um CSV de linhas, percorrendo os registros na ordem do arquivo
+ * para que os códigos não dependam da divisão da carga paralela, que depois só consulta o dicionário
+ * @param dados registros do CSV, sem o header
+ * @param tamanho quantidade de bytes dos registros
+ * @return dicionário com todas as cores do CSV
+ */
+dicionario* montaDicionarioCSV_Linha(char* dados, long int tamanho) {
+    dicionario* dic = criaDicionario(CAMPOS_DICIONARIO_LINHA);
+    leitorCSV leitor;
+    linha novaLinha;
+    iniciaLeitorCSVMemoria(&leitor, dados, tamanho);
+
+    int isFinalDoArquivo = fimLeitorCSV(&leitor);
+    while (!isFinalDoArquivo) {
+        isFinalDoArquivo = lerLinha_CSV(&leitor, &novaLinha);
+        if (novaLinha.tamanhoCor > 0) codigoDicionario(dic, 0, novaLinha.corLinha, novaLinha.tamanhoCor);
+    }
+
+    finalizaLeitorCSV(&leitor);
+    return dic;
 }
 
 /**
- * Lê o header de um arquivo binário
+ * Salva o dicionário do header ao lado do arquivo de dados caso ele tenha ganhado valores ou, caso as cores
+ * tenham sido gravadas por extenso, remove um dicionário antigo com o mesmo nome. Depois libera o dicionário
+ * @param header header do arquivo de dados
+ * @param nomeArquivoBin nome do arquivo de dados
+ */
+void finalizaDicionario_Linha(linhaHeader* header, char nomeArquivoBin[100]) {
+    if (header->dicionario == NULL)
+        removeDicionario(nomeArquivoBin);
+    else if (header->dicionario->alterado)
+        salvaDicionario(header->dicionario, nomeArquivoBin);
+
+    liberaDicionario(header->dicionario);
+    header->dicionario = NULL;
+}
+
+/**
+ * Lê o header de um arquivo binário e posiciona o arquivo no primeiro registro
+ * o dicionário do arquivo, caso exista, é carregado no header e deve ser liberado por quem leu o header
  * @param arquivoBin arquivo de onde será lido
+ * @param nomeArquivoBin nome do arquivo, usado para encontrar o dicionário
  * @param header variável onde o header será salvo
  */
-void lerHeaderBin_Linha(FILE* arquivoBin, linhaHeader* header) {
+void lerHeaderBin_Linha(FILE* arquivoBin, char* nomeArquivoBin, linhaHeader* header) {
     fseek(arquivoBin, 0, SEEK_SET);
 
     fread(&header->status, sizeof(char), 1, arquivoBin);
@@ -201,6 +597,10 @@ void lerHeaderBin_Linha(FILE* arquivoBin, linhaHeader* header) {
     lerStringBin(arquivoBin, (header->descreveCartao), 13);
     lerStringBin(arquivoBin, (header->descreveNome), 13);
     lerStringBin(arquivoBin, (header->descreveLinha), 24);
+
+    header->formato = formatoArquivoDados(arquivoBin, TAMANHO_HEADER_LINHA);
+
+    header->dicionario = carregaDicionario(nomeArquivoBin, CAMPOS_DICIONARIO_LINHA);
 }
 
 /**
@@ -221,18 +621,6 @@ void salvaHeader_Linha(FILE* arquivoBin, linhaHeader* header) {
     fwrite(&(header->descreveLinha), sizeof(char), 24, arquivoBin);
 }
 
-/**
- * Compara duas linhas
- * @param linhaA primeira linha
- * @param linhaB segunda linha
- * @return retorna linhaA->codLinha - linhaB->codLinha
- */
-int compararLinhas(const void* linhaA, const void* linhaB) {
-    int a = (*(linha*)linhaA).codLinha;
-    int b = (*(linha*)linhaB).codLinha;
-    return a - b;
-}
-
 /**
  * Cria um arquivo binário na estrutura solicitada de header e campos a partir de um arquivo CSV
  * @param nomeArquivoCSV nome do arquivo csv fonte dos dados
@@ -244,32 +632,53 @@ void CreateTable_Linha(char nomeArquivoCSV[100], char nomeArquivoBin[100]) {
 
     if (!abrirArquivo(&arquivoCSV, nomeArquivoCSV, "r", 1)) return;
 
-    abrirArquivo(&arquivoBin, nomeArquivoBin, "wb", 0);
+    arquivoMapeado mapaCSV;
+    if (!mapeiaArquivo(&arquivoCSV, &mapaCSV, 1)) return;
+
+    if (!abrirArquivo(&arquivoBin, nomeArquivoBin, "wb", 1)) {
+        desmapeiaArquivo(&mapaCSV);
+        fclose(arquivoCSV);
+        return;
+    }
 
     linhaHeader novoHeader;
-    linha novaLinha;
 
     //valores iniciais do header
     novoHeader.status = '0';
     novoHeader.byteProxReg = 82;
     novoHeader.nroRegistros = 0;
     novoHeader.nroRegRemovidos = 0;
+    novoHeader.formato = (lerConfiguracao("FORMATO_DADOS", FORMATO_FLUXO) == FORMATO_BLOCOS) ? FORMATO_BLOCOS : FORMATO_FLUXO;
+
+    leitorCSV leitor;
+    iniciaLeitorCSVMemoria(&leitor, mapaCSV.dados, mapaCSV.tamanho);
 
-    lerHeaderCSV_Linha(arquivoCSV, &novoHeader);
+    lerHeaderCSV_Linha(&leitor, &novoHeader);
     salvaHeader_Linha(arquivoBin, &novoHeader);
 
-    int isFinalDoArquivo = finalDoArquivo(arquivoCSV);
+    // com DICIONARIO=1 corLinha é gravada como código do dicionário do arquivo
+    novoHeader.dicionario = NULL;
+    if (lerConfiguracao("DICIONARIO", 0) > 0)
+        novoHeader.dicionario = montaDicionarioCSV_Linha(mapaCSV.dados + leitor.posicao, mapaCSV.tamanho - leitor.posicao);
 
-    while (!isFinalDoArquivo) {
-        isFinalDoArquivo = lerLinha_CSV(arquivoCSV, &novaLinha);
-        salvaLinha(arquivoBin, &novaLinha, &novoHeader);
-    }
+    // os registros são convertidos em paralelo e escritos na ordem do CSV logo após o header
+    bufferEscrita buffer;
+    iniciaBufferEscritaFormato(&buffer, arquivoBin, novoHeader.formato, TAMANHO_HEADER_LINHA, novoHeader.byteProxReg);
+    carregaCSVParalelo(mapaCSV.dados + leitor.posicao, mapaCSV.tamanho - leitor.posicao, &buffer, codificaLinhaCSV,
+                       novoHeader.dicionario, sizeof(linha), &novoHeader.nroRegistros, &novoHeader.nroRegRemovidos);
+    descarregaBufferEscrita(&buffer);
+    novoHeader.byteProxReg = posicaoLivreBufferEscrita(&buffer);
 
     novoHeader.status = '1';
 
     salvaHeader_Linha(arquivoBin, &novoHeader);
 
     fclose(arquivoBin);
+    removeListaEspacoLivre(nomeArquivoBin);  // a lista e os indices hash de um arquivo anterior com o mesmo nome não valem mais
+    removeIndicesHash_Linha(nomeArquivoBin);
+    finalizaDicionario_Linha(&novoHeader, nomeArquivoBin);
+    finalizaLeitorCSV(&leitor);
+    desmapeiaArquivo(&mapaCSV);
     fclose(arquivoCSV);
 
     binarioNaTela(nomeArquivoBin);
@@ -284,19 +693,202 @@ void SelectFrom_Linha(char nomeArquivoBin[100]) {
     if (!abrirArquivo(&arquivoBin, nomeArquivoBin, "rb", 1)) return;
 
     linhaHeader novoHeader;
-    linha novaLinha;
+    visaoLinha novaLinha;
+    arquivoMapeado mapa;
 
-    lerHeaderBin_Linha(arquivoBin, &novoHeader);
+    lerHeaderBin_Linha(arquivoBin, nomeArquivoBin, &novoHeader);
     if (!validaHeader_linha(&arquivoBin, novoHeader, 1, 1)) return;
+    if (!mapeiaArquivo(&arquivoBin, &mapa, 1)) {
+        liberaDicionario(novoHeader.dicionario);
+        return;
+    }
 
-    int isFinalDoArquivo = finalDoArquivo(arquivoBin);
+    int isFinalDoArquivo = posicionaPrimeiraLinha(&mapa);  // posiciona para o primeiro registro de dados
 
     while (!isFinalDoArquivo) {
-        isFinalDoArquivo = lerLinha_Bin(arquivoBin, &novaLinha, -1);
-        if (novaLinha.removido == '1') imprimeLinha(novaLinha, novoHeader, 1);
+        isFinalDoArquivo = lerLinha_Mapa(&mapa, novoHeader.dicionario, &novaLinha, -1);
+        if (novaLinha.removido == '1') imprimeVisaoLinha(&novaLinha, &novoHeader, 1);
     }
 
+    desmapeiaArquivo(&mapa);
     fclose(arquivoBin);
+    liberaDicionario(novoHeader.dicionario);
+}
+
+/**
+ * Devolve o valor de um campo string de uma linha, no mesmo formato comparado por stringIgual
+ * @param currLinha linha de onde o campo será lido
+ * @param campo nome do campo
+ * @param tamanho variável onde o tamanho do valor será salvo
+ * @return ponteiro para o inicio do valor, que pode ser NULL quando o campo é nulo
+ */
+char* lerCampoString_Linha(visaoLinha* currLinha, char* campo, int* tamanho) {
+    char* valor;
+    int tamanhoMaximo;
+
+    if (strcmp(campo, "aceitaCartao") == 0) {
+        valor = currLinha->aceitaCartao;
+        tamanhoMaximo = 1;
+    } else if (strcmp(campo, "nomeLinha") == 0) {
+        valor = currLinha->nomeLinha;
+        tamanhoMaximo = currLinha->tamanhoNome;
+    } else if (strcmp(campo, "corLinha") == 0) {
+        valor = currLinha->corLinha;
+        tamanhoMaximo = currLinha->tamanhoCor;
+    } else {
+        *tamanho = 0;
+        return NULL;
+    }
+
+    *tamanho = (valor == NULL || tamanhoMaximo <= 0) ? 0 : (int)strnlen(valor, tamanhoMaximo);
+    return valor;
+}
+
+/**
+ *  Responde um SelectFromWhere usando o indice hash do campo, caso ele exista e
+ *  tenha sido construido sobre o estado atual do arquivo de dados
+ * @param nomeArquivoBin nome do arquivo binário dos registros
+ * @param header header do arquivo de dados
+ * @param mapa arquivo de dados mapeado
+ * @param campo nome do campo buscado
+ * @param valor valor buscado
+ * @return retorna 1 caso a busca tenha sido feita pelo indice e 0 caso o arquivo precise ser percorrido
+ */
+int SelectFromWhereHash_Linha(char nomeArquivoBin[100], linhaHeader* header, arquivoMapeado* mapa, char* campo, char* valor) {
+    if (!campoEhString_Linha(campo)) return 0;
+
+    char nomeIndice[256];
+    nomeHashLinear(nomeIndice, nomeArquivoBin, campo);
+    // as operações que escrevem no arquivo removem o indice, o header ainda confere o arquivo de onde foi construido
+    hashLinear* indice = carregaHashLinear(nomeIndice, nomeArquivoBin);
+    if (indice == NULL) return 0;
+
+    int quantidade;
+    long int* byteOffsets = buscaHashLinear(indice, valor, (int)strlen(valor), &quantidade);
+    fechaHashLinear(indice);
+
+    // o indice guarda apenas o hash do valor, então cada candidato ainda é comparado
+    visaoLinha linhaTemp;
+    int tamanho;
+    int existePeloMenosUm = 0;
+    for (int i = 0; i < quantidade; i++) {
+        lerLinha_Mapa(mapa, header->dicionario, &linhaTemp, byteOffsets[i]);
+        if (linhaTemp.removido != '1') continue;
+
+        char* valorCampo = lerCampoString_Linha(&linhaTemp, campo, &tamanho);
+        if (!stringIgual(valor, valorCampo, tamanho)) continue;
+
+        imprimeVisaoLinha(&linhaTemp, header, 1);
+        existePeloMenosUm = 1;
+    }
+
+    if (!existePeloMenosUm) printf("Registro inexistente.\n");
+
+    free(byteOffsets);
+    return 1;
+}
+
+/**
+ *  Cria um indice hash linear sobre um campo string das linhas, salvo ao lado do arquivo de dados
+ *  e usado automaticamente pelo SelectFromWhere desse campo
+ * @param nomeArquivoBin nome do arquivo binário dos registros
+ * @param campo nome do campo indexado
+ */
+void CreateIndexHash_Linha(char nomeArquivoBin[100], char* campo) {
+    FILE* arquivoBin;
+    if (!abrirArquivo(&arquivoBin, nomeArquivoBin, "rb", 1)) return;
+
+    linhaHeader header;
+    visaoLinha linhaTemp;
+    arquivoMapeado mapa;
+    int tamanho;
+
+    lerHeaderBin_Linha(arquivoBin, nomeArquivoBin, &header);
+    if (!validaHeader_linha(&arquivoBin, header, 1, 0)) return;
+
+    if (!campoEhString_Linha(campo)) {
+        printf("Falha no processamento do arquivo.");
+        fclose(arquivoBin);
+        liberaDicionario(header.dicionario);
+        return;
+    }
+
+    if (!mapeiaArquivo(&arquivoBin, &mapa, 1)) {
+        liberaDicionario(header.dicionario);
+        return;
+    }
+
+    char nomeIndice[256];
+    nomeHashLinear(nomeIndice, nomeArquivoBin, campo);
+    hashLinear* indice = criaHashLinear(nomeIndice);
+
+    if (indice == NULL) {
+        printf("Falha no processamento do arquivo.");
+        desmapeiaArquivo(&mapa);
+        fclose(arquivoBin);
+        liberaDicionario(header.dicionario);
+        return;
+    }
+
+    int isFinalDoArquivo = posicionaPrimeiraLinha(&mapa);
+
+    while (!isFinalDoArquivo) {
+        long int byteOffset = mapa.posicao;
+        isFinalDoArquivo = lerLinha_Mapa(&mapa, header.dicionario, &linhaTemp, -1);
+        if (linhaTemp.removido != '1') continue;
+
+        char* valor = lerCampoString_Linha(&linhaTemp, campo, &tamanho);
+        insereHashLinear(indice, valor, tamanho, byteOffset);
+    }
+
+    desmapeiaArquivo(&mapa);
+    fclose(arquivoBin);
+    liberaDicionario(header.dicionario);
+    finalizaHashLinear(indice, nomeArquivoBin);
+    binarioNaTela(nomeIndice);
+}
+
+/**
+ * @param currL visão de uma linha
+ * @param consulta condição da busca
+ * @return retorna 1 caso a linha não esteja removida e atenda a condição
+ */
+int atendeConsultaLinha(visaoLinha* currL, consultaLinha* consulta) {
+    if (currL->removido == '0') return 0;  // linha ja removida
+
+    switch (consulta->campo) {
+        case 0:
+            return currL->codLinha == consulta->valorInteiro;
+        case 1:
+            return stringIgual(consulta->valor, currL->aceitaCartao, 1);
+        case 2:
+            return stringIgual(consulta->valor, currL->nomeLinha, currL->tamanhoNome);
+        case 3:
+            if (consulta->codigo != -1 && currL->codigoCor != -1) return currL->codigoCor == consulta->codigo;
+            return stringIgual(consulta->valor, currL->corLinha, currL->tamanhoCor);
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Avalia uma linha durante a varredura paralela, chamada por várias threads ao mesmo tempo
+ * @param mapa cópia do mapeamento exclusiva da thread
+ * @param byteOffset inicio do registro
+ * @param argumento condição da busca (consultaLinha)
+ * @param saida saida do trecho onde a linha é impressa caso atenda a condição
+ * @return retorna 1 caso a linha tenha sido impressa e 0 caso contrário
+ */
+int avaliaConsultaLinha(arquivoMapeado* mapa, long int byteOffset, void* argumento, saidaTrecho* saida) {
+    consultaLinha* consulta = (consultaLinha*)argumento;
+    visaoLinha linhaTemp;
+
+    lerLinha_Mapa(mapa, consulta->header->dicionario, &linhaTemp, byteOffset);
+    if (!atendeConsultaLinha(&linhaTemp, consulta)) return 0;
+
+    char* destino = reservaSaidaTrecho(saida, tamanhoSaidaLinha(&linhaTemp));
+    confirmaSaidaTrecho(saida, formataVisaoLinha(destino, &linhaTemp, consulta->header, 1));
+    return 1;
 }
 
 /**
@@ -314,10 +906,10 @@ void SelectFromWhere_Linha(char nomeArquivoBin[100], char* campo, char* valor) {
 
     linhaHeader header;
 
-    lerHeaderBin_Linha(arquivoBin, &header);
+    lerHeaderBin_Linha(arquivoBin, nomeArquivoBin, &header);
     if (!validaHeader_linha(&arquivoBin, header, 1, 1)) return;
 
-    int headerPos;                       // posição do campo no cabeçalho
+    int headerPos = -1;                  // posição do campo no cabeçalho
     if (strcmp(campo, "codLinha") == 0)  // codLinha (int)
         headerPos = 0;
     else if (strcmp(campo, "aceitaCartao") == 0)  // aceitaCartao (string)
@@ -329,48 +921,58 @@ void SelectFromWhere_Linha(char nomeArquivoBin[100], char* campo, char* valor) {
 
     int total = header.nroRegistros + header.nroRegRemovidos;  // numero total de registros de dados
     int existePeloMenosUm = 0;
+    int valorInteiro = stringToInt(valor, (int)strlen(valor));
 
-    fseek(arquivoBin, 82, 0);  // posiciono para o primeiro registro de dados do binario
-
-    linha linhaTemp;  // crio a cada iteração uma linha atribuindo a ela os
-                      // valores lido em cada registro do binario
-
-    while (total--) {  // percorro todos registros de dados
-        lerLinha_Bin(arquivoBin, &linhaTemp, -1);
-        int existe = 0;
-        if (linhaTemp.removido == '0') continue;  // linha ja removida
-
-        switch (headerPos) {
-            case 0:
-                if (linhaTemp.codLinha == stringToInt(valor, (int)strlen(valor))) {
-                    imprimeLinha(linhaTemp, header, 1);
-                    fclose(arquivoBin);
-                    return;
-                    //como o codLinha é unico pode interromper assim que encontrar o primeiro
-                }
-                break;
-            case 1:
-                if (strcmp(valor, linhaTemp.aceitaCartao) == 0) existe = 1;
-                break;
-            case 2:
-                if (strcmp(valor, linhaTemp.nomeLinha) == 0) existe = 1;
-                break;
-            case 3:
-                if (strcmp(valor, linhaTemp.corLinha) == 0) existe = 1;
-                break;
-            default:
-                break;
-        }
+    arquivoMapeado mapa;
+    if (!mapeiaArquivo(&arquivoBin, &mapa, 1)) {
+        liberaDicionario(header.dicionario);
+        return;
+    }
+
+    if (SelectFromWhereHash_Linha(nomeArquivoBin, &header, &mapa, campo, valor)) {
+        desmapeiaArquivo(&mapa);
+        fclose(arquivoBin);
+        liberaDicionario(header.dicionario);
+        return;
+    }
+
+    // a cor codificada é comparada pelo código, sem olhar o texto de cada registro
+    int codigo = -1;
+    if (header.dicionario != NULL && headerPos == 3 && valor[0] != '\0') {
+        codigo = procuraDicionario(header.dicionario, 0, valor, (int)strlen(valor));
+        if (codigo == -1) codigo = CODIGO_AUSENTE_DICIONARIO;
+    }
 
-        if (existe) {  // dado encontrado
-            imprimeLinha(linhaTemp, header, 1);
-            existePeloMenosUm = 1;
+    consultaLinha consulta = {&header, headerPos, valor, valorInteiro, codigo};
+
+    if (header.formato == FORMATO_BLOCOS) {
+        // cada bloco tem o diretório dos seus registros, então o arquivo pode ser dividido entre threads
+        char* blocosPossiveis = blocosPossiveis_Linha(nomeArquivoBin, &mapa, &consulta);
+        existePeloMenosUm = varreBlocosParalelo(&mapa, TAMANHO_HEADER_LINHA, avaliaConsultaLinha, &consulta,
+                                                headerPos == 0, blocosPossiveis);  //como o codLinha é unico basta o primeiro
+        free(blocosPossiveis);
+    } else {
+        posicionaPrimeiraLinha(&mapa);  // posiciono para o primeiro registro de dados do binario
+
+        visaoLinha linhaTemp;  // a cada iteração a visão aponta para os
+                               // valores de um registro do binario
+
+        while (total--) {  // percorro todos registros de dados
+            lerLinha_Mapa(&mapa, header.dicionario, &linhaTemp, -1);
+
+            if (atendeConsultaLinha(&linhaTemp, &consulta)) {  // dado encontrado
+                imprimeVisaoLinha(&linhaTemp, &header, 1);
+                existePeloMenosUm = 1;
+                if (headerPos == 0) break;  //como o codLinha é unico pode interromper assim que encontrar o primeiro
+            }
         }
     }
 
     if (!existePeloMenosUm) printf("Registro inexistente.\n");  // nenhum registro encontrado
 
+    desmapeiaArquivo(&mapa);
     fclose(arquivoBin);
+    liberaDicionario(header.dicionario);
 }
 
 /**
@@ -392,20 +994,33 @@ void InsertInto_Linha(char nomeArquivoBin[100], int numeroDeEntradas) {
         return;
     }
 
-    lerHeaderBin_Linha(arquivoBin, &header);
+    lerHeaderBin_Linha(arquivoBin, nomeArquivoBin, &header);
     if (!validaHeader_linha(&arquivoBin, header, 1, 0)) return;
 
+    listaEspacoLivre* livres = carregaEspacoLivre_Linha(arquivoBin, nomeArquivoBin);
+    mapaZonas* zonas = carregaZonas_Linha(nomeArquivoBin, &header);
+
     header.status = '0';
     salvaHeader_Linha(arquivoBin, &header);
 
+    // os registros novos são acumulados e gravados em lotes no fim do arquivo
+    bufferEscrita buffer;
+    iniciaBufferEscritaFormato(&buffer, arquivoBin, header.formato, TAMANHO_HEADER_LINHA, header.byteProxReg);
+
     while (numeroDeEntradas--) {
         lerLinha_Terminal(&novaLinha);
-        salvaLinha(arquivoBin, &novaLinha, &header);  // salvo o novo veículo no fim do binário
+        salvaLinhaBuffer(&buffer, &novaLinha, &header, livres, zonas);  // salvo a nova linha em um removido ou no fim do binário
     }
 
+    descarregaBufferEscrita(&buffer);
+
     header.status = '1';
     salvaHeader_Linha(arquivoBin, &header);
     fclose(arquivoBin);
+    finalizaEspacoLivre_Linha(livres, nomeArquivoBin);
+    removeIndicesHash_Linha(nomeArquivoBin);
+    finalizaZonas_Linha(zonas, nomeArquivoBin);
+    finalizaDicionario_Linha(&header, nomeArquivoBin);  // novos valores ganham códigos
     binarioNaTela(nomeArquivoBin);
 }
 
@@ -421,11 +1036,17 @@ void CreateIndex_Linha(char nomeArquivoBinRegistros[100], char nomeArquivoBinInd
     linhaHeader novoHeader;
     linha novaLinha;
 
-    lerHeaderBin_Linha(arquivoBinRegistros, &novoHeader);
+    lerHeaderBin_Linha(arquivoBinRegistros, nomeArquivoBinRegistros, &novoHeader);
     if (!validaHeader_linha(&arquivoBinRegistros, novoHeader, 1, 0)) return;
 
     arvore* novaArvore = criaArvore(nomeArquivoBinIndex);
 
+    if (novaArvore == NULL) {
+        fclose(arquivoBinRegistros);
+        liberaDicionario(novoHeader.dicionario);
+        return;
+    }
+
     alteraStatusArvore(novaArvore);
 
     int isFinalDoArquivo = finalDoArquivo(arquivoBinRegistros);
@@ -438,17 +1059,167 @@ void CreateIndex_Linha(char nomeArquivoBinRegistros[100], char nomeArquivoBinInd
         novoRegistro.P_prox = -1;
         novoRegistro.Pr = ftell(arquivoBinRegistros);
 
-        isFinalDoArquivo = lerLinha_Bin(arquivoBinRegistros, &novaLinha, -1);
+        isFinalDoArquivo = lerLinha_Bin(arquivoBinRegistros, novoHeader.dicionario, &novaLinha, -1);
         novoRegistro.C = novaLinha.codLinha;
 
         if (novaLinha.removido == '1') insereRegistro(novaArvore, novoRegistro);
     }
 
     fclose(arquivoBinRegistros);
+    liberaDicionario(novoHeader.dicionario);
+    finalizaArvore(novaArvore);
+    binarioNaTela(nomeArquivoBinIndex);
+}
+
+/**
+ *  Constroi um index paginado de uma só vez, a partir de todos os registros ordenados
+ * @param nomeArquivoBinRegistros nome do arquivo binário dos registros
+ * @param nomeArquivoBinIndex nome do arquivo binário contendo os indices
+ * @param fatorPreenchimento fração de cada nó da arvore que será ocupada
+ * @param arvoreMais 1 para construir uma arvore B+ e 0 para uma arvore B
+ */
+void constroiIndexEmLote_Linha(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100], double fatorPreenchimento, int arvoreMais) {
+    FILE* arquivoBinRegistros;
+    if (!abrirArquivo(&arquivoBinRegistros, nomeArquivoBinRegistros, "rb", 1)) return;
+
+    linhaHeader novoHeader;
+    visaoLinha novaLinha;
+    arquivoMapeado mapa;
+
+    lerHeaderBin_Linha(arquivoBinRegistros, nomeArquivoBinRegistros, &novoHeader);
+    if (!validaHeader_linha(&arquivoBinRegistros, novoHeader, 1, 0)) return;
+    if (!mapeiaArquivo(&arquivoBinRegistros, &mapa, 1)) {
+        liberaDicionario(novoHeader.dicionario);
+        return;
+    }
+
+    int capacidade = novoHeader.nroRegistros + 1;
+    int quantidade = 0;
+    registro* registros = (registro*)malloc(capacidade * sizeof(registro));
+
+    int isFinalDoArquivo = posicionaPrimeiraLinha(&mapa);
+
+    //percorre todo o arquivo coletando a chave e o byteOffset dos registros salvos
+    while (!isFinalDoArquivo) {
+        long int byteOffset = mapa.posicao;
+        isFinalDoArquivo = lerLinha_Mapa(&mapa, novoHeader.dicionario, &novaLinha, -1);
+        if (novaLinha.removido != '1') continue;
+
+        if (quantidade == capacidade) {
+            capacidade *= 2;
+            registros = (registro*)realloc(registros, capacidade * sizeof(registro));
+        }
+
+        registros[quantidade].P_ant = -1;
+        registros[quantidade].P_prox = -1;
+        registros[quantidade].Pr = byteOffset;
+        registros[quantidade].C = novaLinha.codLinha;
+        quantidade++;
+    }
+
+    desmapeiaArquivo(&mapa);
+    fclose(arquivoBinRegistros);
+    liberaDicionario(novoHeader.dicionario);
+
+    arvore* novaArvore = arvoreMais ? criaArvoreMais(nomeArquivoBinIndex) : criaArvorePaginada(nomeArquivoBinIndex);
+
+    if (novaArvore == NULL) {
+        free(registros);
+        return;
+    }
+
+    alteraStatusArvore(novaArvore);
+
+    constroiArvoreEmLote(novaArvore, registros, quantidade, fatorPreenchimento);
+
+    free(registros);
     finalizaArvore(novaArvore);
     binarioNaTela(nomeArquivoBinIndex);
 }
 
+/**
+ *  Cria um index no formato paginado construindo a arvore B de uma só vez, a partir de todos os registros ordenados
+ * @param nomeArquivoBinRegistros nome do arquivo binário dos registros
+ * @param nomeArquivoBinIndex nome do arquivo binário contendo os indices
+ * @param fatorPreenchimento fração de cada nó da arvore que será ocupada
+ */
+void CreateIndexEmLote_Linha(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100], double fatorPreenchimento) {
+    constroiIndexEmLote_Linha(nomeArquivoBinRegistros, nomeArquivoBinIndex, fatorPreenchimento, 0);
+}
+
+/**
+ *  Cria um index de arvore B+ sobre o codLinha, com as folhas encadeadas para buscas por intervalo
+ * @param nomeArquivoBinRegistros nome do arquivo binário dos registros
+ * @param nomeArquivoBinIndex nome do arquivo binário contendo os indices
+ * @param fatorPreenchimento fração de cada nó da arvore que será ocupada
+ */
+void CreateIndexArvoreMais_Linha(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100], double fatorPreenchimento) {
+    constroiIndexEmLote_Linha(nomeArquivoBinRegistros, nomeArquivoBinIndex, fatorPreenchimento, 1);
+}
+
+/**
+ *  Imprime, em ordem de codLinha, todas as linhas com codLinha no intervalo [minimo, maximo]
+ *  percorrendo as folhas encadeadas de um index de arvore B+
+ * @param nomeArquivoBinRegistros nome do arquivo binário dos registros
+ * @param nomeArquivoBinIndex nome do arquivo binário contendo os indices
+ * @param minimo menor codLinha do intervalo
+ * @param maximo maior codLinha do intervalo
+ */
+void SelectFromWhereIntervalo_Linha(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100], int minimo, int maximo) {
+    FILE* arquivoBinRegistros;
+    if (!abrirArquivo(&arquivoBinRegistros, nomeArquivoBinRegistros, "rb", 1)) return;
+
+    linhaHeader header;
+    visaoLinha linhaTemp;
+    arquivoMapeado mapa;
+
+    lerHeaderBin_Linha(arquivoBinRegistros, nomeArquivoBinRegistros, &header);
+    if (!validaHeader_linha(&arquivoBinRegistros, header, 1, 1)) return;
+
+    arvore* novaArvore = carregaArvore(nomeArquivoBinIndex);
+
+    if (novaArvore == NULL) {
+        fclose(arquivoBinRegistros);
+        liberaDicionario(header.dicionario);
+        return;
+    }
+
+    // só a arvore B+ tem as folhas encadeadas
+    if (novaArvore->header.versao != VERSAO_ARVORE_MAIS) {
+        printf("Falha no processamento do arquivo.");
+        fclose(arquivoBinRegistros);
+        liberaDicionario(header.dicionario);
+        finalizaArvore(novaArvore);
+        return;
+    }
+
+    if (!mapeiaArquivo(&arquivoBinRegistros, &mapa, 1)) {
+        finalizaArvore(novaArvore);
+        liberaDicionario(header.dicionario);
+        return;
+    }
+
+    iteradorArvore iterador;
+    int chave;
+    long int byteOffset;
+    int existePeloMenosUm = 0;
+
+    posicionaIterador(novaArvore, &iterador, minimo);
+    while (proximoIterador(&iterador, &chave, &byteOffset) && chave <= maximo) {
+        lerLinha_Mapa(&mapa, header.dicionario, &linhaTemp, byteOffset);
+        imprimeVisaoLinha(&linhaTemp, &header, 1);
+        existePeloMenosUm = 1;
+    }
+    finalizaIterador(&iterador);
+
+    if (!existePeloMenosUm) printf("Registro inexistente.\n");
+
+    desmapeiaArquivo(&mapa);
+    fclose(arquivoBinRegistros);
+    liberaDicionario(header.dicionario);
+    finalizaArvore(novaArvore);
+}
+
 /**
  *  Busca um registro recursivamente a partir da arvore B
  * @param nomeArquivoBinRegistros nome do arquivo binário dos registros
@@ -462,13 +1233,14 @@ void SelectFromWithIndex_Linha(char nomeArquivoBinRegistros[100], char nomeArqui
     linhaHeader novoHeader;
     linha novaLinha;
 
-    lerHeaderBin_Linha(arquivoBinRegistros, &novoHeader);
+    lerHeaderBin_Linha(arquivoBinRegistros, nomeArquivoBinRegistros, &novoHeader);
     if (!validaHeader_linha(&arquivoBinRegistros, novoHeader, 1, 1)) return;
 
     arvore* novaArvore = carregaArvore(nomeArquivoBinIndex);
     
     if (novaArvore == NULL) {
         fclose(arquivoBinRegistros);
+        liberaDicionario(novoHeader.dicionario);
         return;
     }
 
@@ -477,13 +1249,14 @@ void SelectFromWithIndex_Linha(char nomeArquivoBinRegistros[100], char nomeArqui
 
     // testa se encontrou o registro
     if (byteOffset != -1) {
-        lerLinha_Bin(arquivoBinRegistros, &novaLinha, byteOffset);
+        lerLinha_Bin(arquivoBinRegistros, novoHeader.dicionario, &novaLinha, byteOffset);
         imprimeLinha(novaLinha, novoHeader, 1);
     } else {
         printf("Registro inexistente.");
     }
 
     fclose(arquivoBinRegistros);
+    liberaDicionario(novoHeader.dicionario);
     finalizaArvore(novaArvore);
 }
 
@@ -500,21 +1273,29 @@ void InsertIntoWithIndex_Linha(char nomeArquivoBinRegistros[100], char nomeArqui
 
     linhaHeader header;
 
-    lerHeaderBin_Linha(arquivoBinRegistros, &header);
+    lerHeaderBin_Linha(arquivoBinRegistros, nomeArquivoBinRegistros, &header);
     if (!validaHeader_linha(&arquivoBinRegistros, header, 1, 0)) return;
 
     arvore* novaArvore = carregaArvore(nomeArquivoBinIndex);
 
     if (novaArvore == NULL) {
         fclose(arquivoBinRegistros);
+        liberaDicionario(header.dicionario);
         return;
     }
 
+    listaEspacoLivre* livres = carregaEspacoLivre_Linha(arquivoBinRegistros, nomeArquivoBinRegistros);
+    mapaZonas* zonas = carregaZonas_Linha(nomeArquivoBinRegistros, &header);
+
     alteraStatusArvore(novaArvore);
 
     header.status = '0';
     salvaHeader_Linha(arquivoBinRegistros, &header);
 
+    // os registros novos são acumulados e gravados em lotes no fim do arquivo
+    bufferEscrita buffer;
+    iniciaBufferEscritaFormato(&buffer, arquivoBinRegistros, header.formato, TAMANHO_HEADER_LINHA, header.byteProxReg);
+
     linha novaLinha;
 
     while (numeroDeEntradas--) {        // le n linhas
@@ -525,23 +1306,137 @@ void InsertIntoWithIndex_Linha(char nomeArquivoBinRegistros[100], char nomeArqui
         novoRegistro.P_ant = -1;
         novoRegistro.P_prox = -1;
 
-        novoRegistro.Pr = header.byteProxReg;  // pega o byteoffset de onde a nova linha vai estar
-
-        salvaLinha(arquivoBinRegistros, &novaLinha, &header);  // salva a linha no fim do arquivo de dados
+        novoRegistro.Pr = salvaLinhaBuffer(&buffer, &novaLinha, &header, livres, zonas);  // salva e pega o byteoffset de onde a nova linha ficou
 
         novoRegistro.C = novaLinha.codLinha;
 
         if (novaLinha.removido == '1') insereRegistro(novaArvore, novoRegistro);  // insere o novo registro lido na árvore B
     }
+    descarregaBufferEscrita(&buffer);
+
     // procedimento padrão de fechamento dos arquivos
     header.status = '1';
     salvaHeader_Linha(arquivoBinRegistros, &header);
 
     fclose(arquivoBinRegistros);
+    finalizaEspacoLivre_Linha(livres, nomeArquivoBinRegistros);
+    removeIndicesHash_Linha(nomeArquivoBinRegistros);
+    finalizaZonas_Linha(zonas, nomeArquivoBinRegistros);
+    finalizaDicionario_Linha(&header, nomeArquivoBinRegistros);  // novos valores ganham códigos
     finalizaArvore(novaArvore);
     binarioNaTela(nomeArquivoBinIndex);
 }
 
+/**
+ *  Reescreve o arquivo de linhas sem os registros removidos, copiando os demais em sequência,
+ *  e troca os byteOffsets da arvore B do codLinha pela tabela de byteOffsets antigos e novos
+ * @param nomeArquivoBin nome do arquivo binário dos registros
+ * @param nomeArquivoBinIndex nome do arquivo binário contendo os indices
+ */
+void Vacuum_Linha(char nomeArquivoBin[100], char nomeArquivoBinIndex[100]) {
+    FILE* arquivoBin;
+    if (!abrirArquivo(&arquivoBin, nomeArquivoBin, "rb", 1)) return;
+
+    linhaHeader header;
+    visaoLinha linhaTemp;
+    arquivoMapeado mapa;
+
+    lerHeaderBin_Linha(arquivoBin, nomeArquivoBin, &header);
+    if (!validaHeader_linha(&arquivoBin, header, 1, 0)) return;
+
+    arvore* novaArvore = carregaArvore(nomeArquivoBinIndex);
+
+    if (novaArvore == NULL) {
+        fclose(arquivoBin);
+        liberaDicionario(header.dicionario);
+        return;
+    }
+
+    char nomeArquivoCompactado[256];
+    sprintf(nomeArquivoCompactado, "%s.compactado", nomeArquivoBin);
+
+    FILE* arquivoCompactado;
+    if (!abrirArquivo(&arquivoCompactado, nomeArquivoCompactado, "wb", 1)) {
+        fclose(arquivoBin);
+        liberaDicionario(header.dicionario);
+        finalizaArvore(novaArvore);
+        return;
+    }
+
+    if (!mapeiaArquivo(&arquivoBin, &mapa, 1)) {
+        fclose(arquivoCompactado);
+        liberaDicionario(header.dicionario);
+        remove(nomeArquivoCompactado);
+        finalizaArvore(novaArvore);
+        return;
+    }
+
+    linhaHeader novoHeader = header;
+    novoHeader.status = '0';
+    novoHeader.byteProxReg = 82;
+    novoHeader.nroRegistros = 0;
+    novoHeader.nroRegRemovidos = 0;
+    salvaHeader_Linha(arquivoCompactado, &novoHeader);
+
+    bufferEscrita buffer;
+    iniciaBufferEscritaFormato(&buffer, arquivoCompactado, novoHeader.formato, TAMANHO_HEADER_LINHA, novoHeader.byteProxReg);
+
+    // os byteOffsets antigos ficam em ordem crescente, o que permite a busca binária no remapeamento
+    int capacidade = header.nroRegistros + 1;
+    int quantidade = 0;
+    long int* antigos = (long int*)malloc(capacidade * sizeof(long int));
+    long int* novos = (long int*)malloc(capacidade * sizeof(long int));
+
+    int isFinalDoArquivo = posicionaPrimeiraLinha(&mapa);
+
+    while (!isFinalDoArquivo) {
+        long int byteOffset = mapa.posicao;
+        isFinalDoArquivo = lerLinha_Mapa(&mapa, header.dicionario, &linhaTemp, -1);
+        if (linhaTemp.removido != '1') continue;
+
+        if (quantidade == capacidade) {
+            capacidade *= 2;
+            antigos = (long int*)realloc(antigos, capacidade * sizeof(long int));
+            novos = (long int*)realloc(novos, capacidade * sizeof(long int));
+        }
+        // a sobra de um registro salvo no espaço de um removido maior também é descartada
+        int tamanho = 5 + linhaTemp.tamanhoRegistro;
+        char* destino = reservaBufferEscrita(&buffer, tamanho);
+        memcpy(destino, mapa.dados + byteOffset, tamanho);
+        memcpy(destino + 1, &linhaTemp.tamanhoRegistro, sizeof(int));
+
+        antigos[quantidade] = byteOffset;
+        novos[quantidade] = posicaoLivreBufferEscrita(&buffer);
+        quantidade++;
+
+        confirmaBufferEscrita(&buffer, tamanho);
+        novoHeader.byteProxReg = posicaoLivreBufferEscrita(&buffer);
+        novoHeader.nroRegistros++;
+    }
+
+    descarregaBufferEscrita(&buffer);
+    desmapeiaArquivo(&mapa);
+    fclose(arquivoBin);
+    liberaDicionario(header.dicionario);
+
+    novoHeader.status = '1';
+    salvaHeader_Linha(arquivoCompactado, &novoHeader);
+    fclose(arquivoCompactado);
+
+    // o indice fica inconsistente até ser remapeado
+    alteraStatusArvore(novaArvore);
+    rename(nomeArquivoCompactado, nomeArquivoBin);
+    removeIndicesHash_Linha(nomeArquivoBin);
+    remapeiaByteOffsets(novaArvore, antigos, novos, quantidade);
+    finalizaArvore(novaArvore);
+
+    free(antigos);
+    free(novos);
+
+    binarioNaTela(nomeArquivoBin);
+    binarioNaTela(nomeArquivoBinIndex);
+}
+
 /**
  * Cria um arquivo binário com os registros ordenados a partir de um binário desordenado
  * @param nomeArquivoBinDesordenado nome do arquivo bin fonte dos dados
@@ -556,13 +1451,18 @@ int SortReg_Linha(char nomeArquivoBinDesordenado[100], char nomeArquivoBin[100])
 
     linhaHeader header;
 
-    lerHeaderBin_Linha(arquivoBinDesordenado, &header);
+    lerHeaderBin_Linha(arquivoBinDesordenado, nomeArquivoBinDesordenado, &header);
     if (!validaHeader_linha(&arquivoBinDesordenado, header, 1, 0)) return 0;
 
-    abrirArquivo(&arquivoBinOrdenado, nomeArquivoBin, "wb", 0);
+    if (!abrirArquivo(&arquivoBinOrdenado, nomeArquivoBin, "wb", 1)) {
+        fclose(arquivoBinDesordenado);
+        liberaDicionario(header.dicionario);
+        return 0;
+    }
 
     linhaHeader novoHeader = header;
     linha novaLinha;
+    char registroCodificado[sizeof(linha)];
 
     //definindo valores iniciais do header
     novoHeader.status = '0';
@@ -574,21 +1474,55 @@ int SortReg_Linha(char nomeArquivoBinDesordenado[100], char nomeArquivoBin[100])
 
     int isFinalDoArquivo = finalDoArquivo(arquivoBinDesordenado);
 
-    //aloca array para salvar os dados
-    linha* arrayDeLinhas = malloc(header.nroRegistros * sizeof(linha));
-    int posAtual = 0;
+    // caso os registros não caibam na memória configurada eles são ordenados em corridas no disco
+    // cada registro ocupa na memória só os seus bytes no formato do arquivo, e não a struct inteira
+    long int memoria = lerConfiguracao("MEMORIA_ORDENACAO", MEMORIA_ORDENACAO);
+    ordenadorRegistros* ordenadorLinhas = criaOrdenadorRegistros(memoria);
 
+    iniciaFase("leitura");
     //percorre o arquivo até o final
     while (!isFinalDoArquivo) {
-        isFinalDoArquivo = lerLinha_Bin(arquivoBinDesordenado, &novaLinha, -1);
-        if (novaLinha.removido == '1') arrayDeLinhas[posAtual++] = novaLinha;
+        isFinalDoArquivo = lerLinha_Bin(arquivoBinDesordenado, header.dicionario, &novaLinha, -1);
+        if (novaLinha.removido == '1') {
+            int tamanhoCodificado = codificaLinha(registroCodificado, header.dicionario, &novaLinha);
+            adicionaRegistro(ordenadorLinhas, novaLinha.codLinha, registroCodificado, tamanhoCodificado);
+        }
     }
-    
-    qsort(arrayDeLinhas, header.nroRegistros, sizeof(linha), compararLinhas);
-    
-    //salva os registros já ordenados
-    for (int i = 0; i < header.nroRegistros; i++) {
-        salvaLinha(arquivoBinOrdenado, &arrayDeLinhas[i], &novoHeader);
+    encerraFase();
+
+    iniciaFase("ordenacao");
+    ordenaRegistros(ordenadorLinhas);
+    encerraFase();
+
+    iniciaFase("escrita");
+    // os registros já estão no formato do arquivo e são só copiados
+    bufferEscrita buffer;
+    iniciaBufferEscritaFormato(&buffer, arquivoBinOrdenado, novoHeader.formato, TAMANHO_HEADER_LINHA, novoHeader.byteProxReg);
+    char* registroOrdenado;
+    int tamanho;
+    while (proximoRegistro(ordenadorLinhas, &registroOrdenado, &tamanho)) {
+        char* destino = reservaBufferEscrita(&buffer, tamanho);
+        memcpy(destino, registroOrdenado, tamanho);
+        confirmaBufferEscrita(&buffer, tamanho);
+
+        novoHeader.byteProxReg = posicaoLivreBufferEscrita(&buffer);
+        novoHeader.nroRegistros++;
+    }
+    descarregaBufferEscrita(&buffer);
+    encerraFase();
+
+    // uma corrida que não pôde ser criada, gravada ou lida, ou uma escrita que falhou, como com o disco cheio,
+    // deixa o arquivo ordenado incompleto, com status '0'
+    if (ordenadorLinhas->falha || fflush(arquivoBinOrdenado) != 0 || ferror(arquivoBinOrdenado)) {
+        printf("Falha no processamento do arquivo.");
+        fclose(arquivoBinOrdenado);
+        fclose(arquivoBinDesordenado);
+        removeListaEspacoLivre(nomeArquivoBin);
+        removeIndicesHash_Linha(nomeArquivoBin);
+        removeDicionario(nomeArquivoBin);
+        liberaDicionario(header.dicionario);
+        finalizaOrdenadorRegistros(ordenadorLinhas);
+        return 0;
     }
 
     novoHeader.status = '1';
@@ -598,7 +1532,14 @@ int SortReg_Linha(char nomeArquivoBinDesordenado[100], char nomeArquivoBin[100])
     //fecha todos arquivos abertos e libera memória
     fclose(arquivoBinOrdenado);
     fclose(arquivoBinDesordenado);
-    free(arrayDeLinhas);
+    removeListaEspacoLivre(nomeArquivoBin);
+    removeIndicesHash_Linha(nomeArquivoBin);
+    if (header.dicionario != NULL)
+        salvaDicionario(header.dicionario, nomeArquivoBin);  // o arquivo ordenado usa os códigos do desordenado
+    else
+        removeDicionario(nomeArquivoBin);
+    liberaDicionario(header.dicionario);
+    finalizaOrdenadorRegistros(ordenadorLinhas);
     return 1;
 }
 
@@ -611,24 +1552,52 @@ void Search_LinhaVeiculo(char nomeArquivoVeiculos[100], char nomeArquivoLinha[10
     FILE* arquivoBinLinhas;
     FILE* arquivoBinVeiculos;
 
-    if (!abrirArquivo(&arquivoBinLinhas, nomeArquivoLinha, "r", 1)) return;
-    if (!abrirArquivo(&arquivoBinVeiculos, nomeArquivoVeiculos, "r", 1)) return;
-
     linhaHeader headerLinha;
     veiculoHeader headerVeiculo;
 
-    lerHeaderBin_Linha(arquivoBinLinhas, &headerLinha);
+    if (!abrirArquivo(&arquivoBinLinhas, nomeArquivoLinha, "r", 1)) return;
+
+    lerHeaderBin_Linha(arquivoBinLinhas, nomeArquivoLinha, &headerLinha);
     if (!validaHeader_linha(&arquivoBinLinhas, headerLinha, 1, 1)) return;
 
-    lerHeaderBin_Veiculo(arquivoBinVeiculos, &headerVeiculo);
-    if (!validaHeader_veiculo(&arquivoBinVeiculos, headerVeiculo, 1, 1)) return;
+    if (!abrirArquivo(&arquivoBinVeiculos, nomeArquivoVeiculos, "r", 1)) {
+        fclose(arquivoBinLinhas);
+        liberaDicionario(headerLinha.dicionario);
+        return;
+    }
 
-    linha novaLinha;
-    veiculo novoVeiculo;
+    lerHeaderBin_Veiculo(arquivoBinVeiculos, nomeArquivoVeiculos, &headerVeiculo);
+    if (!validaHeader_veiculo(&arquivoBinVeiculos, headerVeiculo, 1, 1)) {
+        fclose(arquivoBinLinhas);
+        liberaDicionario(headerLinha.dicionario);
+        return;
+    }
+
+    arquivoMapeado mapaLinhas;
+    arquivoMapeado mapaVeiculos;
+
+    if (!mapeiaArquivo(&arquivoBinLinhas, &mapaLinhas, 1)) {
+        fclose(arquivoBinVeiculos);
+        liberaDicionario(headerLinha.dicionario);
+        liberaDicionario(headerVeiculo.dicionario);
+        return;
+    }
+    if (!mapeiaArquivo(&arquivoBinVeiculos, &mapaVeiculos, 1)) {
+        desmapeiaArquivo(&mapaLinhas);
+        fclose(arquivoBinLinhas);
+        liberaDicionario(headerLinha.dicionario);
+        liberaDicionario(headerVeiculo.dicionario);
+        return;
+    }
+
+    visaoLinha novaLinha;
+    visaoVeiculo novoVeiculo;
     int achouPeloMenosUm = 0;
 
-    lerLinha_Bin(arquivoBinLinhas, &novaLinha, -1);
-    lerVeiculo_Bin(arquivoBinVeiculos, &novoVeiculo, -1);
+    posicionaPrimeiraLinha(&mapaLinhas);
+    posicionaPrimeiroVeiculo(&mapaVeiculos);
+    lerLinha_Mapa(&mapaLinhas, headerLinha.dicionario, &novaLinha, -1);
+    lerVeiculo_Mapa(&mapaVeiculos, headerVeiculo.dicionario, &novoVeiculo, -1);
 
     int qtdVeiculos = headerVeiculo.nroRegistros;
     int qtdLinhas = headerLinha.nroRegistros;
@@ -636,16 +1605,16 @@ void Search_LinhaVeiculo(char nomeArquivoVeiculos[100], char nomeArquivoLinha[10
     //percorre o arquivo até o final
     while (qtdVeiculos && qtdLinhas) {
         if (novaLinha.codLinha == novoVeiculo.codLinha) {
-            imprimeVeiculo(novoVeiculo, headerVeiculo, 0);
-            imprimeLinha(novaLinha, headerLinha, 1);
-            lerVeiculo_Bin(arquivoBinVeiculos, &novoVeiculo, -1);
+            imprimeVisaoVeiculo(&novoVeiculo, &headerVeiculo, 0);
+            imprimeVisaoLinha(&novaLinha, &headerLinha, 1);
+            lerVeiculo_Mapa(&mapaVeiculos, headerVeiculo.dicionario, &novoVeiculo, -1);
             qtdVeiculos--;
             achouPeloMenosUm = 1;
         } else if (novaLinha.codLinha < novoVeiculo.codLinha) {
-            lerLinha_Bin(arquivoBinLinhas, &novaLinha, -1);
+            lerLinha_Mapa(&mapaLinhas, headerLinha.dicionario, &novaLinha, -1);
             qtdLinhas--;
         } else {
-            lerVeiculo_Bin(arquivoBinVeiculos, &novoVeiculo, -1);
+            lerVeiculo_Mapa(&mapaVeiculos, headerVeiculo.dicionario, &novoVeiculo, -1);
             qtdVeiculos--;
         }
     }
@@ -653,6 +1622,10 @@ void Search_LinhaVeiculo(char nomeArquivoVeiculos[100], char nomeArquivoLinha[10
     if (!achouPeloMenosUm) printf("Registro inexistente.");
 
     //fecha todos arquivos abertos
+    desmapeiaArquivo(&mapaLinhas);
+    desmapeiaArquivo(&mapaVeiculos);
     fclose(arquivoBinLinhas);
     fclose(arquivoBinVeiculos);
+    liberaDicionario(headerLinha.dicionario);
+    liberaDicionario(headerVeiculo.dicionario);
 }
\ No newline at end of file
@@ -1,6 +1,19 @@
 #ifndef _LINHA_H_
 #define _LINHA_H_
 #include <stdio.h>
+
+#include "../dicionario/dicionario.h"
+#include "../mapeamento/mapeamento.h"
+
+#define TAMANHO_HEADER_LINHA 82
+#define CAMPOS_ZONA_LINHA 1  // codLinha resumido no mapa de zonas
+#define CAMPOS_DICIONARIO_LINHA 1  // corLinha codificada pelo dicionário
+
+/**
+ * formato não é gravado no header, ele é descoberto pelo primeiro byte após o header (ver bloco.h)
+ * dicionario também não, ele é carregado do .dic ao lado do arquivo (NULL quando a cor está por extenso)
+ * e é o que codifica e decodifica os registros desse arquivo
+ */
 typedef struct linhaHeader {
     char status;
     long int byteProxReg;
@@ -10,6 +23,8 @@ typedef struct linhaHeader {
     char descreveCartao[14];
     char descreveNome[14];
     char descreveLinha[25];
+    int formato;
+    dicionario* dicionario;
 } linhaHeader;
 
 typedef struct linha {
@@ -23,18 +38,56 @@ typedef struct linha {
     char corLinha[100];
 } linha;
 
+/**
+ * Visão de uma linha sem cópia dos campos, as strings apontam diretamente para
+ * a região onde o registro está (arquivo mapeado ou struct linha) e não
+ * são necessariamente terminadas em \0, por isso seus tamanhos devem ser respeitados
+ */
+typedef struct visaoLinha {
+    char removido;
+    int tamanhoRegistro;
+    int codLinha;
+    char* aceitaCartao;  // 1 byte
+    int tamanhoNome;
+    char* nomeLinha;
+    int tamanhoCor;
+    char* corLinha;
+    int codigoCor;  // código no dicionário, -1 quando o campo está gravado por extenso
+} visaoLinha;
+
+/**
+ * Condição de uma busca sequencial, campo é a posição do campo no cabeçalho
+ */
+typedef struct consultaLinha {
+    linhaHeader* header;
+    int campo;
+    char* valor;
+    int valorInteiro;
+    int codigo;  // código do valor no dicionário do arquivo, -1 quando a comparação é pelo valor
+} consultaLinha;
+
 void imprimeLinha(linha currLinha, linhaHeader header, int quebraLinha);
+void imprimeVisaoLinha(visaoLinha* currLinha, linhaHeader* header, int quebraLinha);
+int tamanhoSaidaLinha(visaoLinha* currLinha);
+char* formataVisaoLinha(char* destino, visaoLinha* currLinha, linhaHeader* header, int quebraLinha);
+int lerLinha_Mapa(arquivoMapeado* mapa, dicionario* dic, visaoLinha* currL, long int pos);
+int posicionaPrimeiraLinha(arquivoMapeado* mapa);
 int validaHeader_linha(FILE** arquivo, linhaHeader header, int verificaConsistencia, int verificaRegistros);
-int lerLinha_Bin(FILE* arquivoBin, linha* currL, long int pos);
-void lerHeaderBin_Linha(FILE* arquivoBin, linhaHeader* header);
+int lerLinha_Bin(FILE* arquivoBin, dicionario* dic, linha* currL, long int pos);
+void lerHeaderBin_Linha(FILE* arquivoBin, char* nomeArquivoBin, linhaHeader* header);
 
 void SelectFrom_Linha(char nomeArquivoBin[100]);
 void CreateTable_Linha(char nomeArquivoCSV[100], char nomeArquivoBin[100]);
 void SelectFromWhere_Linha(char nomeArquivoBin[100], char* campo, char* valor);
 void InsertInto_Linha(char nomeArquivoBin[100], int numeroDeEntradas);
 void CreateIndex_Linha(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100]);
+void CreateIndexEmLote_Linha(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100], double fatorPreenchimento);
+void CreateIndexHash_Linha(char nomeArquivoBin[100], char* campo);
+void CreateIndexArvoreMais_Linha(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100], double fatorPreenchimento);
+void SelectFromWhereIntervalo_Linha(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100], int minimo, int maximo);
 void SelectFromWithIndex_Linha(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100], int valorBusca);
 void InsertIntoWithIndex_Linha(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100], int numeroDeEntradas);
+void Vacuum_Linha(char nomeArquivoBin[100], char nomeArquivoBinIndex[100]);
 int SortReg_Linha(char nomeArquivoBinDesordenado[100], char nomeArquivoBin[100]);
 void Search_LinhaVeiculo(char nomeArquivoVeiculos[100], char nomeArquivoLinha[100]);
 
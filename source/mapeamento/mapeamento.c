@@ -0,0 +1,132 @@
+#include "mapeamento.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../estatisticas/estatisticas.h"
+
+/**
+ * Mapeia o conteúdo de um arquivo aberto para a memória
+ * caso o mmap não seja possivel o arquivo é lido inteiro para um buffer alocado
+ * @param arquivo arquivo já aberto para leitura
+ * @param mapa variável onde o mapeamento será salvo
+ * @param acessoSequencial flag que indica que o arquivo será percorrido do inicio ao fim
+ * @return retorna 1 caso consiga mapear e 0 caso contrário
+ */
+int mapeiaConteudo(FILE* arquivo, arquivoMapeado* mapa, int acessoSequencial) {
+    struct stat informacoes;
+
+    mapa->dados = NULL;
+    mapa->tamanho = 0;
+    mapa->posicao = 0;
+    mapa->mapeado = 0;
+
+    if (fstat(fileno(arquivo), &informacoes) != 0) return 0;
+    mapa->tamanho = informacoes.st_size;
+    if (mapa->tamanho == 0) return 1;
+    CONTA(bytesMapeados, mapa->tamanho);
+
+    void* regiao = mmap(NULL, mapa->tamanho, PROT_READ, MAP_PRIVATE, fileno(arquivo), 0);
+
+    if (regiao != MAP_FAILED) {
+        mapa->dados = (char*)regiao;
+        mapa->mapeado = 1;
+        if (acessoSequencial) madvise(regiao, mapa->tamanho, MADV_SEQUENTIAL);
+        return 1;
+    }
+
+    // não foi possivel mapear, então o arquivo é lido de uma vez
+    mapa->dados = (char*)malloc(mapa->tamanho);
+    fseek(arquivo, 0, SEEK_SET);
+    if (mapa->dados == NULL || fread(mapa->dados, sizeof(char), mapa->tamanho, arquivo) < (size_t)mapa->tamanho) {
+        free(mapa->dados);
+        mapa->dados = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Mapeia um arquivo para a memória, caso falhe o arquivo é fechado e a mensagem de erro é impressa
+ * @param arquivo ponteiro para o arquivo já aberto para leitura
+ * @param mapa variável onde o mapeamento será salvo
+ * @param acessoSequencial flag que indica que o arquivo será percorrido do inicio ao fim
+ * @return retorna 1 caso consiga mapear e 0 caso contrário
+ */
+int mapeiaArquivo(FILE** arquivo, arquivoMapeado* mapa, int acessoSequencial) {
+    if (mapeiaConteudo(*arquivo, mapa, acessoSequencial)) return 1;
+
+    printf("Falha no processamento do arquivo.");
+    fclose(*arquivo);
+    return 0;
+}
+
+/**
+ * Libera a região usada pelo mapeamento
+ * @param mapa mapeamento a ser liberado
+ */
+void desmapeiaArquivo(arquivoMapeado* mapa) {
+    if (mapa->dados == NULL) return;
+
+    if (mapa->mapeado)
+        munmap(mapa->dados, mapa->tamanho);
+    else
+        free(mapa->dados);
+
+    mapa->dados = NULL;
+}
+
+/**
+ * Determina se a leitura sequencial chegou ao final do arquivo
+ * @param mapa mapeamento a ser testado
+ * @return retorna 1 caso seja o final e 0 caso não seja
+ */
+int fimDoMapa(arquivoMapeado* mapa) {
+    return mapa->posicao >= mapa->tamanho;
+}
+
+/**
+ * Testa se ainda existem bytes suficientes a partir da posição atual
+ * @param mapa mapeamento a ser testado
+ * @param quantidade quantidade de bytes necessária
+ * @return retorna 1 caso existam e 0 caso contrário
+ */
+int restamBytesMapa(arquivoMapeado* mapa, long int quantidade) {
+    return quantidade >= 0 && mapa->posicao + quantidade <= mapa->tamanho;
+}
+
+/**
+ * Lê um inteiro da posição atual e avança a posição
+ * @param mapa mapeamento de onde será lido
+ * @return retorna o inteiro lido ou -1 caso não existam bytes suficientes
+ */
+int lerInteiroMapa(arquivoMapeado* mapa) {
+    int inteiroLido = -1;
+    if (!restamBytesMapa(mapa, sizeof(int))) {
+        mapa->posicao = mapa->tamanho;
+        return inteiroLido;
+    }
+    memcpy(&inteiroLido, mapa->dados + mapa->posicao, sizeof(int));
+    mapa->posicao += sizeof(int);
+    return inteiroLido;
+}
+
+/**
+ * Obtém um ponteiro para uma string na posição atual, sem copiá-la, e avança a posição
+ * a string não é terminada em \0, seu tamanho deve ser controlado por quem a usa
+ * @param mapa mapeamento de onde será lida
+ * @param tamanho tamanho da string
+ * @return retorna o ponteiro para o inicio da string ou NULL caso não existam bytes suficientes
+ */
+char* lerStringMapa(arquivoMapeado* mapa, int tamanho) {
+    if (!restamBytesMapa(mapa, tamanho)) {
+        mapa->posicao = mapa->tamanho;
+        return NULL;
+    }
+    char* string = mapa->dados + mapa->posicao;
+    mapa->posicao += tamanho;
+    return string;
+}
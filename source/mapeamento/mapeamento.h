@@ -0,0 +1,25 @@
+#ifndef _MAPEAMENTO_H_
+#define _MAPEAMENTO_H_
+#include <stdio.h>
+
+/**
+ * Região de memória com o conteúdo completo de um arquivo, obtida por mmap
+ * (ou, caso não seja possivel mapear, lida de uma vez para a memória)
+ * posicao é usada pelas leituras sequenciais
+ */
+typedef struct arquivoMapeado {
+    char* dados;
+    long int tamanho;
+    long int posicao;
+    int mapeado;  // 1 caso a região venha do mmap e 0 caso tenha sido alocada
+} arquivoMapeado;
+
+int mapeiaConteudo(FILE* arquivo, arquivoMapeado* mapa, int acessoSequencial);
+int mapeiaArquivo(FILE** arquivo, arquivoMapeado* mapa, int acessoSequencial);
+void desmapeiaArquivo(arquivoMapeado* mapa);
+int fimDoMapa(arquivoMapeado* mapa);
+int restamBytesMapa(arquivoMapeado* mapa, long int quantidade);
+int lerInteiroMapa(arquivoMapeado* mapa);
+char* lerStringMapa(arquivoMapeado* mapa, int tamanho);
+
+#endif
@@ -0,0 +1,576 @@
+#include "ordenacao.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Cria um ordenador vazio
+ * @param tamanhoElemento tamanho em bytes de cada elemento
+ * @param memoria quantidade de bytes que os elementos podem ocupar na memória
+ * @param comparar função de comparação, no mesmo formato da usada pelo qsort
+ * @param ler função que lê um elemento de uma corrida
+ * @param salvar função que salva um elemento em uma corrida
+ * @return ponteiro para o ordenador criado
+ */
+ordenador* criaOrdenador(size_t tamanhoElemento, long int memoria, comparaElementos comparar, leElemento ler, salvaElemento salvar) {
+    ordenador* ord = (ordenador*)malloc(sizeof(ordenador));
+
+    ord->tamanhoElemento = tamanhoElemento;
+    ord->capacidade = (memoria / (long int)tamanhoElemento > 2) ? (int)(memoria / (long int)tamanhoElemento) : 2;
+    ord->alocados = (ord->capacidade < 1024) ? ord->capacidade : 1024;
+    ord->elementos = (char*)malloc(ord->alocados * tamanhoElemento);
+    ord->quantidade = 0;
+    ord->proximo = 0;
+
+    ord->corridas = NULL;
+    ord->nroCorridas = 0;
+    ord->atuais = NULL;
+    ord->heap = NULL;
+    ord->tamanhoHeap = 0;
+    ord->falha = 0;
+
+    ord->comparar = comparar;
+    ord->ler = ler;
+    ord->salvar = salvar;
+
+    return ord;
+}
+
+/**
+ * Descarrega uma corrida recém escrita no disco
+ * @param corrida arquivo da corrida
+ * @return retorna 1 caso todos os elementos tenham sido gravados e 0 caso alguma escrita tenha falhado, como com o disco cheio
+ */
+int corridaGravada(FILE* corrida) {
+    return fflush(corrida) == 0 && !ferror(corrida);
+}
+
+/**
+ * Compara os elementos atuais de duas corridas, empates são decididos pela
+ * ordem das corridas para manter a ordem de chegada dos elementos
+ * @param ord ordenador
+ * @param corridaA indice da primeira corrida
+ * @param corridaB indice da segunda corrida
+ * @return retorna valor negativo caso a corrida A deva sair primeiro
+ */
+int comparaCorridas(ordenador* ord, int corridaA, int corridaB) {
+    int resultado = ord->comparar(ord->atuais + corridaA * ord->tamanhoElemento, ord->atuais + corridaB * ord->tamanhoElemento);
+    return (resultado != 0) ? resultado : corridaA - corridaB;
+}
+
+/**
+ * Desce um elemento do heap até sua posição correta
+ * @param ord ordenador
+ * @param posicao posição do heap a ser corrigida
+ */
+void desceHeap(ordenador* ord, int posicao) {
+    while (1) {
+        int menor = posicao;
+        int esquerda = 2 * posicao + 1;
+        int direita = 2 * posicao + 2;
+
+        if (esquerda < ord->tamanhoHeap && comparaCorridas(ord, ord->heap[esquerda], ord->heap[menor]) < 0) menor = esquerda;
+        if (direita < ord->tamanhoHeap && comparaCorridas(ord, ord->heap[direita], ord->heap[menor]) < 0) menor = direita;
+        if (menor == posicao) return;
+
+        int temp = ord->heap[posicao];
+        ord->heap[posicao] = ord->heap[menor];
+        ord->heap[menor] = temp;
+        posicao = menor;
+    }
+}
+
+/**
+ * Prepara a intercalação de todas as corridas, lendo o primeiro elemento de cada uma
+ * @param ord ordenador
+ */
+void iniciaIntercalacao(ordenador* ord) {
+    free(ord->atuais);
+    free(ord->heap);
+
+    ord->atuais = (char*)malloc(ord->nroCorridas * ord->tamanhoElemento);
+    ord->heap = (int*)malloc(ord->nroCorridas * sizeof(int));
+    ord->tamanhoHeap = 0;
+
+    for (int i = 0; i < ord->nroCorridas; i++) {
+        rewind(ord->corridas[i]);
+        if (ord->ler(ord->corridas[i], ord->atuais + i * ord->tamanhoElemento))
+            ord->heap[ord->tamanhoHeap++] = i;
+        else if (ferror(ord->corridas[i]))
+            ord->falha = 1;
+    }
+
+    for (int i = ord->tamanhoHeap / 2 - 1; i >= 0; i--) desceHeap(ord, i);
+}
+
+/**
+ * Retira o menor elemento entre as corridas sendo intercaladas
+ * @param ord ordenador
+ * @param elemento variável onde o elemento será salvo
+ * @return retorna 1 caso exista um elemento e 0 caso todas as corridas tenham acabado
+ */
+int proximoDaIntercalacao(ordenador* ord, void* elemento) {
+    if (ord->tamanhoHeap == 0) return 0;
+
+    int corrida = ord->heap[0];
+    memcpy(elemento, ord->atuais + corrida * ord->tamanhoElemento, ord->tamanhoElemento);
+
+    // repõe o elemento da corrida que saiu ou a remove do heap caso tenha acabado
+    if (!ord->ler(ord->corridas[corrida], ord->atuais + corrida * ord->tamanhoElemento)) {
+        if (ferror(ord->corridas[corrida])) ord->falha = 1;
+        ord->heap[0] = ord->heap[--ord->tamanhoHeap];
+    }
+    desceHeap(ord, 0);
+
+    return 1;
+}
+
+/**
+ * Intercala todas as corridas existentes em uma única corrida, limitando a quantidade de arquivos abertos
+ * em caso de falha as corridas antigas são mantidas para serem fechadas por finalizaOrdenador
+ * @param ord ordenador
+ */
+void juntaCorridas(ordenador* ord) {
+    FILE* novaCorrida = tmpfile();
+    if (novaCorrida == NULL) {
+        ord->falha = 1;
+        return;
+    }
+    char* elemento = (char*)malloc(ord->tamanhoElemento);
+
+    iniciaIntercalacao(ord);
+    while (proximoDaIntercalacao(ord, elemento)) ord->salvar(novaCorrida, elemento);
+    free(elemento);
+
+    if (ord->falha || !corridaGravada(novaCorrida)) {
+        ord->falha = 1;
+        fclose(novaCorrida);
+        return;
+    }
+
+    for (int i = 0; i < ord->nroCorridas; i++) fclose(ord->corridas[i]);
+
+    ord->corridas[0] = novaCorrida;
+    ord->nroCorridas = 1;
+    ord->tamanhoHeap = 0;
+}
+
+/**
+ * Ordena os elementos em memória e os salva em uma nova corrida
+ * @param ord ordenador
+ */
+void salvaCorrida(ordenador* ord) {
+    if (ord->nroCorridas == MAXIMO_CORRIDAS) juntaCorridas(ord);
+
+    FILE* corrida = ord->falha ? NULL : tmpfile();
+    if (corrida == NULL) {  // os elementos são descartados, a ordenação já não pode ser completa
+        ord->falha = 1;
+        ord->quantidade = 0;
+        return;
+    }
+
+    qsort(ord->elementos, ord->quantidade, ord->tamanhoElemento, ord->comparar);
+    for (int i = 0; i < ord->quantidade; i++) ord->salvar(corrida, ord->elementos + i * ord->tamanhoElemento);
+    ord->quantidade = 0;
+
+    if (!corridaGravada(corrida)) {
+        ord->falha = 1;
+        fclose(corrida);
+        return;
+    }
+
+    ord->corridas = (FILE**)realloc(ord->corridas, (ord->nroCorridas + 1) * sizeof(FILE*));
+    ord->corridas[ord->nroCorridas++] = corrida;
+}
+
+/**
+ * Adiciona um elemento ao ordenador, caso a memória esteja cheia os elementos acumulados viram uma corrida
+ * depois de uma falha os elementos são ignorados
+ * @param ord ordenador
+ * @param elemento elemento a ser copiado para o ordenador
+ */
+void adicionaElemento(ordenador* ord, void* elemento) {
+    if (ord->falha) return;
+    if (ord->quantidade == ord->capacidade) salvaCorrida(ord);
+
+    if (ord->quantidade == ord->alocados) {  // a memória é alocada aos poucos até o limite
+        ord->alocados = (ord->alocados * 2 < ord->capacidade) ? ord->alocados * 2 : ord->capacidade;
+        ord->elementos = (char*)realloc(ord->elementos, ord->alocados * ord->tamanhoElemento);
+    }
+
+    memcpy(ord->elementos + ord->quantidade * ord->tamanhoElemento, elemento, ord->tamanhoElemento);
+    ord->quantidade++;
+}
+
+/**
+ * Ordena os elementos adicionados, deixando o ordenador pronto para devolvê-los com proximoElemento
+ * @param ord ordenador
+ * @return retorna 1 caso a ordenação esteja completa e 0 caso alguma corrida tenha falhado
+ */
+int ordenaElementos(ordenador* ord) {
+    if (ord->falha) return 0;
+
+    if (ord->nroCorridas == 0) {  // todos os elementos couberam na memória
+        qsort(ord->elementos, ord->quantidade, ord->tamanhoElemento, ord->comparar);
+        ord->proximo = 0;
+        return 1;
+    }
+
+    if (ord->quantidade > 0) salvaCorrida(ord);
+
+    free(ord->elementos);  // a memória dos elementos não é mais necessária durante a intercalação
+    ord->elementos = NULL;
+    ord->alocados = 0;
+
+    if (!ord->falha) iniciaIntercalacao(ord);
+    return !ord->falha;
+}
+
+/**
+ * Devolve o próximo elemento na ordem
+ * @param ord ordenador já ordenado
+ * @param elemento variável onde o elemento será salvo
+ * @return retorna 1 caso exista um elemento e 0 caso todos já tenham sido devolvidos ou a ordenação tenha falhado,
+ * o que é indicado por ord->falha
+ */
+int proximoElemento(ordenador* ord, void* elemento) {
+    if (ord->falha) return 0;
+    if (ord->nroCorridas > 0) return proximoDaIntercalacao(ord, elemento);
+
+    if (ord->proximo >= ord->quantidade) return 0;
+    memcpy(elemento, ord->elementos + ord->proximo * ord->tamanhoElemento, ord->tamanhoElemento);
+    ord->proximo++;
+    return 1;
+}
+
+/**
+ * Libera o ordenador e apaga as corridas temporárias
+ * @param ord ordenador
+ */
+void finalizaOrdenador(ordenador* ord) {
+    for (int i = 0; i < ord->nroCorridas; i++) fclose(ord->corridas[i]);
+
+    free(ord->corridas);
+    free(ord->elementos);
+    free(ord->atuais);
+    free(ord->heap);
+    free(ord);
+}
+
+/**
+ * Cria um ordenador de registros vazio
+ * @param memoria quantidade de bytes que os registros e suas entradas podem ocupar na memória
+ * @return ponteiro para o ordenador criado
+ */
+ordenadorRegistros* criaOrdenadorRegistros(long int memoria) {
+    ordenadorRegistros* ord = (ordenadorRegistros*)malloc(sizeof(ordenadorRegistros));
+
+    ord->memoria = memoria;
+    ord->dados = criaArena(memoria / 8);  // blocos pequenos diante da memória, a sobra no fim de cada um também conta
+    ord->alocados = 16;
+    ord->entradas = (entradaRegistro*)malloc(ord->alocados * sizeof(entradaRegistro));
+    ord->quantidade = 0;
+    ord->proximo = 0;
+    ord->sequencia = 0;
+    ord->maiorRegistro = 0;
+
+    ord->corridas = NULL;
+    ord->nroCorridas = 0;
+    ord->atuais = NULL;
+    ord->heap = NULL;
+    ord->tamanhoHeap = 0;
+    ord->falha = 0;
+
+    return ord;
+}
+
+/**
+ * Compara duas entradas pela chave e, em caso de empate, pela ordem de chegada
+ * @param entradaA primeira entrada
+ * @param entradaB segunda entrada
+ * @return retorna valor negativo caso a entrada A deva sair primeiro
+ */
+int comparaEntradasRegistro(const void* entradaA, const void* entradaB) {
+    const entradaRegistro* a = (const entradaRegistro*)entradaA;
+    const entradaRegistro* b = (const entradaRegistro*)entradaB;
+
+    if (a->chave != b->chave) return (a->chave < b->chave) ? -1 : 1;
+    return (a->sequencia < b->sequencia) ? -1 : (a->sequencia > b->sequencia);
+}
+
+/**
+ * Lê a próxima entrada de uma corrida de registros para a região de dados já reservada na entrada
+ * @param corrida arquivo da corrida
+ * @param entrada entrada onde o registro será salvo
+ * @return retorna 1 caso tenha lido um registro e 0 caso a corrida tenha acabado
+ */
+int lerEntradaCorrida(FILE* corrida, entradaRegistro* entrada) {
+    return fread(&entrada->chave, sizeof(int), 1, corrida) == 1 && fread(&entrada->tamanho, sizeof(int), 1, corrida) == 1 &&
+           fread(&entrada->sequencia, sizeof(long int), 1, corrida) == 1 &&
+           fread(entrada->dados, sizeof(char), entrada->tamanho, corrida) == (size_t)entrada->tamanho;
+}
+
+/**
+ * Salva uma entrada, junto dos bytes do seu registro, em uma corrida
+ * @param corrida arquivo da corrida
+ * @param entrada entrada a ser salva
+ */
+void salvaEntradaCorrida(FILE* corrida, entradaRegistro* entrada) {
+    fwrite(&entrada->chave, sizeof(int), 1, corrida);
+    fwrite(&entrada->tamanho, sizeof(int), 1, corrida);
+    fwrite(&entrada->sequencia, sizeof(long int), 1, corrida);
+    fwrite(entrada->dados, sizeof(char), entrada->tamanho, corrida);
+}
+
+/**
+ * Desce uma corrida no heap da intercalação de registros até sua posição correta
+ * @param ord ordenador
+ * @param posicao posição do heap a ser corrigida
+ */
+void desceHeapRegistros(ordenadorRegistros* ord, int posicao) {
+    while (1) {
+        int menor = posicao;
+        int esquerda = 2 * posicao + 1;
+        int direita = 2 * posicao + 2;
+
+        if (esquerda < ord->tamanhoHeap && comparaEntradasRegistro(&ord->atuais[ord->heap[esquerda]], &ord->atuais[ord->heap[menor]]) < 0)
+            menor = esquerda;
+        if (direita < ord->tamanhoHeap && comparaEntradasRegistro(&ord->atuais[ord->heap[direita]], &ord->atuais[ord->heap[menor]]) < 0)
+            menor = direita;
+        if (menor == posicao) return;
+
+        int temp = ord->heap[posicao];
+        ord->heap[posicao] = ord->heap[menor];
+        ord->heap[menor] = temp;
+        posicao = menor;
+    }
+}
+
+/**
+ * Libera as entradas atuais da intercalação de registros
+ * @param ord ordenador
+ */
+void liberaIntercalacaoRegistros(ordenadorRegistros* ord) {
+    if (ord->atuais == NULL) return;
+
+    for (int i = 0; i < ord->nroCorridas; i++) free(ord->atuais[i].dados);
+    free(ord->atuais);
+    free(ord->heap);
+    ord->atuais = NULL;
+    ord->heap = NULL;
+    ord->tamanhoHeap = 0;
+}
+
+/**
+ * Prepara a intercalação de todas as corridas de registros, lendo o primeiro registro de cada uma
+ * cada corrida tem uma região do tamanho do maior registro para o seu registro atual
+ * @param ord ordenador
+ */
+void iniciaIntercalacaoRegistros(ordenadorRegistros* ord) {
+    liberaIntercalacaoRegistros(ord);
+
+    ord->atuais = (entradaRegistro*)malloc(ord->nroCorridas * sizeof(entradaRegistro));
+    ord->heap = (int*)malloc(ord->nroCorridas * sizeof(int));
+    ord->tamanhoHeap = 0;
+
+    for (int i = 0; i < ord->nroCorridas; i++) {
+        ord->atuais[i].dados = (char*)malloc(ord->maiorRegistro > 0 ? ord->maiorRegistro : 1);
+        rewind(ord->corridas[i]);
+        if (lerEntradaCorrida(ord->corridas[i], &ord->atuais[i]))
+            ord->heap[ord->tamanhoHeap++] = i;
+        else if (ferror(ord->corridas[i]))
+            ord->falha = 1;
+    }
+
+    for (int i = ord->tamanhoHeap / 2 - 1; i >= 0; i--) desceHeapRegistros(ord, i);
+}
+
+/**
+ * Retira o menor registro entre as corridas sendo intercaladas
+ * @param ord ordenador
+ * @param entrada onde a entrada do registro será copiada, seus dados apontam para a região da corrida
+ * e só são válidos até o próximo registro ser retirado
+ * @param corrida onde o indice da corrida do registro será salvo
+ * @return retorna 1 caso exista um registro e 0 caso todas as corridas tenham acabado
+ */
+int retiraDaIntercalacaoRegistros(ordenadorRegistros* ord, entradaRegistro* entrada, int* corrida) {
+    if (ord->tamanhoHeap == 0) return 0;
+
+    *corrida = ord->heap[0];
+    *entrada = ord->atuais[*corrida];
+    return 1;
+}
+
+/**
+ * Repõe no heap o registro seguinte da corrida que teve seu registro retirado, ou a remove caso tenha acabado
+ * @param ord ordenador
+ * @param corrida indice da corrida
+ */
+void repoeIntercalacaoRegistros(ordenadorRegistros* ord, int corrida) {
+    if (!lerEntradaCorrida(ord->corridas[corrida], &ord->atuais[corrida])) {
+        if (ferror(ord->corridas[corrida])) ord->falha = 1;
+        ord->heap[0] = ord->heap[--ord->tamanhoHeap];
+    }
+    desceHeapRegistros(ord, 0);
+}
+
+/**
+ * Intercala todas as corridas de registros em uma única corrida, limitando a quantidade de arquivos abertos
+ * em caso de falha as corridas antigas são mantidas para serem fechadas por finalizaOrdenadorRegistros
+ * @param ord ordenador
+ */
+void juntaCorridasRegistros(ordenadorRegistros* ord) {
+    FILE* novaCorrida = tmpfile();
+    if (novaCorrida == NULL) {
+        ord->falha = 1;
+        return;
+    }
+    entradaRegistro entrada;
+    int corrida;
+
+    iniciaIntercalacaoRegistros(ord);
+    while (retiraDaIntercalacaoRegistros(ord, &entrada, &corrida)) {
+        salvaEntradaCorrida(novaCorrida, &entrada);
+        repoeIntercalacaoRegistros(ord, corrida);
+    }
+    liberaIntercalacaoRegistros(ord);
+
+    if (ord->falha || !corridaGravada(novaCorrida)) {
+        ord->falha = 1;
+        fclose(novaCorrida);
+        return;
+    }
+
+    for (int i = 0; i < ord->nroCorridas; i++) fclose(ord->corridas[i]);
+
+    ord->corridas[0] = novaCorrida;
+    ord->nroCorridas = 1;
+}
+
+/**
+ * Ordena os registros em memória, os salva em uma nova corrida e esvazia a arena
+ * @param ord ordenador
+ */
+void salvaCorridaRegistros(ordenadorRegistros* ord) {
+    if (ord->nroCorridas == MAXIMO_CORRIDAS) juntaCorridasRegistros(ord);
+
+    FILE* corrida = ord->falha ? NULL : tmpfile();
+    if (corrida != NULL) {
+        qsort(ord->entradas, ord->quantidade, sizeof(entradaRegistro), comparaEntradasRegistro);
+        for (int i = 0; i < ord->quantidade; i++) salvaEntradaCorrida(corrida, &ord->entradas[i]);
+    }
+    ord->quantidade = 0;
+    esvaziaArena(ord->dados);
+
+    if (corrida == NULL || !corridaGravada(corrida)) {  // os registros são descartados, a ordenação já não pode ser completa
+        ord->falha = 1;
+        if (corrida != NULL) fclose(corrida);
+        return;
+    }
+
+    ord->corridas = (FILE**)realloc(ord->corridas, (ord->nroCorridas + 1) * sizeof(FILE*));
+    ord->corridas[ord->nroCorridas++] = corrida;
+}
+
+/**
+ * Adiciona um registro ao ordenador, copiando apenas os seus bytes para a arena
+ * caso a memória esteja cheia os registros acumulados viram uma corrida, depois de uma falha os registros são ignorados
+ * @param ord ordenador
+ * @param chave chave de ordenação do registro
+ * @param dados bytes do registro
+ * @param tamanho quantidade de bytes do registro
+ */
+void adicionaRegistro(ordenadorRegistros* ord, int chave, char* dados, int tamanho) {
+    if (ord->falha) return;
+
+    // conta toda a memória reservada: o vetor de entradas inteiro, já dobrado caso esteja cheio, e os blocos da arena
+    int alocados = (ord->quantidade == ord->alocados) ? 2 * ord->alocados : ord->alocados;
+    long int ocupado = (long int)alocados * sizeof(entradaRegistro) + ocupacaoArena(ord->dados, tamanho);
+    if (ord->quantidade > 0 && ocupado > ord->memoria) salvaCorridaRegistros(ord);
+
+    if (ord->quantidade == ord->alocados) {
+        ord->alocados *= 2;
+        ord->entradas = (entradaRegistro*)realloc(ord->entradas, ord->alocados * sizeof(entradaRegistro));
+    }
+
+    entradaRegistro* entrada = &ord->entradas[ord->quantidade++];
+    entrada->chave = chave;
+    entrada->tamanho = tamanho;
+    entrada->sequencia = ord->sequencia++;
+    entrada->dados = alocaArena(ord->dados, tamanho);
+    memcpy(entrada->dados, dados, tamanho);
+
+    if (tamanho > ord->maiorRegistro) ord->maiorRegistro = tamanho;
+}
+
+/**
+ * Ordena os registros adicionados, deixando o ordenador pronto para devolvê-los com proximoRegistro
+ * @param ord ordenador
+ * @return retorna 1 caso a ordenação esteja completa e 0 caso alguma corrida tenha falhado
+ */
+int ordenaRegistros(ordenadorRegistros* ord) {
+    if (ord->falha) return 0;
+
+    if (ord->nroCorridas == 0) {  // todos os registros couberam na memória
+        qsort(ord->entradas, ord->quantidade, sizeof(entradaRegistro), comparaEntradasRegistro);
+        ord->proximo = 0;
+        return 1;
+    }
+
+    if (ord->quantidade > 0) salvaCorridaRegistros(ord);
+
+    // a memória dos registros não é mais necessária durante a intercalação
+    free(ord->entradas);
+    ord->entradas = NULL;
+    ord->alocados = 0;
+    liberaArena(ord->dados);
+    ord->dados = NULL;
+
+    ord->proximo = -1;  // nenhum registro retirado da intercalação ainda
+    if (!ord->falha) iniciaIntercalacaoRegistros(ord);
+    return !ord->falha;
+}
+
+/**
+ * Devolve o próximo registro na ordem
+ * @param ord ordenador já ordenado
+ * @param dados onde o ponteiro para os bytes do registro será salvo, válido até a próxima chamada
+ * @param tamanho onde a quantidade de bytes do registro será salva
+ * @return retorna 1 caso exista um registro e 0 caso todos já tenham sido devolvidos ou a ordenação tenha falhado,
+ * o que é indicado por ord->falha
+ */
+int proximoRegistro(ordenadorRegistros* ord, char** dados, int* tamanho) {
+    if (ord->falha) return 0;
+    if (ord->nroCorridas > 0) {
+        // o registro devolvido antes continua na região da sua corrida até este momento
+        if (ord->proximo >= 0) repoeIntercalacaoRegistros(ord, ord->proximo);
+        ord->proximo = -1;
+
+        entradaRegistro entrada;
+        if (!retiraDaIntercalacaoRegistros(ord, &entrada, &ord->proximo)) return 0;
+        *dados = entrada.dados;
+        *tamanho = entrada.tamanho;
+        return 1;
+    }
+
+    if (ord->proximo >= ord->quantidade) return 0;
+    *dados = ord->entradas[ord->proximo].dados;
+    *tamanho = ord->entradas[ord->proximo].tamanho;
+    ord->proximo++;
+    return 1;
+}
+
+/**
+ * Libera o ordenador de registros e apaga as corridas temporárias
+ * @param ord ordenador
+ */
+void finalizaOrdenadorRegistros(ordenadorRegistros* ord) {
+    liberaIntercalacaoRegistros(ord);
+    for (int i = 0; i < ord->nroCorridas; i++) fclose(ord->corridas[i]);
+
+    free(ord->corridas);
+    free(ord->entradas);
+    if (ord->dados != NULL) liberaArena(ord->dados);
+    free(ord);
+}
@@ -0,0 +1,86 @@
+#ifndef _ORDENACAO_H_
+#define _ORDENACAO_H_
+#include <stdio.h>
+
+#include "../arena/arena.h"
+
+#define MEMORIA_ORDENACAO 67108864L  // memória padrão (64 MiB) usada pela ordenação antes de recorrer ao disco
+#define MAXIMO_CORRIDAS 256          // quantidade de corridas abertas antes de intercalá-las em uma só
+
+typedef int (*comparaElementos)(const void* elementoA, const void* elementoB);
+typedef int (*leElemento)(FILE* arquivo, void* elemento);  // retorna 1 caso tenha lido um elemento
+typedef void (*salvaElemento)(FILE* arquivo, void* elemento);
+
+/**
+ * Ordenação externa de elementos de tamanho fixo
+ * os elementos são acumulados em memória até atingir o limite, quando então são ordenados
+ * e salvos em um arquivo temporário (corrida), ao final as corridas são intercaladas com um heap
+ * caso todos os elementos caibam na memória nenhum arquivo temporário é criado
+ */
+typedef struct ordenador {
+    size_t tamanhoElemento;
+    char* elementos;  // elementos em memória
+    int capacidade;   // quantidade máxima de elementos em memória
+    int alocados;
+    int quantidade;
+    int proximo;  // próximo elemento em memória a ser devolvido quando não há corridas
+
+    FILE** corridas;
+    int nroCorridas;
+    char* atuais;  // elemento atual de cada corrida durante a intercalação
+    int* heap;     // indices das corridas ordenados pelo elemento atual
+    int tamanhoHeap;
+    int falha;  // 1 caso alguma corrida não tenha sido criada, gravada ou lida, a ordem devolvida fica incompleta
+
+    comparaElementos comparar;
+    leElemento ler;
+    salvaElemento salvar;
+} ordenador;
+
+/**
+ * Registro de tamanho variável a ser ordenado por uma chave inteira, os bytes ficam na arena
+ * do ordenador e a ordenação move apenas estas entradas
+ */
+typedef struct entradaRegistro {
+    int chave;
+    int tamanho;
+    long int sequencia;  // ordem de chegada, desempata chaves iguais
+    char* dados;
+} entradaRegistro;
+
+/**
+ * Ordenação externa de registros de tamanho variável, no mesmo esquema do ordenador
+ * a memória ocupada é a soma dos tamanhos reais dos registros mais as entradas, e não
+ * o tamanho máximo de uma struct por registro. Registros com a mesma chave saem na ordem de chegada
+ */
+typedef struct ordenadorRegistros {
+    long int memoria;  // bytes que entradas e arena podem ocupar
+    arena* dados;      // bytes dos registros em memória
+    entradaRegistro* entradas;
+    int alocados;
+    int quantidade;
+    int proximo;
+    long int sequencia;
+    int maiorRegistro;
+
+    FILE** corridas;
+    int nroCorridas;
+    entradaRegistro* atuais;  // registro atual de cada corrida durante a intercalação
+    int* heap;
+    int tamanhoHeap;
+    int falha;  // 1 caso alguma corrida não tenha sido criada, gravada ou lida
+} ordenadorRegistros;
+
+ordenador* criaOrdenador(size_t tamanhoElemento, long int memoria, comparaElementos comparar, leElemento ler, salvaElemento salvar);
+void adicionaElemento(ordenador* ord, void* elemento);
+int ordenaElementos(ordenador* ord);
+int proximoElemento(ordenador* ord, void* elemento);
+void finalizaOrdenador(ordenador* ord);
+
+ordenadorRegistros* criaOrdenadorRegistros(long int memoria);
+void adicionaRegistro(ordenadorRegistros* ord, int chave, char* dados, int tamanho);
+int ordenaRegistros(ordenadorRegistros* ord);
+int proximoRegistro(ordenadorRegistros* ord, char** dados, int* tamanho);
+void finalizaOrdenadorRegistros(ordenadorRegistros* ord);
+
+#endif
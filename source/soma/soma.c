@@ -0,0 +1,374 @@
+#include "soma.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../utils/utils.h"
+
+/**
+ * Arquivo que está sendo alterado pelo processo, compartilhado pelos FILE* abertos para escrita nele
+ * validade é 0 antes da primeira escrita, 1 quando o arquivo auxiliar corresponde ao arquivo antes das
+ * escritas e -1 quando não corresponde (nesse caso a soma será recalculada por inteiro no binarioNaTela)
+ * paginas são as páginas marcadas pelas escritas ainda não refletidas no arquivo auxiliar
+ */
+typedef struct entradaSoma {
+    char nomeArquivo[256];
+    dev_t dispositivo;
+    ino_t inode;
+    int referencias;
+    int validade;
+    headerSoma base;  // header que o arquivo auxiliar deve ter enquanto as páginas não forem atualizadas
+    long int* paginas;
+    int nroPaginas;
+    int capacidadePaginas;
+} entradaSoma;
+
+typedef struct arquivoAcompanhado {
+    FILE* arquivo;
+    entradaSoma* entrada;
+} arquivoAcompanhado;
+
+arquivoAcompanhado acompanhados[MAXIMO_ARQUIVOS_SOMA];
+int nroAcompanhados = 0;
+int somaIncremental = -1;  // -1 enquanto a variável de ambiente não foi lida
+
+/**
+ * @return 1 caso a soma incremental esteja habilitada pela variável SOMA_INCREMENTAL
+ */
+int somaIncrementalAtiva() {
+    if (somaIncremental == -1) somaIncremental = lerConfiguracao("SOMA_INCREMENTAL", 0) > 0;
+    return somaIncremental;
+}
+
+/**
+ * Monta o nome do arquivo auxiliar com as somas de um arquivo
+ * @param nomeArquivo nome do arquivo
+ * @param nomeSoma onde o nome do arquivo auxiliar será escrito
+ */
+void nomeArquivoSoma(char* nomeArquivo, char* nomeSoma) {
+    sprintf(nomeSoma, "%s.soma", nomeArquivo);
+}
+
+/**
+ * Preenche um header com o estado atual do arquivo
+ * @param informacoes resultado do stat do arquivo
+ * @param header header a ser preenchido, a soma não é alterada
+ */
+void estadoDoArquivo(struct stat* informacoes, headerSoma* header) {
+    header->tamanhoArquivo = informacoes->st_size;
+    header->modificacaoSegundos = informacoes->st_mtim.tv_sec;
+    header->modificacaoNanossegundos = informacoes->st_mtim.tv_nsec;
+    header->inode = informacoes->st_ino;
+    header->tamanhoPagina = TAMANHO_PAGINA_SOMA;
+}
+
+/**
+ * @return 1 caso os dois headers descrevam o mesmo estado do arquivo
+ */
+int mesmoEstado(headerSoma* a, headerSoma* b) {
+    return a->tamanhoArquivo == b->tamanhoArquivo && a->modificacaoSegundos == b->modificacaoSegundos &&
+           a->modificacaoNanossegundos == b->modificacaoNanossegundos && a->inode == b->inode &&
+           a->tamanhoPagina == b->tamanhoPagina;
+}
+
+int lerHeaderSoma(FILE* arquivoSoma, headerSoma* header) {
+    fseek(arquivoSoma, 0, SEEK_SET);
+    return fread(&header->tamanhoArquivo, sizeof(long int), 1, arquivoSoma) == 1 &&
+           fread(&header->modificacaoSegundos, sizeof(long int), 1, arquivoSoma) == 1 &&
+           fread(&header->modificacaoNanossegundos, sizeof(long int), 1, arquivoSoma) == 1 &&
+           fread(&header->inode, sizeof(unsigned long int), 1, arquivoSoma) == 1 &&
+           fread(&header->soma, sizeof(unsigned long int), 1, arquivoSoma) == 1 &&
+           fread(&header->tamanhoPagina, sizeof(int), 1, arquivoSoma) == 1;
+}
+
+void salvaHeaderSoma(FILE* arquivoSoma, headerSoma* header) {
+    fseek(arquivoSoma, 0, SEEK_SET);
+    fwrite(&header->tamanhoArquivo, sizeof(long int), 1, arquivoSoma);
+    fwrite(&header->modificacaoSegundos, sizeof(long int), 1, arquivoSoma);
+    fwrite(&header->modificacaoNanossegundos, sizeof(long int), 1, arquivoSoma);
+    fwrite(&header->inode, sizeof(unsigned long int), 1, arquivoSoma);
+    fwrite(&header->soma, sizeof(unsigned long int), 1, arquivoSoma);
+    fwrite(&header->tamanhoPagina, sizeof(int), 1, arquivoSoma);
+}
+
+/**
+ * Confere, antes da primeira escrita, se o arquivo auxiliar corresponde ao arquivo
+ * @param entrada arquivo sendo alterado
+ */
+void validaEntradaSoma(entradaSoma* entrada) {
+    char nomeSoma[300];
+    struct stat informacoes;
+    headerSoma atual;
+
+    nomeArquivoSoma(entrada->nomeArquivo, nomeSoma);
+    FILE* arquivoSoma = fopen(nomeSoma, "rb");
+    entrada->validade = -1;
+    if (arquivoSoma == NULL) return;
+
+    if (lerHeaderSoma(arquivoSoma, &entrada->base) && stat(entrada->nomeArquivo, &informacoes) == 0 &&
+        informacoes.st_ino == entrada->inode) {
+        estadoDoArquivo(&informacoes, &atual);
+        if (mesmoEstado(&atual, &entrada->base)) entrada->validade = 1;
+    }
+
+    fclose(arquivoSoma);
+}
+
+int compararPaginas(const void* a, const void* b) {
+    long int paginaA = *(long int*)a, paginaB = *(long int*)b;
+    return (paginaA > paginaB) - (paginaA < paginaB);
+}
+
+/**
+ * Relê as páginas marcadas e atualiza as somas delas e o header no arquivo auxiliar
+ * as escritas do arquivo já precisam ter sido descarregadas (fflush)
+ * @param entrada arquivo sendo alterado
+ */
+void sincronizaEntradaSoma(entradaSoma* entrada) {
+    if (entrada->validade != 1 || entrada->nroPaginas == 0) return;
+
+    char nomeSoma[300];
+    nomeArquivoSoma(entrada->nomeArquivo, nomeSoma);
+
+    FILE* arquivoSoma = fopen(nomeSoma, "r+b");
+    FILE* arquivo = fopen(entrada->nomeArquivo, "rb");
+    headerSoma header;
+    struct stat informacoes;
+
+    if (arquivoSoma == NULL || arquivo == NULL || !lerHeaderSoma(arquivoSoma, &header) ||
+        !mesmoEstado(&header, &entrada->base) || fstat(fileno(arquivo), &informacoes) != 0) {
+        entrada->validade = -1;
+        if (arquivoSoma != NULL) fclose(arquivoSoma);
+        if (arquivo != NULL) fclose(arquivo);
+        return;
+    }
+
+    qsort(entrada->paginas, entrada->nroPaginas, sizeof(long int), compararPaginas);
+
+    long int paginasAntigas = (header.tamanhoArquivo + TAMANHO_PAGINA_SOMA - 1) / TAMANHO_PAGINA_SOMA;
+    unsigned char dados[TAMANHO_PAGINA_SOMA];
+
+    for (int i = 0; i < entrada->nroPaginas; i++) {
+        long int pagina = entrada->paginas[i];
+        if (i > 0 && pagina == entrada->paginas[i - 1]) continue;
+
+        unsigned int somaAntiga = 0, somaNova = 0;
+        if (pagina < paginasAntigas) {
+            fseek(arquivoSoma, TAMANHO_HEADER_SOMA + pagina * sizeof(unsigned int), SEEK_SET);
+            if (fread(&somaAntiga, sizeof(unsigned int), 1, arquivoSoma) != 1) somaAntiga = 0;
+        }
+
+        fseek(arquivo, pagina * TAMANHO_PAGINA_SOMA, SEEK_SET);
+        size_t lidos = fread(dados, sizeof(char), TAMANHO_PAGINA_SOMA, arquivo);
+        for (size_t j = 0; j < lidos; j++) somaNova += dados[j];
+
+        header.soma += somaNova;
+        header.soma -= somaAntiga;
+
+        fseek(arquivoSoma, TAMANHO_HEADER_SOMA + pagina * sizeof(unsigned int), SEEK_SET);
+        fwrite(&somaNova, sizeof(unsigned int), 1, arquivoSoma);
+    }
+
+    estadoDoArquivo(&informacoes, &header);
+    salvaHeaderSoma(arquivoSoma, &header);
+    entrada->base = header;
+    entrada->nroPaginas = 0;
+
+    fclose(arquivoSoma);
+    fclose(arquivo);
+}
+
+/**
+ * Passa a acompanhar um arquivo aberto, chamada em toda abertura feita pelos módulos
+ * @param arquivo arquivo recém aberto
+ * @param nomeArquivo nome usado na abertura
+ * @param modo modo de abertura, apenas os que permitem escrita são acompanhados
+ */
+void registraAberturaSoma(FILE* arquivo, const char* nomeArquivo, const char* modo) {
+    if (arquivo == NULL || !somaIncrementalAtiva()) return;
+    if (strchr(modo, 'w') == NULL && strchr(modo, 'a') == NULL && strchr(modo, '+') == NULL) return;
+
+    struct stat informacoes;
+    if (fstat(fileno(arquivo), &informacoes) != 0) return;
+
+    if (nroAcompanhados == MAXIMO_ARQUIVOS_SOMA || strlen(nomeArquivo) >= sizeof(((entradaSoma*)0)->nomeArquivo)) {
+        // as escritas desse arquivo não serão acompanhadas, então a soma guardada deixa de valer
+        char nomeSoma[300];
+        nomeArquivoSoma((char*)nomeArquivo, nomeSoma);
+        unlink(nomeSoma);
+        return;
+    }
+
+    entradaSoma* entrada = NULL;
+    for (int i = 0; i < nroAcompanhados && entrada == NULL; i++) {
+        if (acompanhados[i].entrada->dispositivo == informacoes.st_dev && acompanhados[i].entrada->inode == informacoes.st_ino)
+            entrada = acompanhados[i].entrada;
+    }
+
+    if (entrada == NULL) {
+        entrada = (entradaSoma*)calloc(1, sizeof(entradaSoma));
+        strcpy(entrada->nomeArquivo, nomeArquivo);
+        entrada->dispositivo = informacoes.st_dev;
+        entrada->inode = informacoes.st_ino;
+    }
+
+    entrada->referencias++;
+    acompanhados[nroAcompanhados].arquivo = arquivo;
+    acompanhados[nroAcompanhados].entrada = entrada;
+    nroAcompanhados++;
+}
+
+/**
+ * Marca as páginas que uma escrita vai alterar, chamada antes de cada fwrite
+ * @param arquivo arquivo onde a escrita será feita
+ * @param tamanho quantidade de bytes escritos a partir da posição atual
+ */
+void registraEscritaSoma(FILE* arquivo, long int tamanho) {
+    if (tamanho <= 0) return;
+
+    entradaSoma* entrada = NULL;
+    for (int i = 0; i < nroAcompanhados && entrada == NULL; i++)
+        if (acompanhados[i].arquivo == arquivo) entrada = acompanhados[i].entrada;
+
+    if (entrada == NULL) return;
+    if (entrada->validade == 0) validaEntradaSoma(entrada);
+    if (entrada->validade != 1) return;
+
+    long int posicao = ftell(arquivo);
+    for (long int pagina = posicao / TAMANHO_PAGINA_SOMA; pagina <= (posicao + tamanho - 1) / TAMANHO_PAGINA_SOMA; pagina++) {
+        if (entrada->nroPaginas > 0 && entrada->paginas[entrada->nroPaginas - 1] == pagina) continue;
+
+        if (entrada->nroPaginas == entrada->capacidadePaginas) {
+            entrada->capacidadePaginas = entrada->capacidadePaginas ? entrada->capacidadePaginas * 2 : 64;
+            entrada->paginas = (long int*)realloc(entrada->paginas, entrada->capacidadePaginas * sizeof(long int));
+        }
+        entrada->paginas[entrada->nroPaginas++] = pagina;
+    }
+}
+
+/**
+ * Deixa de acompanhar um arquivo, chamada antes de cada fclose, quando o último FILE* do arquivo é fechado
+ * as páginas marcadas são refletidas no arquivo auxiliar
+ * @param arquivo arquivo que será fechado
+ */
+void registraFechamentoSoma(FILE* arquivo) {
+    for (int i = 0; i < nroAcompanhados; i++) {
+        if (acompanhados[i].arquivo != arquivo) continue;
+
+        entradaSoma* entrada = acompanhados[i].entrada;
+        acompanhados[i] = acompanhados[--nroAcompanhados];
+
+        fflush(arquivo);
+        if (--entrada->referencias > 0) return;
+
+        sincronizaEntradaSoma(entrada);
+        free(entrada->paginas);
+        free(entrada);
+        return;
+    }
+}
+
+/**
+ * Calcula a soma percorrendo o arquivo inteiro em blocos e, com a soma incremental ativa, reescreve o arquivo auxiliar
+ * @param nomeArquivo nome do arquivo
+ * @param soma onde a soma será escrita
+ * @return 1 caso o arquivo possa ser lido e 0 caso contrário
+ */
+int recalculaSoma(char* nomeArquivo, unsigned long int* soma) {
+    FILE* arquivo = fopen(nomeArquivo, "rb");
+    if (arquivo == NULL) return 0;
+
+    FILE* arquivoSoma = NULL;
+    if (somaIncrementalAtiva()) {
+        char nomeSoma[300];
+        nomeArquivoSoma(nomeArquivo, nomeSoma);
+        arquivoSoma = fopen(nomeSoma, "wb");
+    }
+
+    headerSoma header;
+    struct stat informacoes;
+    fstat(fileno(arquivo), &informacoes);
+    estadoDoArquivo(&informacoes, &header);
+    header.soma = 0;
+    if (arquivoSoma != NULL) salvaHeaderSoma(arquivoSoma, &header);
+
+    unsigned char* dados = (unsigned char*)malloc(TAMANHO_LEITURA_SOMA);
+    unsigned int somasPaginas[TAMANHO_LEITURA_SOMA / TAMANHO_PAGINA_SOMA];
+    size_t lidos;
+
+    while ((lidos = fread(dados, sizeof(char), TAMANHO_LEITURA_SOMA, arquivo)) > 0) {
+        int nroPaginas = (lidos + TAMANHO_PAGINA_SOMA - 1) / TAMANHO_PAGINA_SOMA;
+        memset(somasPaginas, 0, sizeof(somasPaginas));
+
+        for (size_t i = 0; i < lidos; i++) somasPaginas[i / TAMANHO_PAGINA_SOMA] += dados[i];
+        for (int i = 0; i < nroPaginas; i++) header.soma += somasPaginas[i];
+
+        if (arquivoSoma != NULL) fwrite(somasPaginas, sizeof(unsigned int), nroPaginas, arquivoSoma);
+    }
+
+    if (arquivoSoma != NULL) {
+        salvaHeaderSoma(arquivoSoma, &header);
+        fclose(arquivoSoma);
+    }
+
+    // um FILE* ainda aberto para escrita passa a partir da soma recém calculada
+    for (int i = 0; i < nroAcompanhados; i++) {
+        entradaSoma* entrada = acompanhados[i].entrada;
+        if (entrada->dispositivo == informacoes.st_dev && entrada->inode == informacoes.st_ino) {
+            entrada->validade = (arquivoSoma != NULL) ? 1 : 0;
+            entrada->base = header;
+            entrada->nroPaginas = 0;
+        }
+    }
+
+    free(dados);
+    fclose(arquivo);
+
+    *soma = header.soma;
+    return 1;
+}
+
+/**
+ * Soma de todos os bytes de um arquivo, lida do arquivo auxiliar quando ele corresponde ao arquivo
+ * @param nomeArquivo nome do arquivo
+ * @param soma onde a soma será escrita
+ * @return 1 caso o arquivo possa ser lido e 0 caso contrário
+ */
+int somaDoArquivo(char* nomeArquivo, unsigned long int* soma) {
+    struct stat informacoes;
+    if (stat(nomeArquivo, &informacoes) != 0) return 0;
+
+    if (somaIncrementalAtiva()) {
+        // escritas pendentes de arquivos ainda abertos (como as arvores mantidas pela sessão) são refletidas antes
+        for (int i = 0; i < nroAcompanhados; i++) {
+            entradaSoma* entrada = acompanhados[i].entrada;
+            if (entrada->dispositivo != informacoes.st_dev || entrada->inode != informacoes.st_ino) continue;
+            for (int j = 0; j < nroAcompanhados; j++)
+                if (acompanhados[j].entrada == entrada) fflush(acompanhados[j].arquivo);
+            sincronizaEntradaSoma(entrada);
+            stat(nomeArquivo, &informacoes);
+            break;
+        }
+
+        char nomeSoma[300];
+        nomeArquivoSoma(nomeArquivo, nomeSoma);
+        FILE* arquivoSoma = fopen(nomeSoma, "rb");
+
+        if (arquivoSoma != NULL) {
+            headerSoma guardado, atual;
+            int lido = lerHeaderSoma(arquivoSoma, &guardado);
+            fclose(arquivoSoma);
+
+            estadoDoArquivo(&informacoes, &atual);
+            if (lido && mesmoEstado(&guardado, &atual)) {
+                *soma = guardado.soma;
+                return 1;
+            }
+        }
+    }
+
+    return recalculaSoma(nomeArquivo, soma);
+}
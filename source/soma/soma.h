@@ -0,0 +1,34 @@
+#ifndef _SOMA_H_
+#define _SOMA_H_
+#include <stdio.h>
+
+#define TAMANHO_PAGINA_SOMA 4096      // cada página do arquivo tem sua soma guardada no arquivo auxiliar
+#define TAMANHO_LEITURA_SOMA 65536    // bytes lidos por vez quando a soma precisa ser recalculada por inteiro
+#define MAXIMO_ARQUIVOS_SOMA 64       // arquivos abertos para escrita acompanhados ao mesmo tempo
+#define TAMANHO_HEADER_SOMA 44
+
+/**
+ * Com SOMA_INCREMENTAL=1 a soma dos bytes de cada arquivo fica guardada em <arquivo>.soma, junto da soma de
+ * cada página. As escritas feitas pelos módulos (que passam por fwrite) marcam as páginas alteradas e, quando
+ * o arquivo é fechado, apenas essas páginas são relidas. Assim o binarioNaTela depois de uma inserção
+ * custa o tamanho do que foi escrito e não o tamanho do arquivo
+ *
+ * O header do arquivo auxiliar guarda tamanho, data de modificação e inode do arquivo no momento em que a
+ * soma foi calculada, qualquer alteração feita por fora faz a soma ser recalculada por inteiro
+ */
+typedef struct headerSoma {
+    long int tamanhoArquivo;
+    long int modificacaoSegundos;
+    long int modificacaoNanossegundos;
+    unsigned long int inode;
+    unsigned long int soma;
+    int tamanhoPagina;
+} headerSoma;
+
+void nomeArquivoSoma(char* nomeArquivo, char* nomeSoma);
+void registraAberturaSoma(FILE* arquivo, const char* nomeArquivo, const char* modo);
+void registraEscritaSoma(FILE* arquivo, long int tamanho);
+void registraFechamentoSoma(FILE* arquivo);
+int somaDoArquivo(char* nomeArquivo, unsigned long int* soma);
+
+#endif
@@ -5,6 +5,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../estatisticas/estatisticas.h"
+#include "../soma/soma.h"
+
 /**
  * Abre um arquivo e testa se ele já existe ou não
  * @param arquivo ponteiro do tipo FILE*
@@ -23,6 +26,21 @@ int abrirArquivo(FILE** arquivo, char* nomeDoArquivo, char* tipoDeAbertura, int
     return existe;
 }
 
+/**
+ * Lê um parâmetro numérico de configuração a partir de uma variável de ambiente
+ * @param nomeVariavel nome da variável de ambiente
+ * @param valorPadrao valor usado caso a variável não exista ou seja inválida
+ * @return retorna o valor configurado ou o padrão
+ */
+long int lerConfiguracao(char* nomeVariavel, long int valorPadrao) {
+    char* valor = getenv(nomeVariavel);
+    if (valor == NULL || valor[0] == '\0') return valorPadrao;
+
+    char* fim;
+    long int configurado = strtol(valor, &fim, 10);
+    return (*fim == '\0' && configurado > 0) ? configurado : valorPadrao;
+}
+
 /**
  * Transforma um inteiro no formato string em um inteiro
  * @param string string inicial
@@ -52,42 +70,102 @@ int finalDoArquivo(FILE* arquivo) {
 }
 
 /**
- * Determina se uma string é nula, ou seja, se já começa com \0
- * @param string string a ser analisada
- * @return retorna a própria string ou uma string padrão caso seja nula
+ * Copia um trecho de texto para a saída sendo montada
+ * @param destino posição atual da saída
+ * @param texto inicio do texto
+ * @param tamanho quantidade de bytes do texto
+ * @return posição seguinte ao texto copiado
  */
-char* ajustaString(char* string) {
-    return (string[0] == '\0') ? "campo com valor nulo" : string;
+char* formataTexto(char* destino, char* texto, int tamanho) {
+    memcpy(destino, texto, tamanho);
+    return destino + tamanho;
 }
 
 /**
- * Imprime um inteiro ou campo com valor nulo caso ele seja -1
- * @param inteiro inteiro a ser analisada
+ * Escreve um inteiro em decimal seguido de quebra de linha, ou campo com valor nulo caso ele seja -1
+ * @param destino posição atual da saída
+ * @param inteiro inteiro a ser escrito
+ * @return posição seguinte ao texto escrito
  */
-void imprimeInteiro(int inteiro) {
+char* formataInteiro(char* destino, int inteiro) {
     if (inteiro == -1) {
-        printf("campo com valor nulo\n");
-    } else {
-        printf("%d\n", inteiro);
+        destino = formataTexto(destino, VALOR_NULO, sizeof(VALOR_NULO) - 1);
+        *destino++ = '\n';
+        return destino;
     }
+
+    char digitos[10];
+    int quantidade = 0;
+    unsigned int valor = (inteiro < 0) ? -(unsigned int)inteiro : (unsigned int)inteiro;
+
+    do {
+        digitos[quantidade++] = '0' + valor % 10;
+        valor /= 10;
+    } while (valor > 0);
+
+    if (inteiro < 0) *destino++ = '-';
+    while (quantidade > 0) *destino++ = digitos[--quantidade];
+    *destino++ = '\n';
+
+    return destino;
 }
 
 /**
- * Imprime um campo de um registro
+ * Escreve a descrição de um campo seguida de ": "
+ * @param destino posição atual da saída
  * @param descricao descrição do campo
- * @param valor ponteiro para o valor que será impresso
- * @param isInt determina se o valor a ser impresso é inteiro ou string, sendo > 0 para
- * @return retorna a própria string ou uma string padrão caso seja nula
+ * @return posição seguinte ao texto escrito
  */
-void imprimirCampo(char* descricao, void* valor, int isInt) {
-    if (isInt > 0) {  //testa se o valor recebido é inteiro ou não
-        int* valorInteiro = (int*)valor;
-        printf("%s: ", descricao);
-        imprimeInteiro(*valorInteiro);
-    } else {
-        char* valorString = (char*)valor;
-        printf("%s: %s\n", descricao, ajustaString(valorString));
-    }
+char* formataRotulo(char* destino, char* descricao) {
+    destino = formataTexto(destino, descricao, strlen(descricao));
+    *destino++ = ':';
+    *destino++ = ' ';
+    return destino;
+}
+
+/**
+ * Escreve um campo inteiro de um registro
+ * @param destino posição atual da saída
+ * @param descricao descrição do campo
+ * @param valor valor do campo, -1 para nulo
+ * @return posição seguinte ao texto escrito
+ */
+char* formataCampo(char* destino, char* descricao, int valor) {
+    return formataInteiro(formataRotulo(destino, descricao), valor);
+}
+
+/**
+ * Escreve um campo de string que não é necessariamente terminado em \0
+ * @param destino posição atual da saída
+ * @param descricao descrição do campo
+ * @param valor ponteiro para o inicio da string
+ * @param tamanho quantidade máxima de caracteres da string
+ * @return posição seguinte ao texto escrito
+ */
+char* formataCampoTamanho(char* destino, char* descricao, char* valor, int tamanho) {
+    destino = formataRotulo(destino, descricao);
+
+    if (valor == NULL || tamanho <= 0 || valor[0] == '\0')
+        destino = formataTexto(destino, VALOR_NULO, sizeof(VALOR_NULO) - 1);
+    else
+        destino = formataTexto(destino, valor, strnlen(valor, tamanho));
+
+    *destino++ = '\n';
+    return destino;
+}
+
+/**
+ * Compara uma string terminada em \0 com um campo de tamanho limitado, que
+ * termina no primeiro \0 ou ao atingir o tamanho, assim como um strcmp
+ * @param valor string terminada em \0
+ * @param campo ponteiro para o inicio do campo
+ * @param tamanho quantidade máxima de caracteres do campo
+ * @return retorna 1 caso sejam iguais e 0 caso contrário
+ */
+int stringIgual(char* valor, char* campo, int tamanho) {
+    int tamanhoCampo = (campo == NULL || tamanho <= 0) ? 0 : (int)strnlen(campo, tamanho);
+    if ((int)strlen(valor) != tamanhoCampo) return 0;
+    return tamanhoCampo == 0 || memcmp(valor, campo, tamanhoCampo) == 0;
 }
 
 /**
@@ -130,27 +208,15 @@ void binarioNaTela(char* nomeArquivoBinario) { /* Você não precisa entender o
     /* Use essa função para comparação no run.codes. Lembre-se de ter fechado (fclose) o arquivo anteriormente.
 	*  Ela vai abrir de novo para leitura e depois fechar (você não vai perder pontos por isso se usar ela). */
 
-    unsigned long i, cs;
-    unsigned char* mb;
-    size_t fl;
-    FILE* fs;
-    if (nomeArquivoBinario == NULL || !(fs = fopen(nomeArquivoBinario, "rb"))) {
+    /* A soma vem do módulo soma, que percorre o arquivo em blocos ou, com SOMA_INCREMENTAL=1, reaproveita a
+	*  soma guardada no arquivo auxiliar atualizando apenas as páginas escritas desde então. */
+
+    unsigned long cs;
+    if (nomeArquivoBinario == NULL || !somaDoArquivo(nomeArquivoBinario, &cs)) {
         fprintf(stderr, "ERRO AO ESCREVER O BINARIO NA TELA (função binarioNaTela): não foi possível abrir o arquivo que me passou para leitura. Ele existe e você tá passando o nome certo? Você lembrou de fechar ele com fclose depois de usar?\n");
         return;
     }
-    fseek(fs, 0, SEEK_END);
-    fl = ftell(fs);
-    fseek(fs, 0, SEEK_SET);
-    mb = (unsigned char*)malloc(fl);
-    fread(mb, 1, fl, fs);
-
-    cs = 0;
-    for (i = 0; i < fl; i++) {
-        cs += (unsigned long)mb[i];
-    }
     printf("%lf\n", (cs / (double)100));
-    free(mb);
-    fclose(fs);
 }
 
 void scan_quote_string(char* str) {
@@ -2,9 +2,20 @@
 #define _UTILS_H_
 #include <stdio.h>
 
+#define VALOR_NULO "campo com valor nulo"
+#define TAMANHO_BUFFER_SAIDA 1048576  // buffer da saída padrão, as impressões dos registros são escritas em blocos
+#define TAMANHO_SAIDA_FIXA 512        // limite da impressão de um registro sem contar os campos de tamanho variável
+#define TAMANHO_SAIDA_REGISTRO 1024   // região local onde a impressão de um registro é montada
+
 int abrirArquivo(FILE** arquivo, char* nomeDoArquivo, char* tipoDeAbertura, int verificaExistencia);
 int finalDoArquivo(FILE* arquivo);
-void imprimirCampo(char* descricao, void* valor, int isInt);
+long int lerConfiguracao(char* nomeVariavel, long int valorPadrao);
+char* formataTexto(char* destino, char* texto, int tamanho);
+char* formataInteiro(char* destino, int inteiro);
+char* formataRotulo(char* destino, char* descricao);
+char* formataCampo(char* destino, char* descricao, int valor);
+char* formataCampoTamanho(char* destino, char* descricao, char* valor, int tamanho);
+int stringIgual(char* valor, char* campo, int tamanho);
 void binarioNaTela(char* nomeArquivoBinario);
 void scan_quote_string(char* str);
 int convertePrefixo(char* str);
@@ -0,0 +1,193 @@
+#include "varredura.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../bloco/bloco.h"
+#include "../estatisticas/estatisticas.h"
+#include "../utils/utils.h"
+
+/**
+ * Garante espaço na saida de um trecho para a impressão de um registro
+ * @param saida saida do trecho
+ * @param tamanhoMaximo maior quantidade de bytes que a impressão pode ocupar
+ * @return retorna a posição onde a impressão deve ser montada
+ */
+char* reservaSaidaTrecho(saidaTrecho* saida, long int tamanhoMaximo) {
+    if (saida->capacidade - saida->tamanho < tamanhoMaximo) {
+        while (saida->capacidade - saida->tamanho < tamanhoMaximo) saida->capacidade *= 2;
+        saida->dados = (char*)realloc(saida->dados, saida->capacidade);
+    }
+
+    return saida->dados + saida->tamanho;
+}
+
+/**
+ * Confirma na saida de um trecho a impressão montada a partir de reservaSaidaTrecho
+ * @param saida saida do trecho
+ * @param fim posição logo após o ultimo byte escrito
+ */
+void confirmaSaidaTrecho(saidaTrecho* saida, char* fim) {
+    saida->tamanho = fim - saida->dados;
+}
+
+/**
+ * Divide os blocos do arquivo em trechos de até BLOCOS_POR_TRECHO blocos
+ * @param mapa arquivo mapeado
+ * @param tamanhoHeader tamanho do header do arquivo
+ * @param trechos vetor alocado com os trechos
+ * @return retorna a quantidade de trechos
+ */
+int divideTrechos(arquivoMapeado* mapa, int tamanhoHeader, trechoVarredura** trechos) {
+    long int nroBlocos = (mapa->tamanho - tamanhoHeader) / TAMANHO_BLOCO_DADOS;
+    int nroTrechos = (nroBlocos + BLOCOS_POR_TRECHO - 1) / BLOCOS_POR_TRECHO;
+    *trechos = (trechoVarredura*)malloc((nroTrechos > 0 ? nroTrechos : 1) * sizeof(trechoVarredura));
+
+    for (int i = 0; i < nroTrechos; i++) {
+        trechoVarredura* trecho = &(*trechos)[i];
+        long int primeiroBloco = (long int)i * BLOCOS_POR_TRECHO;
+
+        trecho->inicio = tamanhoHeader + primeiroBloco * TAMANHO_BLOCO_DADOS;
+        trecho->primeiroBloco = primeiroBloco;
+        trecho->nroBlocos = (nroBlocos - primeiroBloco < BLOCOS_POR_TRECHO) ? nroBlocos - primeiroBloco : BLOCOS_POR_TRECHO;
+        trecho->saida.dados = NULL;
+        trecho->saida.tamanho = 0;
+        trecho->saida.capacidade = 0;
+        trecho->encontrados = 0;
+        trecho->pronto = 0;
+    }
+
+    return nroTrechos;
+}
+
+/**
+ * Avalia todos os registros de um trecho, na ordem do arquivo, percorrendo o diretório de cada bloco
+ * @param varredura estado da varredura
+ * @param mapa cópia do mapeamento exclusiva da thread, sua posição é alterada pelas leituras
+ * @param trecho trecho a ser avaliado
+ */
+void avaliaTrecho(varreduraParalela* varredura, arquivoMapeado* mapa, trechoVarredura* trecho) {
+    trecho->saida.capacidade = TAMANHO_SAIDA_TRECHO;
+    trecho->saida.dados = (char*)malloc(trecho->saida.capacidade);
+
+    for (int i = 0; i < trecho->nroBlocos; i++) {
+        if (varredura->blocosPossiveis != NULL && !varredura->blocosPossiveis[trecho->primeiroBloco + i]) continue;
+
+        long int inicioBloco = trecho->inicio + (long int)i * TAMANHO_BLOCO_DADOS;
+        char* bloco = mapa->dados + inicioBloco;
+        int nroRegistros = nroRegistrosBloco(bloco);
+
+        for (int j = 0; j < nroRegistros; j++) {
+            long int byteOffset = inicioBloco + posicaoRegistroBloco(bloco, j);
+            trecho->encontrados += varredura->avaliar(mapa, byteOffset, varredura->consulta, &trecho->saida);
+
+            // em um campo único nada depois do primeiro encontrado será impresso
+            if (varredura->apenasPrimeiro && trecho->encontrados) return;
+        }
+    }
+}
+
+/**
+ * Rotina das threads: pega o próximo trecho livre, avalia e avisa a impressão
+ * uma thread não pega trechos muito à frente da impressão, limitando a memória usada pelas saidas
+ * @param argumento estado da varredura
+ * @return retorna sempre NULL
+ */
+void* processaTrechos(void* argumento) {
+    varreduraParalela* varredura = (varreduraParalela*)argumento;
+    arquivoMapeado mapa = *varredura->mapa;
+
+    while (1) {
+        pthread_mutex_lock(&varredura->trava);
+        while (!varredura->encerrada && varredura->proximoTrecho < varredura->nroTrechos &&
+               varredura->proximoTrecho >= varredura->trechosImpressos + varredura->janela) {
+            pthread_cond_wait(&varredura->trechoImpresso, &varredura->trava);
+        }
+        if (varredura->encerrada || varredura->proximoTrecho >= varredura->nroTrechos) {
+            pthread_mutex_unlock(&varredura->trava);
+            return NULL;
+        }
+        int indice = varredura->proximoTrecho++;
+        pthread_mutex_unlock(&varredura->trava);
+
+        avaliaTrecho(varredura, &mapa, &varredura->trechos[indice]);
+
+        pthread_mutex_lock(&varredura->trava);
+        varredura->trechos[indice].pronto = 1;
+        pthread_cond_broadcast(&varredura->trechoPronto);
+        pthread_mutex_unlock(&varredura->trava);
+    }
+}
+
+/**
+ * Percorre todos os registros de um arquivo no formato em blocos usando várias threads
+ * cada thread avalia trechos inteiros de blocos, que por sempre começarem em um bloco não precisam
+ * procurar o inicio de um registro, e as saidas são impressas na ordem do arquivo,
+ * então o resultado é idêntico ao da varredura registro a registro
+ * a quantidade de threads pode ser alterada pela variável de ambiente THREADS_CONSULTA
+ * @param mapa arquivo mapeado
+ * @param tamanhoHeader tamanho do header do arquivo
+ * @param avaliar função que avalia e formata um registro
+ * @param consulta parâmetros da consulta repassados para avaliar
+ * @param apenasPrimeiro 1 caso a varredura deva parar no primeiro registro encontrado
+ * @param blocosPossiveis 0 para cada bloco que não precisa ser lido (ver blocosPossiveisZona) ou NULL para ler todos
+ * @return retorna a quantidade de registros impressos
+ */
+int varreBlocosParalelo(arquivoMapeado* mapa, int tamanhoHeader, avaliaRegistro avaliar, void* consulta,
+                        int apenasPrimeiro, char* blocosPossiveis) {
+    varreduraParalela varredura;
+    varredura.mapa = mapa;
+    varredura.nroTrechos = divideTrechos(mapa, tamanhoHeader, &varredura.trechos);
+    varredura.proximoTrecho = 0;
+    varredura.trechosImpressos = 0;
+    varredura.encerrada = 0;
+    varredura.apenasPrimeiro = apenasPrimeiro;
+    varredura.avaliar = avaliar;
+    varredura.consulta = consulta;
+    varredura.blocosPossiveis = blocosPossiveis;
+    pthread_mutex_init(&varredura.trava, NULL);
+    pthread_cond_init(&varredura.trechoPronto, NULL);
+    pthread_cond_init(&varredura.trechoImpresso, NULL);
+
+    long int nroThreads = lerConfiguracao("THREADS_CONSULTA", sysconf(_SC_NPROCESSORS_ONLN));
+    if (nroThreads > varredura.nroTrechos) nroThreads = varredura.nroTrechos;
+    if (nroThreads < 1) nroThreads = 1;
+    varredura.janela = nroThreads * TRECHOS_POR_THREAD;
+
+    pthread_t* threads = (pthread_t*)malloc(nroThreads * sizeof(pthread_t));
+    for (int i = 0; i < nroThreads; i++) pthread_create(&threads[i], NULL, processaTrechos, &varredura);
+
+    // imprime os trechos na ordem do arquivo conforme ficam prontos
+    int encontrados = 0;
+    for (int i = 0; i < varredura.nroTrechos && !varredura.encerrada; i++) {
+        trechoVarredura* trecho = &varredura.trechos[i];
+
+        pthread_mutex_lock(&varredura.trava);
+        while (!trecho->pronto) pthread_cond_wait(&varredura.trechoPronto, &varredura.trava);
+        pthread_mutex_unlock(&varredura.trava);
+
+        fwrite(trecho->saida.dados, sizeof(char), trecho->saida.tamanho, stdout);
+        CONTA(registrosDevolvidos, trecho->encontrados);
+        encontrados += trecho->encontrados;
+
+        pthread_mutex_lock(&varredura.trava);
+        varredura.trechosImpressos++;
+        if (apenasPrimeiro && encontrados) varredura.encerrada = 1;
+        pthread_cond_broadcast(&varredura.trechoImpresso);
+        pthread_mutex_unlock(&varredura.trava);
+    }
+
+    for (int i = 0; i < nroThreads; i++) pthread_join(threads[i], NULL);
+
+    for (int i = 0; i < varredura.nroTrechos; i++) free(varredura.trechos[i].saida.dados);
+    pthread_mutex_destroy(&varredura.trava);
+    pthread_cond_destroy(&varredura.trechoPronto);
+    pthread_cond_destroy(&varredura.trechoImpresso);
+    free(threads);
+    free(varredura.trechos);
+
+    return encontrados;
+}
@@ -0,0 +1,64 @@
+#ifndef _VARREDURA_H_
+#define _VARREDURA_H_
+#include <pthread.h>
+#include <stdio.h>
+
+#include "../mapeamento/mapeamento.h"
+
+#define BLOCOS_POR_TRECHO 16        // blocos de dados entregues de uma vez a uma thread da consulta
+#define TRECHOS_POR_THREAD 2        // quantos trechos cada thread pode adiantar em relação à impressão
+#define TAMANHO_SAIDA_TRECHO 65536  // capacidade inicial da saída de um trecho
+
+/**
+ * Saída de um trecho da varredura, montada em memória até chegar a vez do trecho ser impresso
+ */
+typedef struct saidaTrecho {
+    char* dados;
+    long int tamanho;
+    long int capacidade;
+} saidaTrecho;
+
+/**
+ * Avalia o registro que começa em byteOffset e, caso ele atenda a consulta, formata sua impressão na saida
+ * @return retorna 1 caso o registro tenha sido impresso e 0 caso contrário
+ */
+typedef int (*avaliaRegistro)(arquivoMapeado* mapa, long int byteOffset, void* consulta, saidaTrecho* saida);
+
+/**
+ * Sequência de blocos consecutivos do arquivo, processada inteira por uma única thread
+ */
+typedef struct trechoVarredura {
+    long int inicio;         // byteOffset do primeiro bloco do trecho
+    long int primeiroBloco;  // indice do primeiro bloco do trecho no arquivo
+    int nroBlocos;
+    saidaTrecho saida;
+    int encontrados;
+    int pronto;  // 1 quando a saida já pode ser impressa
+} trechoVarredura;
+
+/**
+ * Estado compartilhado entre as threads que avaliam os trechos e a impressão
+ */
+typedef struct varreduraParalela {
+    arquivoMapeado* mapa;
+    trechoVarredura* trechos;
+    int nroTrechos;
+    int proximoTrecho;     // próximo trecho ainda não pego por nenhuma thread
+    int trechosImpressos;  // trechos já impressos, sempre em ordem
+    int janela;            // máximo de trechos à frente da impressão
+    int encerrada;         // 1 quando a impressão não precisa de mais nenhum trecho
+    int apenasPrimeiro;    // 1 quando a consulta é por um campo único
+    avaliaRegistro avaliar;
+    void* consulta;
+    char* blocosPossiveis;  // blocos que precisam ser lidos, NULL para todos
+    pthread_mutex_t trava;
+    pthread_cond_t trechoPronto;
+    pthread_cond_t trechoImpresso;
+} varreduraParalela;
+
+char* reservaSaidaTrecho(saidaTrecho* saida, long int tamanhoMaximo);
+void confirmaSaidaTrecho(saidaTrecho* saida, char* fim);
+int varreBlocosParalelo(arquivoMapeado* mapa, int tamanhoHeader, avaliaRegistro avaliar, void* consulta,
+                        int apenasPrimeiro, char* blocosPossiveis);
+
+#endif
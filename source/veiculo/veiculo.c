@@ -3,19 +3,49 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 
 #include "../linha/linha.h"
 #include "../arvore/arvore.h"
 #include "../binario/binario.h"
+#include "../bloco/bloco.h"
+#include "../carga/carga.h"
 #include "../csv/csv.h"
+#include "../dicionario/dicionario.h"
+#include "../espacoLivre/espacoLivre.h"
+#include "../estatisticas/estatisticas.h"
+#include "../hash/hash.h"
+#include "../hashLinear/hashLinear.h"
+#include "../ordenacao/ordenacao.h"
 #include "../utils/utils.h"
+#include "../varredura/varredura.h"
+#include "../zona/zona.h"
 
 char MESES[][12] = {"janeiro", "fevereiro", "março", "abril",
                     "maio", "junho", "julho", "agosto",
                     "setembro", "outubro", "novembro", "dezembro"};  // todos os meses
 
 /**
- *  Valida o header de um arquivo
+ * Entrada dos arquivos de partição da junção por hash
+ * sequencia guarda a ordem do veiculo no arquivo e não é usada pelas linhas
+ */
+typedef struct entradaParticao {
+    long int sequencia;
+    long int byteOffset;
+    int chave;
+} entradaParticao;
+
+/**
+ * Par de registros encontrado pela junção por hash particionada
+ */
+typedef struct parJuncao {
+    long int sequencia;
+    long int byteOffsetVeiculo;
+    long int byteOffsetLinha;
+} parJuncao;
+
+/**
+ *  Valida o header de um arquivo, fechando o arquivo e liberando o dicionário do header caso ele seja recusado
  * @param arquivo arquivo de onde o header se origina
  * @param header header a ser verificado
  * @param verificaConsistencia flag que indica para testar a consistencia do arquivo
@@ -35,29 +65,33 @@ int validaHeader_veiculo(FILE** arquivo, veiculoHeader header, int verificaConsi
         correto = 0;
         ;
     }
-    if (!correto) fclose(*arquivo);
+    if (!correto) {
+        fclose(*arquivo);
+        liberaDicionario(header.dicionario);
+    }
     return correto;
 }
 
 /**
  * Lê um registro de veiculo do arquivo CSV lidando com campos nulos e os tamanhos
  * de registro total e dos campos variaveis
- * @param arquivoCSV nome do arquivo csv fonte dos dados
+ * @param leitor leitor do arquivo csv fonte dos dados
  * @param novoVeiculo variavel para salvar os dados
  * @return retorna 1 caso for o ultimo registro e 0 caso contrário
  */
-int lerVeiculo_CSV(FILE* arquivoCSV, veiculo* novoVeiculo) {
+int lerVeiculo_CSV(leitorCSV* leitor, veiculo* novoVeiculo) {
+    CONTA_CONCORRENTE(registrosCSV, 1);
     int tamanhoRegistro = 0;
-    novoVeiculo->removido = foiRemovido(arquivoCSV);
+    novoVeiculo->removido = foiRemovido(leitor);
 
-    lerStringFixa(arquivoCSV, novoVeiculo->prefixo, 5);
-    lerStringFixa(arquivoCSV, novoVeiculo->data, 10);
+    lerStringFixa(leitor, novoVeiculo->prefixo, 5);
+    lerStringFixa(leitor, novoVeiculo->data, 10);
 
-    novoVeiculo->quantidadeLugares = lerInteiro(arquivoCSV);
-    novoVeiculo->codLinha = lerInteiro(arquivoCSV);
+    novoVeiculo->quantidadeLugares = lerInteiro(leitor);
+    novoVeiculo->codLinha = lerInteiro(leitor);
 
-    int tamanhoModelo = lerString(arquivoCSV, novoVeiculo->modelo);
-    int tamanhoCategoria = lerString(arquivoCSV, novoVeiculo->categoria);
+    int tamanhoModelo = lerString(leitor, novoVeiculo->modelo);
+    int tamanhoCategoria = lerString(leitor, novoVeiculo->categoria);
 
     tamanhoRegistro += tamanhoModelo + tamanhoCategoria;
     tamanhoRegistro += 31;  // tamanho da parte fixa da struct
@@ -66,18 +100,20 @@ int lerVeiculo_CSV(FILE* arquivoCSV, veiculo* novoVeiculo) {
     novoVeiculo->tamanhoModelo = tamanhoModelo;
     novoVeiculo->tamanhoRegistro = tamanhoRegistro;
 
-    return finalDoArquivo(arquivoCSV);
+    return fimLeitorCSV(leitor);
 }
 
 /**
  * Lê um registro de veiculo do arquivo binário lidando com campos nulos e os tamanhos
  * de registro total e dos campos variaveis
  * @param arquivoBin nome do arquivo binário fonte dos dados
+ * @param dic dicionário do arquivo (header.dicionario)
  * @param currV variavel para salvar os dados
  * @param pos indica se deve ler o próximo registro (-1) ou algum em especifico
- * @return retorna 1 caso for o ultimo registro e 0 caso contrário
+ * @return retorna 1 caso for o ultimo registro e 0 caso contrário, o arquivo fica no inicio do próximo registro
  */
-int lerVeiculo_Bin(FILE* arquivoBin, veiculo* currV, long int pos) {
+int lerVeiculo_Bin(FILE* arquivoBin, dicionario* dic, veiculo* currV, long int pos) {
+    CONTA(registrosLidos, 1);
     if (pos != -1) fseek(arquivoBin, pos, 0);
     if (lerStringBin(arquivoBin, &currV->removido, 1) == -1) return 1;
     currV->tamanhoRegistro = lerInteiroBin(arquivoBin);
@@ -88,13 +124,90 @@ int lerVeiculo_Bin(FILE* arquivoBin, veiculo* currV, long int pos) {
     currV->quantidadeLugares = lerInteiroBin(arquivoBin);
     currV->codLinha = lerInteiroBin(arquivoBin);
 
-    currV->tamanhoModelo = lerInteiroBin(arquivoBin);
-    lerStringBin(arquivoBin, currV->modelo, currV->tamanhoModelo);
+    // campos codificados não ocupam bytes no registro, só o código no lugar do tamanho
+    int tamanhoLido = 31;
+    tamanhoLido += lerCampoDicionarioBin(arquivoBin, dic, 0, currV->modelo, &currV->tamanhoModelo);
+    tamanhoLido += lerCampoDicionarioBin(arquivoBin, dic, 1, currV->categoria, &currV->tamanhoCategoria);
 
-    currV->tamanhoCategoria = lerInteiroBin(arquivoBin);
-    lerStringBin(arquivoBin, currV->categoria, currV->tamanhoCategoria);
+    // um registro salvo no espaço de um removido maior tem bytes de sobra no fim
+    if (currV->tamanhoRegistro > tamanhoLido) {
+        fseek(arquivoBin, currV->tamanhoRegistro - tamanhoLido, SEEK_CUR);
+        currV->tamanhoRegistro = tamanhoLido;
+    }
 
-    return finalDoArquivo(arquivoBin);
+    return pulaEspacoLivre(arquivoBin, TAMANHO_HEADER_VEICULO);
+}
+
+/**
+ * Lê um registro de veiculo de um arquivo mapeado sem copiar os campos variaveis,
+ * as strings da visão apontam para dentro da região mapeada
+ * @param mapa arquivo mapeado fonte dos dados
+ * @param dic dicionário do arquivo (header.dicionario)
+ * @param currV visão onde o registro será descrito
+ * @param pos indica se deve ler o próximo registro (-1) ou algum em especifico
+ * @return retorna 1 caso for o ultimo registro e 0 caso contrário, a posição fica no inicio do próximo registro
+ */
+int lerVeiculo_Mapa(arquivoMapeado* mapa, dicionario* dic, visaoVeiculo* currV, long int pos) {
+    CONTA_CONCORRENTE(registrosLidos, 1);
+    if (pos != -1) mapa->posicao = pos;
+    if (!restamBytesMapa(mapa, 1)) return 1;
+
+    currV->removido = mapa->dados[mapa->posicao++];
+    currV->tamanhoRegistro = lerInteiroMapa(mapa);
+
+    currV->prefixo = lerStringMapa(mapa, 5);
+    currV->data = lerStringMapa(mapa, 10);
+
+    currV->quantidadeLugares = lerInteiroMapa(mapa);
+    currV->codLinha = lerInteiroMapa(mapa);
+
+    // campos codificados apontam para o valor no dicionário
+    long int inicioModelo = mapa->posicao;
+    currV->modelo = lerCampoDicionarioMapa(mapa, dic, 0, &currV->tamanhoModelo, &currV->codigoModelo);
+    currV->categoria = lerCampoDicionarioMapa(mapa, dic, 1, &currV->tamanhoCategoria, &currV->codigoCategoria);
+
+    // um registro salvo no espaço de um removido maior tem bytes de sobra no fim
+    int tamanhoLido = 23 + (int)(mapa->posicao - inicioModelo);
+    if (currV->tamanhoRegistro > tamanhoLido) {
+        mapa->posicao += currV->tamanhoRegistro - tamanhoLido;
+        currV->tamanhoRegistro = tamanhoLido;
+    }
+
+    return pulaEspacoLivreMapa(mapa, TAMANHO_HEADER_VEICULO);
+}
+
+/**
+ * Posiciona a leitura sequencial de um arquivo mapeado no primeiro registro de dados
+ * @param mapa arquivo mapeado de veiculos
+ * @return retorna 1 caso o arquivo não tenha registros e 0 caso contrário
+ */
+int posicionaPrimeiroVeiculo(arquivoMapeado* mapa) {
+    mapa->posicao = TAMANHO_HEADER_VEICULO;
+    return pulaEspacoLivreMapa(mapa, TAMANHO_HEADER_VEICULO);
+}
+
+/**
+ * Cria uma visão que aponta para os campos de um veiculo já lido
+ * @param currV veiculo de onde os campos serão apontados
+ * @return visão do veiculo
+ */
+visaoVeiculo visaoDoVeiculo(veiculo* currV) {
+    visaoVeiculo visao;
+
+    visao.removido = currV->removido;
+    visao.tamanhoRegistro = currV->tamanhoRegistro;
+    visao.prefixo = currV->prefixo;
+    visao.data = currV->data;
+    visao.quantidadeLugares = currV->quantidadeLugares;
+    visao.codLinha = currV->codLinha;
+    visao.tamanhoModelo = currV->tamanhoModelo;
+    visao.modelo = currV->modelo;
+    visao.tamanhoCategoria = currV->tamanhoCategoria;
+    visao.categoria = currV->categoria;
+    visao.codigoModelo = -1;
+    visao.codigoCategoria = -1;
+
+    return visao;
 }
 
 /**
@@ -120,19 +233,29 @@ void lerVeiculo_Terminal(veiculo* currV) {
 }
 
 /**
- * Imprime a data no formato solicitado
+ * Escreve a data no formato solicitado
+ * @param destino posição atual da saída
  * @param descricao descricao do campo
  * @param stringData string original no formato salvo
+ * @return posição seguinte ao texto escrito
  */
-void imprimeData(char* descricao, char* stringData) {
-    printf("%s: ", descricao);
-    if (stringData[0] != '\0') {  //testa se a data é nula
+char* formataData(char* destino, char* descricao, char* stringData) {
+    destino = formataRotulo(destino, descricao);
+
+    if (stringData != NULL && stringData[0] != '\0') {  //testa se a data é nula
         int indiceDoMes =
             (stringData[5] - '0') * 10 + (stringData[6] - '0') - 1;  // calcula o indice do mes e translada para entre 0-11
-        printf("%.2s de %s de %.4s\n", stringData + 8, MESES[indiceDoMes], stringData);
+        destino = formataTexto(destino, stringData + 8, strnlen(stringData + 8, 2));
+        destino = formataTexto(destino, " de ", 4);
+        destino = formataTexto(destino, MESES[indiceDoMes], strlen(MESES[indiceDoMes]));
+        destino = formataTexto(destino, " de ", 4);
+        destino = formataTexto(destino, stringData, strnlen(stringData, 4));
     } else {
-        printf("campo com valor nulo\n");
+        destino = formataTexto(destino, VALOR_NULO, sizeof(VALOR_NULO) - 1);
     }
+
+    *destino++ = '\n';
+    return destino;
 }
 
 /**
@@ -142,62 +265,411 @@ void imprimeData(char* descricao, char* stringData) {
  * @param quebraLinha flag que indica se quebra de linha deve ser executada
  */
 void imprimeVeiculo(veiculo currVeiculo, veiculoHeader header, int quebraLinha) {
-    imprimirCampo(header.descrevePrefixo, currVeiculo.prefixo, 0);
-    imprimirCampo(header.descreveModelo, currVeiculo.modelo, 0);
-    imprimirCampo(header.descreveCategoria, currVeiculo.categoria, 0);
-    imprimeData(header.descreveData, currVeiculo.data);  //impressão diferente devido ao formato
-    imprimirCampo(header.descreveLugares, &currVeiculo.quantidadeLugares, 1);
-    if (quebraLinha) printf("\n");
+    visaoVeiculo visao = visaoDoVeiculo(&currVeiculo);
+    imprimeVisaoVeiculo(&visao, &header, quebraLinha);
 }
 
 /**
- * Salva um novo veiculo em um arquivo binário na posição indicada pelo header
- * e atualiza quantidade de registros e próxima prosição de salvamento
- * @param arquivoBin arquivo onde o veiculo será salvo
- * @param currV veicuo que será salvo
- * @param header header do arquivo binário
+ * Imprime os campos da visão de um veiculo conforme a formatação requisitada
+ * @param currVeiculo visão do veiculo a ser impresso
+ * @param header header do arquivo
+ * @param quebraLinha flag que indica se quebra de linha deve ser executada
+ */
+void imprimeVisaoVeiculo(visaoVeiculo* currVeiculo, veiculoHeader* header, int quebraLinha) {
+    CONTA(registrosDevolvidos, 1);
+
+    // o registro inteiro é montado em memória e entregue à saída com uma única escrita
+    char saidaLocal[TAMANHO_SAIDA_REGISTRO];
+    int tamanhoMaximo = tamanhoSaidaVeiculo(currVeiculo);
+    char* saida = (tamanhoMaximo <= TAMANHO_SAIDA_REGISTRO) ? saidaLocal : (char*)malloc(tamanhoMaximo);
+
+    char* fim = formataVisaoVeiculo(saida, currVeiculo, header, quebraLinha);
+
+    fwrite(saida, sizeof(char), fim - saida, stdout);
+    if (saida != saidaLocal) free(saida);
+}
+
+/**
+ * @param currVeiculo visão do veiculo a ser impresso
+ * @return retorna a maior quantidade de bytes que a impressão do veiculo pode ocupar
+ */
+int tamanhoSaidaVeiculo(visaoVeiculo* currVeiculo) {
+    return TAMANHO_SAIDA_FIXA + (currVeiculo->tamanhoModelo > 0 ? currVeiculo->tamanhoModelo : 0) +
+           (currVeiculo->tamanhoCategoria > 0 ? currVeiculo->tamanhoCategoria : 0);
+}
+
+/**
+ * Monta em memória a impressão de um veiculo, no mesmo formato do imprimeVisaoVeiculo
+ * @param destino região com ao menos tamanhoSaidaVeiculo bytes
+ * @param currVeiculo visão do veiculo a ser impresso
+ * @param header header do arquivo
+ * @param quebraLinha flag que indica se quebra de linha deve ser executada
+ * @return retorna a posição logo após o ultimo byte escrito
+ */
+char* formataVisaoVeiculo(char* destino, visaoVeiculo* currVeiculo, veiculoHeader* header, int quebraLinha) {
+    char* fim = destino;
+    fim = formataCampoTamanho(fim, header->descrevePrefixo, currVeiculo->prefixo, 5);
+    fim = formataCampoTamanho(fim, header->descreveModelo, currVeiculo->modelo, currVeiculo->tamanhoModelo);
+    fim = formataCampoTamanho(fim, header->descreveCategoria, currVeiculo->categoria, currVeiculo->tamanhoCategoria);
+    fim = formataData(fim, header->descreveData, currVeiculo->data);  //impressão diferente devido ao formato
+    fim = formataCampo(fim, header->descreveLugares, currVeiculo->quantidadeLugares);
+    if (quebraLinha) *fim++ = '\n';
+    return fim;
+}
+
+/**
+ * @param currV veiculo
+ * @return tamanhoRegistro do veiculo gravado, sem os bytes dos campos codificados pelo dicionário
+ */
+int tamanhoGravadoVeiculo(dicionario* dic, veiculo* currV) {
+    return 31 + bytesCampoDicionario(dic, currV->tamanhoModelo) + bytesCampoDicionario(dic, currV->tamanhoCategoria);
+}
+
+/**
+ * Escreve os campos de um veiculo em uma região de memória, no mesmo formato do arquivo binário
+ * atualiza o tamanhoRegistro do veiculo conforme os campos codificados pelo dicionário
+ * @param destino região onde o veiculo será escrito
+ * @param dic dicionário do arquivo de destino
+ * @param currV veiculo que será escrito
+ * @return retorna a quantidade de bytes escritos
+ */
+int codificaVeiculo(char* destino, dicionario* dic, veiculo* currV) {
+    char* atual = destino;
+    currV->tamanhoRegistro = tamanhoGravadoVeiculo(dic, currV);
+
+    *atual++ = currV->removido;
+    memcpy(atual, &currV->tamanhoRegistro, sizeof(int));
+    atual += sizeof(int);
+    memcpy(atual, currV->prefixo, 5);
+    atual += 5;
+    memcpy(atual, currV->data, 10);
+    atual += 10;
+    memcpy(atual, &currV->quantidadeLugares, sizeof(int));
+    atual += sizeof(int);
+    memcpy(atual, &currV->codLinha, sizeof(int));
+    atual += sizeof(int);
+
+    atual = codificaCampoDicionario(atual, dic, 0, currV->modelo, currV->tamanhoModelo);
+    atual = codificaCampoDicionario(atual, dic, 1, currV->categoria, currV->tamanhoCategoria);
+
+    return atual - destino;
+}
+
+/**
+ * Lê o próximo veiculo do CSV e o escreve já no formato do binário, usado pela carga paralela
+ * @param leitor leitor do trecho do CSV
+ * @param contexto dicionário do arquivo em criação, já com todos os valores do CSV
+ * @param destino região onde o veiculo será escrito
+ * @param removido variável onde será salvo se o veiculo foi removido
+ * @return retorna a quantidade de bytes escritos
+ */
+int codificaVeiculoCSV(leitorCSV* leitor, void* contexto, char* destino, char* removido) {
+    veiculo novoVeiculo;
+    lerVeiculo_CSV(leitor, &novoVeiculo);
+    *removido = novoVeiculo.removido;
+    return codificaVeiculo(destino, (dicionario*)contexto, &novoVeiculo);
+}
+
+/**
+ * Converte uma data no formato AAAA-MM-DD para o inteiro AAAAMMDD resumido no mapa de zonas
+ * @param data data, não necessariamente terminada em \0
+ * @param tamanho quantidade de bytes da data
+ * @return 0 para a data nula e VALOR_QUALQUER_ZONA quando a data não está no formato
  */
-void salvaVeiculo(FILE* arquivoBin, veiculo* currV, veiculoHeader* header) {
-    if(ftell(arquivoBin) != header->byteProxReg) fseek(arquivoBin, header->byteProxReg, SEEK_SET);
+int chaveDataZona(char* data, int tamanho) {
+    if (tamanho == 0) return 0;
+    if (tamanho != 10 || data[4] != '-' || data[7] != '-') return VALOR_QUALQUER_ZONA;
+
+    int chave = 0;
+    for (int i = 0; i < 10; i++) {
+        if (i == 4 || i == 7) continue;
+        if (data[i] < '0' || data[i] > '9') return VALOR_QUALQUER_ZONA;
+        chave = chave * 10 + (data[i] - '0');
+    }
 
-    fwrite(&currV->removido, sizeof(char), 1, arquivoBin);
-    fwrite(&currV->tamanhoRegistro, sizeof(int), 1, arquivoBin);
-    fwrite(&currV->prefixo, sizeof(char), 5, arquivoBin);
-    fwrite(&currV->data, sizeof(char), 10, arquivoBin);
-    fwrite(&currV->quantidadeLugares, sizeof(int), 1, arquivoBin);
-    fwrite(&currV->codLinha, sizeof(int), 1, arquivoBin);
+    return chave;
+}
 
-    fwrite(&currV->tamanhoModelo, sizeof(int), 1, arquivoBin);
-    fwrite(&currV->modelo, sizeof(char), currV->tamanhoModelo, arquivoBin);
+/**
+ * Valores de um veiculo resumidos no mapa de zonas, na ordem dos campos do cabeçalho (data, lugares e linha)
+ * @param currV visão do veiculo
+ * @param valores vetor de CAMPOS_ZONA_VEICULO posições
+ */
+void valoresZonaVeiculo(visaoVeiculo* currV, int* valores) {
+    valores[0] = chaveDataZona(currV->data, currV->data[0] == '\0' ? 0 : (int)strnlen(currV->data, 10));
+    valores[1] = currV->quantidadeLugares;
+    valores[2] = currV->codLinha;
+}
 
-    fwrite(&currV->tamanhoCategoria, sizeof(int), 1, arquivoBin);
-    fwrite(&currV->categoria, sizeof(char), currV->tamanhoCategoria, arquivoBin);
+/**
+ * Inclui um veiculo gravado no mapa de zonas do arquivo
+ * @param zonas mapa de zonas ou NULL caso ele não seja mantido
+ * @param currV veiculo gravado
+ * @param byteOffset posição onde o veiculo foi gravado
+ */
+void registraVeiculoZona(mapaZonas* zonas, veiculo* currV, long int byteOffset) {
+    if (zonas == NULL) return;
+
+    visaoVeiculo visao = visaoDoVeiculo(currV);
+    int valores[CAMPOS_ZONA_VEICULO];
+    valoresZonaVeiculo(&visao, valores);
+    registraValoresZona(zonas, byteOffset, valores);
+}
+
+/**
+ * Acrescenta um novo veiculo ao buffer de escrita do binário, que será gravado junto dos próximos registros
+ * e atualiza quantidade de registros e próxima posição de salvamento
+ * com uma lista de espaços livres, um veiculo não removido é gravado no menor registro removido onde cabe,
+ * mantendo o tamanhoRegistro do espaço para que as leituras pulem a sobra
+ * o header só é gravado pelo chamador, depois que o buffer for descarregado
+ * @param buffer buffer de escrita posicionado no fim do arquivo, no formato do arquivo
+ * @param currV veiculo que será salvo
+ * @param header header do arquivo binário
+ * @param livres espaços livres do arquivo ou NULL para gravar sempre no fim
+ * @param zonas mapa de zonas do arquivo ou NULL caso ele não seja mantido
+ * @return retorna o byteOffset onde o veiculo foi salvo
+ */
+long int salvaVeiculoBuffer(bufferEscrita* buffer, veiculo* currV, veiculoHeader* header, listaEspacoLivre* livres,
+                            mapaZonas* zonas) {
+    long int byteOffset;
+    int tamanhoEspaco;
+    currV->tamanhoRegistro = tamanhoGravadoVeiculo(header->dicionario, currV);
+
+    if (livres != NULL && currV->removido == '1' && retiraMelhorEspaco(livres, currV->tamanhoRegistro, &byteOffset, &tamanhoEspaco)) {
+        char* registroCodificado = (char*)malloc(sizeof(veiculo) + tamanhoEspaco);
+        int tamanho = codificaVeiculo(registroCodificado, header->dicionario, currV);
+
+        memcpy(registroCodificado + 1, &tamanhoEspaco, sizeof(int));
+        memset(registroCodificado + tamanho, '@', 5 + tamanhoEspaco - tamanho);
+        escreveBufferEscritaEm(buffer, byteOffset, registroCodificado, 5 + tamanhoEspaco);
+        free(registroCodificado);
+
+        header->nroRegRemovidos--;
+        header->nroRegistros++;
+        registraVeiculoZona(zonas, currV, byteOffset);
+        return byteOffset;
+    }
 
-    header->byteProxReg = ftell(arquivoBin);
+    char* destino = reservaBufferEscrita(buffer, sizeof(veiculo));
+    byteOffset = posicaoLivreBufferEscrita(buffer);
+    int tamanho = codificaVeiculo(destino, header->dicionario, currV);
+    confirmaBufferEscrita(buffer, tamanho);
+
+    header->byteProxReg = posicaoLivreBufferEscrita(buffer);
     header->nroRegRemovidos += (currV->removido == '0') ? 1 : 0;
     header->nroRegistros += (currV->removido == '0') ? 0 : 1;
+
+    if (livres != NULL && currV->removido == '0') adicionaEspacoLivre(livres, byteOffset, currV->tamanhoRegistro);
+    registraVeiculoZona(zonas, currV, byteOffset);
+    return byteOffset;
+}
+
+/**
+ * Obtém a lista de espaços livres de um arquivo de veiculos quando o reuso está ativo (REUSO_ESPACO=1),
+ * a lista salva ao lado do arquivo é usada se ainda corresponder a ele, senão o arquivo é percorrido
+ * @param arquivoBin arquivo de dados, ainda não alterado
+ * @param nomeArquivoBin nome do arquivo de dados
+ * @return lista de espaços livres ou NULL caso o reuso esteja desativado
+ */
+listaEspacoLivre* carregaEspacoLivre_Veiculo(FILE* arquivoBin, char nomeArquivoBin[100]) {
+    if (!lerConfiguracao("REUSO_ESPACO", 0)) return NULL;
+
+    char nomeLista[256];
+    nomeListaEspacoLivre(nomeLista, nomeArquivoBin);
+    listaEspacoLivre* livres = carregaListaEspacoLivre(nomeLista, nomeArquivoBin);
+    if (livres != NULL) return livres;
+
+    livres = criaListaEspacoLivre();
+
+    arquivoMapeado mapa;
+    if (!mapeiaConteudo(arquivoBin, &mapa, 1)) return livres;
+
+    visaoVeiculo veiculoTemp;
+    int isFinalDoArquivo = posicionaPrimeiroVeiculo(&mapa);
+
+    // o espaço de cada removido é o tamanhoRegistro gravado, que inclui a sobra de um reuso anterior,
+    // só os tamanhos são usados e eles não dependem do dicionário
+    while (!isFinalDoArquivo) {
+        long int byteOffset = mapa.posicao;
+        isFinalDoArquivo = lerVeiculo_Mapa(&mapa, NULL, &veiculoTemp, -1);
+        if (veiculoTemp.removido != '0') continue;
+
+        int tamanhoEspaco;
+        memcpy(&tamanhoEspaco, mapa.dados + byteOffset + 1, sizeof(int));
+        adicionaEspacoLivre(livres, byteOffset, tamanhoEspaco);
+    }
+
+    desmapeiaArquivo(&mapa);
+    return livres;
+}
+
+/**
+ * Salva a lista de espaços livres ao lado do arquivo de dados, que já deve estar fechado, e a libera
+ * @param livres lista de espaços livres, NULL caso o reuso esteja desativado
+ * @param nomeArquivoBin nome do arquivo de dados
+ */
+void finalizaEspacoLivre_Veiculo(listaEspacoLivre* livres, char nomeArquivoBin[100]) {
+    if (livres == NULL) return;
+
+    char nomeLista[256];
+    nomeListaEspacoLivre(nomeLista, nomeArquivoBin);
+    salvaListaEspacoLivre(livres, nomeLista, nomeArquivoBin);
+    liberaListaEspacoLivre(livres);
+}
+
+/**
+ * Obtém o mapa de zonas de um arquivo de veiculos para ser atualizado pelas inserções (MAPA_ZONAS=1),
+ * um mapa que não corresponde mais ao arquivo é deixado para ser remontado pela próxima busca
+ * @param nomeArquivoBin nome do arquivo de dados, ainda não alterado
+ * @param header header do arquivo de dados
+ * @return mapa de zonas ou NULL caso ele não seja mantido
+ */
+mapaZonas* carregaZonas_Veiculo(char nomeArquivoBin[100], veiculoHeader* header) {
+    if (header->formato != FORMATO_BLOCOS || !mapaZonasAtivo()) return NULL;
+    return carregaMapaZonas(nomeArquivoBin, CAMPOS_ZONA_VEICULO, TAMANHO_HEADER_VEICULO);
+}
+
+/**
+ * Salva o mapa de zonas ao lado do arquivo de dados, que já deve estar fechado, e o libera
+ * @param zonas mapa de zonas, NULL caso ele não seja mantido
+ * @param nomeArquivoBin nome do arquivo de dados
+ */
+void finalizaZonas_Veiculo(mapaZonas* zonas, char nomeArquivoBin[100]) {
+    if (zonas == NULL) return;
+
+    salvaMapaZonas(zonas, nomeArquivoBin);
+    liberaMapaZonas(zonas);
+}
+
+/**
+ * Marca os blocos que podem ter veiculos que atendem a busca, usando o mapa de zonas salvo ao lado do arquivo
+ * ou, caso ele não corresponda ao arquivo, remontando e salvando o mapa a partir do diretório de cada bloco
+ * @param nomeArquivoBin nome do arquivo de dados
+ * @param mapa arquivo de dados mapeado, no formato em blocos
+ * @param consulta condição da busca
+ * @return vetor alocado de blocosPossiveisZona ou NULL caso todos os blocos precisem ser lidos
+ */
+char* blocosPossiveis_Veiculo(char nomeArquivoBin[100], arquivoMapeado* mapa, consultaVeiculo* consulta) {
+    if (consulta->campo < 1 || consulta->campo > 3 || !mapaZonasAtivo()) return NULL;  // só data, lugares e linha
+
+    int campoZona = consulta->campo - 1;
+    int valor = (campoZona == 0) ? chaveDataZona(consulta->valor, (int)strlen(consulta->valor)) : consulta->valorInteiro;
+    if (valor == VALOR_QUALQUER_ZONA) return NULL;
+
+    long int nroBlocos = (mapa->tamanho - TAMANHO_HEADER_VEICULO) / TAMANHO_BLOCO_DADOS;
+    mapaZonas* zonas = carregaMapaZonas(nomeArquivoBin, CAMPOS_ZONA_VEICULO, TAMANHO_HEADER_VEICULO);
+
+    if (zonas == NULL) {
+        zonas = criaMapaZonas(CAMPOS_ZONA_VEICULO, TAMANHO_HEADER_VEICULO);
+        arquivoMapeado leitura = *mapa;
+        visaoVeiculo veiculoTemp;
+        int valores[CAMPOS_ZONA_VEICULO];
+
+        for (long int i = 0; i < nroBlocos; i++) {
+            long int inicioBloco = TAMANHO_HEADER_VEICULO + i * TAMANHO_BLOCO_DADOS;
+            char* bloco = mapa->dados + inicioBloco;
+
+            for (int j = 0; j < nroRegistrosBloco(bloco); j++) {
+                long int byteOffset = inicioBloco + posicaoRegistroBloco(bloco, j);
+                lerVeiculo_Mapa(&leitura, consulta->header->dicionario, &veiculoTemp, byteOffset);
+                valoresZonaVeiculo(&veiculoTemp, valores);
+                registraValoresZona(zonas, byteOffset, valores);
+            }
+        }
+
+        salvaMapaZonas(zonas, nomeArquivoBin);
+    }
+
+    char* possiveis = blocosPossiveisZona(zonas, campoZona, valor, nroBlocos);
+    liberaMapaZonas(zonas);
+    return possiveis;
+}
+
+// campos string que podem ter um indice hash
+#define NRO_CAMPOS_STRING_VEICULO 4
+static char* camposString_Veiculo[NRO_CAMPOS_STRING_VEICULO] = {"prefixo", "data", "modelo", "categoria"};
+
+/**
+ * Verifica se um campo do veiculo é uma string
+ * @param campo nome do campo
+ * @return retorna 1 caso o campo seja uma string e 0 caso contrário
+ */
+int campoEhString_Veiculo(char* campo) {
+    for (int i = 0; i < NRO_CAMPOS_STRING_VEICULO; i++)
+        if (strcmp(campo, camposString_Veiculo[i]) == 0) return 1;
+    return 0;
+}
+
+/**
+ * Remove os indices hash de todos os campos string, que deixam de valer quando o arquivo de dados é alterado
+ * @param nomeArquivoBin nome do arquivo de dados
+ */
+void removeIndicesHash_Veiculo(char nomeArquivoBin[100]) {
+    for (int i = 0; i < NRO_CAMPOS_STRING_VEICULO; i++) removeHashLinear(nomeArquivoBin, camposString_Veiculo[i]);
 }
 
 /**
  * Lê o header do CSV e salva no header do binário
- * @param arquivoCSV arquivo de onde o header será lido
+ * @param leitor leitor do arquivo de onde o header será lido
  * @param header header onde será salvo
  */
-void lerHeaderCSV_Veiculo(FILE* arquivoCSV, veiculoHeader* header) {
-    lerString(arquivoCSV, header->descrevePrefixo);
-    lerString(arquivoCSV, header->descreveData);
-    lerString(arquivoCSV, header->descreveLugares);
-    lerString(arquivoCSV, header->descreveLinha);
-    lerString(arquivoCSV, header->descreveModelo);
-    lerString(arquivoCSV, header->descreveCategoria);
+void lerHeaderCSV_Veiculo(leitorCSV* leitor, veiculoHeader* header) {
+    lerString(leitor, header->descrevePrefixo);
+    lerString(leitor, header->descreveData);
+    lerString(leitor, header->descreveLugares);
+    lerString(leitor, header->descreveLinha);
+    lerString(leitor, header->descreveModelo);
+    lerString(leitor, header->descreveCategoria);
 }
 
 /**
- * Lê o header de um arquivo binário
+ * Monta o dicionário dos modelos e categorias de um CSV de veiculos, percorrendo os registros na ordem do
+ * arquivo para que os códigos não dependam da divisão da carga paralela, que depois só consulta o dicionário
+ * @param dados registros do CSV, sem o header
+ * @param tamanho quantidade de bytes dos registros
+ * @return dicionário com todos os valores do CSV
+ */
+dicionario* montaDicionarioCSV_Veiculo(char* dados, long int tamanho) {
+    dicionario* dic = criaDicionario(CAMPOS_DICIONARIO_VEICULO);
+    leitorCSV leitor;
+    veiculo novoVeiculo;
+    iniciaLeitorCSVMemoria(&leitor, dados, tamanho);
+
+    int isFinalDoArquivo = fimLeitorCSV(&leitor);
+    while (!isFinalDoArquivo) {
+        isFinalDoArquivo = lerVeiculo_CSV(&leitor, &novoVeiculo);
+        if (novoVeiculo.tamanhoModelo > 0) codigoDicionario(dic, 0, novoVeiculo.modelo, novoVeiculo.tamanhoModelo);
+        if (novoVeiculo.tamanhoCategoria > 0) codigoDicionario(dic, 1, novoVeiculo.categoria, novoVeiculo.tamanhoCategoria);
+    }
+
+    finalizaLeitorCSV(&leitor);
+    return dic;
+}
+
+/**
+ * Salva o dicionário do header ao lado do arquivo de dados caso ele tenha ganhado valores ou, caso os campos
+ * tenham sido gravados por extenso, remove um dicionário antigo com o mesmo nome. Depois libera o dicionário
+ * @param header header do arquivo de dados
+ * @param nomeArquivoBin nome do arquivo de dados
+ */
+void finalizaDicionario_Veiculo(veiculoHeader* header, char nomeArquivoBin[100]) {
+    if (header->dicionario == NULL)
+        removeDicionario(nomeArquivoBin);
+    else if (header->dicionario->alterado)
+        salvaDicionario(header->dicionario, nomeArquivoBin);
+
+    liberaDicionario(header->dicionario);
+    header->dicionario = NULL;
+}
+
+/**
+ * Lê o header de um arquivo binário e posiciona o arquivo no primeiro registro
+ * o dicionário do arquivo, caso exista, é carregado no header e deve ser liberado por quem leu o header
  * @param arquivoBin arquivo de onde será lido
+ * @param nomeArquivoBin nome do arquivo, usado para encontrar o dicionário
  * @param header variável onde o header será salvo
  */
-void lerHeaderBin_Veiculo(FILE* arquivoBin, veiculoHeader* header) {
+void lerHeaderBin_Veiculo(FILE* arquivoBin, char* nomeArquivoBin, veiculoHeader* header) {
     fseek(arquivoBin, 0, SEEK_SET);
 
     fread(&header->status, sizeof(char), 1, arquivoBin);
@@ -210,6 +682,10 @@ void lerHeaderBin_Veiculo(FILE* arquivoBin, veiculoHeader* header) {
     lerStringBin(arquivoBin, header->descreveLinha, 26);
     lerStringBin(arquivoBin, header->descreveModelo, 17);
     lerStringBin(arquivoBin, header->descreveCategoria, 20);
+
+    header->formato = formatoArquivoDados(arquivoBin, TAMANHO_HEADER_VEICULO);
+
+    header->dicionario = carregaDicionario(nomeArquivoBin, CAMPOS_DICIONARIO_VEICULO);
 }
 
 /**
@@ -243,26 +719,42 @@ void CreateTable_Veiculo(char nomeArquivoCSV[100], char nomeArquivoBin[100]) {
 
     if (!abrirArquivo(&arquivoCSV, nomeArquivoCSV, "r", 1)) return;
 
-    abrirArquivo(&arquivoBin, nomeArquivoBin, "wb", 0);
+    arquivoMapeado mapaCSV;
+    if (!mapeiaArquivo(&arquivoCSV, &mapaCSV, 1)) return;
+
+    if (!abrirArquivo(&arquivoBin, nomeArquivoBin, "wb", 1)) {
+        desmapeiaArquivo(&mapaCSV);
+        fclose(arquivoCSV);
+        return;
+    }
 
     veiculoHeader novoHeader;
-    veiculo novoVeiculo;
 
     //definindo valores iniciais do header
     novoHeader.status = '0';
     novoHeader.byteProxReg = 175;
     novoHeader.nroRegistros = 0;
     novoHeader.nroRegRemovidos = 0;
+    novoHeader.formato = (lerConfiguracao("FORMATO_DADOS", FORMATO_FLUXO) == FORMATO_BLOCOS) ? FORMATO_BLOCOS : FORMATO_FLUXO;
+
+    leitorCSV leitor;
+    iniciaLeitorCSVMemoria(&leitor, mapaCSV.dados, mapaCSV.tamanho);
 
-    lerHeaderCSV_Veiculo(arquivoCSV, &novoHeader);
+    lerHeaderCSV_Veiculo(&leitor, &novoHeader);
     salvaHeader_Veiculo(arquivoBin, &novoHeader);
 
-    int isFinalDoArquivo = finalDoArquivo(arquivoCSV);
-    //percorre o arquivo até o final
-    while (!isFinalDoArquivo) {
-        isFinalDoArquivo = lerVeiculo_CSV(arquivoCSV, &novoVeiculo);
-        salvaVeiculo(arquivoBin, &novoVeiculo, &novoHeader);
-    }
+    // com DICIONARIO=1 modelo e categoria são gravados como códigos do dicionário do arquivo
+    novoHeader.dicionario = NULL;
+    if (lerConfiguracao("DICIONARIO", 0) > 0)
+        novoHeader.dicionario = montaDicionarioCSV_Veiculo(mapaCSV.dados + leitor.posicao, mapaCSV.tamanho - leitor.posicao);
+
+    // os registros são convertidos em paralelo e escritos na ordem do CSV logo após o header
+    bufferEscrita buffer;
+    iniciaBufferEscritaFormato(&buffer, arquivoBin, novoHeader.formato, TAMANHO_HEADER_VEICULO, novoHeader.byteProxReg);
+    carregaCSVParalelo(mapaCSV.dados + leitor.posicao, mapaCSV.tamanho - leitor.posicao, &buffer, codificaVeiculoCSV,
+                       novoHeader.dicionario, sizeof(veiculo), &novoHeader.nroRegistros, &novoHeader.nroRegRemovidos);
+    descarregaBufferEscrita(&buffer);
+    novoHeader.byteProxReg = posicaoLivreBufferEscrita(&buffer);
 
     novoHeader.status = '1';
 
@@ -270,6 +762,11 @@ void CreateTable_Veiculo(char nomeArquivoCSV[100], char nomeArquivoBin[100]) {
 
     //fecha todos arquivos abertos
     fclose(arquivoBin);
+    removeListaEspacoLivre(nomeArquivoBin);  // a lista e os indices hash de um arquivo anterior com o mesmo nome não valem mais
+    removeIndicesHash_Veiculo(nomeArquivoBin);
+    finalizaDicionario_Veiculo(&novoHeader, nomeArquivoBin);
+    finalizaLeitorCSV(&leitor);
+    desmapeiaArquivo(&mapaCSV);
     fclose(arquivoCSV);
 
     binarioNaTela(nomeArquivoBin);
@@ -284,31 +781,211 @@ void SelectFrom_Veiculo(char nomeArquivoBin[100]) {
     if (!abrirArquivo(&arquivoBin, nomeArquivoBin, "rb", 1)) return;
 
     veiculoHeader novoHeader;
-    veiculo novoVeiculo;
+    visaoVeiculo novoVeiculo;
+    arquivoMapeado mapa;
 
-    lerHeaderBin_Veiculo(arquivoBin, &novoHeader);
+    lerHeaderBin_Veiculo(arquivoBin, nomeArquivoBin, &novoHeader);
     if (!validaHeader_veiculo(&arquivoBin, novoHeader, 1, 1)) return;
+    if (!mapeiaArquivo(&arquivoBin, &mapa, 1)) {
+        liberaDicionario(novoHeader.dicionario);
+        return;
+    }
 
-    int isFinalDoArquivo = finalDoArquivo(arquivoBin);
+    int isFinalDoArquivo = posicionaPrimeiroVeiculo(&mapa);  // posiciona para o primeiro registro de dados
     //percorre todo o arquivo imprimindo apenas os registros salvos
     while (!isFinalDoArquivo) {
-        isFinalDoArquivo = lerVeiculo_Bin(arquivoBin, &novoVeiculo, -1);
-        if (novoVeiculo.removido == '1') imprimeVeiculo(novoVeiculo, novoHeader, 1);
+        isFinalDoArquivo = lerVeiculo_Mapa(&mapa, novoHeader.dicionario, &novoVeiculo, -1);
+        if (novoVeiculo.removido == '1') imprimeVisaoVeiculo(&novoVeiculo, &novoHeader, 1);
     }
 
+    desmapeiaArquivo(&mapa);
     fclose(arquivoBin);
+    liberaDicionario(novoHeader.dicionario);
 }
 
 /**
- * Compara dois veiculos
- * @param veiculoA primeiro veiculo
- * @param veiculoB segundo veiculo
- * @return retorna veiculoA->codLinha - veiculoB->codLinha
+ * Devolve o valor de um campo string de um veiculo, no mesmo formato comparado por stringIgual
+ * @param currVeiculo veiculo de onde o campo será lido
+ * @param campo nome do campo
+ * @param tamanho variável onde o tamanho do valor será salvo
+ * @return ponteiro para o inicio do valor, que pode ser NULL quando o campo é nulo
  */
-int compararVeiculos(const void* veiculoA, const void* veiculoB) {
-    int a = (*(veiculo*)veiculoA).codLinha;
-    int b = (*(veiculo*)veiculoB).codLinha;
-    return a - b;
+char* lerCampoString_Veiculo(visaoVeiculo* currVeiculo, char* campo, int* tamanho) {
+    char* valor;
+    int tamanhoMaximo;
+
+    if (strcmp(campo, "prefixo") == 0) {
+        valor = currVeiculo->prefixo;
+        tamanhoMaximo = 5;
+    } else if (strcmp(campo, "data") == 0) {
+        valor = currVeiculo->data;
+        tamanhoMaximo = 10;
+    } else if (strcmp(campo, "modelo") == 0) {
+        valor = currVeiculo->modelo;
+        tamanhoMaximo = currVeiculo->tamanhoModelo;
+    } else if (strcmp(campo, "categoria") == 0) {
+        valor = currVeiculo->categoria;
+        tamanhoMaximo = currVeiculo->tamanhoCategoria;
+    } else {
+        *tamanho = 0;
+        return NULL;
+    }
+
+    *tamanho = (valor == NULL || tamanhoMaximo <= 0) ? 0 : (int)strnlen(valor, tamanhoMaximo);
+    return valor;
+}
+
+/**
+ *  Responde um SelectFromWhere usando o indice hash do campo, caso ele exista e
+ *  tenha sido construido sobre o estado atual do arquivo de dados
+ * @param nomeArquivoBin nome do arquivo binário dos registros
+ * @param header header do arquivo de dados
+ * @param mapa arquivo de dados mapeado
+ * @param campo nome do campo buscado
+ * @param valor valor buscado
+ * @return retorna 1 caso a busca tenha sido feita pelo indice e 0 caso o arquivo precise ser percorrido
+ */
+int SelectFromWhereHash_Veiculo(char nomeArquivoBin[100], veiculoHeader* header, arquivoMapeado* mapa, char* campo, char* valor) {
+    if (!campoEhString_Veiculo(campo)) return 0;
+
+    char nomeIndice[256];
+    nomeHashLinear(nomeIndice, nomeArquivoBin, campo);
+    // as operações que escrevem no arquivo removem o indice, o header ainda confere o arquivo de onde foi construido
+    hashLinear* indice = carregaHashLinear(nomeIndice, nomeArquivoBin);
+    if (indice == NULL) return 0;
+
+    int quantidade;
+    long int* byteOffsets = buscaHashLinear(indice, valor, (int)strlen(valor), &quantidade);
+    fechaHashLinear(indice);
+
+    // o indice guarda apenas o hash do valor, então cada candidato ainda é comparado
+    visaoVeiculo veiculoTemp;
+    int tamanho;
+    int existePeloMenosUm = 0;
+    for (int i = 0; i < quantidade; i++) {
+        lerVeiculo_Mapa(mapa, header->dicionario, &veiculoTemp, byteOffsets[i]);
+        if (veiculoTemp.removido != '1') continue;
+
+        char* valorCampo = lerCampoString_Veiculo(&veiculoTemp, campo, &tamanho);
+        if (!stringIgual(valor, valorCampo, tamanho)) continue;
+
+        imprimeVisaoVeiculo(&veiculoTemp, header, 1);
+        existePeloMenosUm = 1;
+        if (strcmp(campo, "prefixo") == 0) break;  // o prefixo é único
+    }
+
+    if (!existePeloMenosUm) printf("Registro inexistente.\n");
+
+    free(byteOffsets);
+    return 1;
+}
+
+/**
+ *  Cria um indice hash linear sobre um campo string dos veiculos, salvo ao lado do arquivo de dados
+ *  e usado automaticamente pelo SelectFromWhere desse campo
+ * @param nomeArquivoBin nome do arquivo binário dos registros
+ * @param campo nome do campo indexado
+ */
+void CreateIndexHash_Veiculo(char nomeArquivoBin[100], char* campo) {
+    FILE* arquivoBin;
+    if (!abrirArquivo(&arquivoBin, nomeArquivoBin, "rb", 1)) return;
+
+    veiculoHeader header;
+    visaoVeiculo veiculoTemp;
+    arquivoMapeado mapa;
+    int tamanho;
+
+    lerHeaderBin_Veiculo(arquivoBin, nomeArquivoBin, &header);
+    if (!validaHeader_veiculo(&arquivoBin, header, 1, 0)) return;
+
+    if (!campoEhString_Veiculo(campo)) {
+        printf("Falha no processamento do arquivo.");
+        fclose(arquivoBin);
+        liberaDicionario(header.dicionario);
+        return;
+    }
+
+    if (!mapeiaArquivo(&arquivoBin, &mapa, 1)) {
+        liberaDicionario(header.dicionario);
+        return;
+    }
+
+    char nomeIndice[256];
+    nomeHashLinear(nomeIndice, nomeArquivoBin, campo);
+    hashLinear* indice = criaHashLinear(nomeIndice);
+
+    if (indice == NULL) {
+        printf("Falha no processamento do arquivo.");
+        desmapeiaArquivo(&mapa);
+        fclose(arquivoBin);
+        liberaDicionario(header.dicionario);
+        return;
+    }
+
+    int isFinalDoArquivo = posicionaPrimeiroVeiculo(&mapa);
+
+    while (!isFinalDoArquivo) {
+        long int byteOffset = mapa.posicao;
+        isFinalDoArquivo = lerVeiculo_Mapa(&mapa, header.dicionario, &veiculoTemp, -1);
+        if (veiculoTemp.removido != '1') continue;
+
+        char* valor = lerCampoString_Veiculo(&veiculoTemp, campo, &tamanho);
+        insereHashLinear(indice, valor, tamanho, byteOffset);
+    }
+
+    desmapeiaArquivo(&mapa);
+    fclose(arquivoBin);
+    liberaDicionario(header.dicionario);
+    finalizaHashLinear(indice, nomeArquivoBin);
+    binarioNaTela(nomeIndice);
+}
+
+/**
+ * @param currV visão de um veiculo
+ * @param consulta condição da busca
+ * @return retorna 1 caso o veiculo não esteja removido e atenda a condição
+ */
+int atendeConsultaVeiculo(visaoVeiculo* currV, consultaVeiculo* consulta) {
+    if (currV->removido == '0') return 0;  // veiculo ja removido
+
+    switch (consulta->campo) {
+        case 0:
+            return stringIgual(consulta->valor, currV->prefixo, 5);
+        case 1:
+            return stringIgual(consulta->valor, currV->data, 10);
+        case 2:
+            return currV->quantidadeLugares == consulta->valorInteiro;
+        case 3:
+            return currV->codLinha == consulta->valorInteiro;
+        case 4:
+            if (consulta->codigo != -1 && currV->codigoModelo != -1) return currV->codigoModelo == consulta->codigo;
+            return stringIgual(consulta->valor, currV->modelo, currV->tamanhoModelo);
+        case 5:
+            if (consulta->codigo != -1 && currV->codigoCategoria != -1) return currV->codigoCategoria == consulta->codigo;
+            return stringIgual(consulta->valor, currV->categoria, currV->tamanhoCategoria);
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Avalia um veiculo durante a varredura paralela, chamada por várias threads ao mesmo tempo
+ * @param mapa cópia do mapeamento exclusiva da thread
+ * @param byteOffset inicio do registro
+ * @param argumento condição da busca (consultaVeiculo)
+ * @param saida saida do trecho onde o veiculo é impresso caso atenda a condição
+ * @return retorna 1 caso o veiculo tenha sido impresso e 0 caso contrário
+ */
+int avaliaConsultaVeiculo(arquivoMapeado* mapa, long int byteOffset, void* argumento, saidaTrecho* saida) {
+    consultaVeiculo* consulta = (consultaVeiculo*)argumento;
+    visaoVeiculo veiculoTemp;
+
+    lerVeiculo_Mapa(mapa, consulta->header->dicionario, &veiculoTemp, byteOffset);
+    if (!atendeConsultaVeiculo(&veiculoTemp, consulta)) return 0;
+
+    char* destino = reservaSaidaTrecho(saida, tamanhoSaidaVeiculo(&veiculoTemp));
+    confirmaSaidaTrecho(saida, formataVisaoVeiculo(destino, &veiculoTemp, consulta->header, 1));
+    return 1;
 }
 
 /**
@@ -326,10 +1003,10 @@ void SelectFromWhere_Veiculo(char nomeArquivoBin[100], char* campo, char* valor)
 
     veiculoHeader header;
 
-    lerHeaderBin_Veiculo(arquivoBin, &header);
+    lerHeaderBin_Veiculo(arquivoBin, nomeArquivoBin, &header);
     if (!validaHeader_veiculo(&arquivoBin, header, 1, 1)) return;
 
-    int headerPos;  // posição do campo no cabeçalho
+    int headerPos = -1;  // posição do campo no cabeçalho
     if (strcmp(campo, "prefixo") == 0)
         headerPos = 0;  // prefixo (string)
     else if (strcmp(campo, "data") == 0)
@@ -345,54 +1022,58 @@ void SelectFromWhere_Veiculo(char nomeArquivoBin[100], char* campo, char* valor)
 
     int total = header.nroRegistros + header.nroRegRemovidos;  // numero total de registros de dados
     int existePeloMenosUm = 0;
+    int valorInteiro = stringToInt(valor, (int)strlen(valor));
 
-    fseek(arquivoBin, 175, 0);  // posiciono para o primeiro registro de dados do binario
+    arquivoMapeado mapa;
+    if (!mapeiaArquivo(&arquivoBin, &mapa, 1)) {
+        liberaDicionario(header.dicionario);
+        return;
+    }
 
-    veiculo veiculoTemp;  // crio a cada iteração um veiculo atribuindo a ele os
-                          // valores lido em cada registro do binario
+    if (SelectFromWhereHash_Veiculo(nomeArquivoBin, &header, &mapa, campo, valor)) {
+        desmapeiaArquivo(&mapa);
+        fclose(arquivoBin);
+        liberaDicionario(header.dicionario);
+        return;
+    }
 
-    while (total--) {  // percorro todos registros de dados
-        lerVeiculo_Bin(arquivoBin, &veiculoTemp, -1);
-        int existe = 0;
-        if (veiculoTemp.removido == '0') continue;  // veiculo ja removido
+    // modelo e categoria codificados são comparados pelo código, sem olhar o texto de cada registro
+    int codigo = -1;
+    if (header.dicionario != NULL && (headerPos == 4 || headerPos == 5) && valor[0] != '\0') {
+        codigo = procuraDicionario(header.dicionario, headerPos - 4, valor, (int)strlen(valor));
+        if (codigo == -1) codigo = CODIGO_AUSENTE_DICIONARIO;
+    }
 
-        switch (headerPos) {
-            case 0:
-                if (strcmp(valor, veiculoTemp.prefixo) == 0) {
-                    imprimeVeiculo(veiculoTemp, header, 1);
-                    fclose(arquivoBin);
-                    return;
-                    //como o prefixo é unico pode interromper assim que encontrar o primeiro
-                }
-                break;
-            case 1:
-                if (strcmp(valor, veiculoTemp.data) == 0) existe = 1;
-                break;
-            case 2:
-                if (veiculoTemp.quantidadeLugares == stringToInt(valor, (int)strlen(valor))) existe = 1;
-                break;
-            case 3:
-                if (veiculoTemp.codLinha == stringToInt(valor, (int)strlen(valor))) existe = 1;
-                break;
-            case 4:
-                if (strcmp(valor, veiculoTemp.modelo) == 0) existe = 1;
-                break;
-            case 5:
-                if (strcmp(valor, veiculoTemp.categoria) == 0) existe = 1;
-                break;
-            default:
-                break;
-        }
+    consultaVeiculo consulta = {&header, headerPos, valor, valorInteiro, codigo};
+
+    if (header.formato == FORMATO_BLOCOS) {
+        // cada bloco tem o diretório dos seus registros, então o arquivo pode ser dividido entre threads
+        char* blocosPossiveis = blocosPossiveis_Veiculo(nomeArquivoBin, &mapa, &consulta);
+        existePeloMenosUm = varreBlocosParalelo(&mapa, TAMANHO_HEADER_VEICULO, avaliaConsultaVeiculo, &consulta,
+                                                headerPos == 0, blocosPossiveis);  //como o prefixo é unico basta o primeiro
+        free(blocosPossiveis);
+    } else {
+        posicionaPrimeiroVeiculo(&mapa);  // posiciono para o primeiro registro de dados do binario
+
+        visaoVeiculo veiculoTemp;  // a cada iteração a visão aponta para os
+                                   // valores de um registro do binario
 
-        if (existe) {  // dado encontrado
-            imprimeVeiculo(veiculoTemp, header, 1);
-            existePeloMenosUm = 1;
+        while (total--) {  // percorro todos registros de dados
+            lerVeiculo_Mapa(&mapa, header.dicionario, &veiculoTemp, -1);
+
+            if (atendeConsultaVeiculo(&veiculoTemp, &consulta)) {  // dado encontrado
+                imprimeVisaoVeiculo(&veiculoTemp, &header, 1);
+                existePeloMenosUm = 1;
+                if (headerPos == 0) break;  //como o prefixo é unico pode interromper assim que encontrar o primeiro
+            }
         }
     }
 
     if (!existePeloMenosUm) printf("Registro inexistente.\n");  // nenhum registro encontrado
 
+    desmapeiaArquivo(&mapa);
     fclose(arquivoBin);
+    liberaDicionario(header.dicionario);
 }
 
 /**
@@ -408,20 +1089,33 @@ void InsertInto_Veiculo(char nomeArquivoBin[100], int numeroDeEntradas) {
     veiculo novoVeiculo;
     veiculoHeader header;
 
-    lerHeaderBin_Veiculo(arquivoBin, &header);
+    lerHeaderBin_Veiculo(arquivoBin, nomeArquivoBin, &header);
     if (!validaHeader_veiculo(&arquivoBin, header, 1, 0)) return;
 
+    listaEspacoLivre* livres = carregaEspacoLivre_Veiculo(arquivoBin, nomeArquivoBin);
+    mapaZonas* zonas = carregaZonas_Veiculo(nomeArquivoBin, &header);
+
     header.status = '0';
     salvaHeader_Veiculo(arquivoBin, &header);
 
+    // os registros novos são acumulados e gravados em lotes no fim do arquivo
+    bufferEscrita buffer;
+    iniciaBufferEscritaFormato(&buffer, arquivoBin, header.formato, TAMANHO_HEADER_VEICULO, header.byteProxReg);
+
     while (numeroDeEntradas--) {
         lerVeiculo_Terminal(&novoVeiculo);
-        salvaVeiculo(arquivoBin, &novoVeiculo, &header);  // salvo o novo veículo no fim do binário
+        salvaVeiculoBuffer(&buffer, &novoVeiculo, &header, livres, zonas);  // salvo o novo veículo em um removido ou no fim do binário
     }
 
+    descarregaBufferEscrita(&buffer);
+
     header.status = '1';
     salvaHeader_Veiculo(arquivoBin, &header);
     fclose(arquivoBin);
+    finalizaEspacoLivre_Veiculo(livres, nomeArquivoBin);
+    removeIndicesHash_Veiculo(nomeArquivoBin);
+    finalizaZonas_Veiculo(zonas, nomeArquivoBin);
+    finalizaDicionario_Veiculo(&header, nomeArquivoBin);  // novos valores ganham códigos
     binarioNaTela(nomeArquivoBin);
 }
 
@@ -437,11 +1131,17 @@ void CreateIndex_Veiculo(char nomeArquivoBinRegistros[100], char nomeArquivoBinI
     veiculoHeader novoHeader;
     veiculo novoVeiculo;
 
-    lerHeaderBin_Veiculo(arquivoBinRegistros, &novoHeader);
+    lerHeaderBin_Veiculo(arquivoBinRegistros, nomeArquivoBinRegistros, &novoHeader);
     if (!validaHeader_veiculo(&arquivoBinRegistros, novoHeader, 1, 0)) return;
 
     arvore* novaArvore = criaArvore(nomeArquivoBinIndex);
 
+    if (novaArvore == NULL) {
+        fclose(arquivoBinRegistros);
+        liberaDicionario(novoHeader.dicionario);
+        return;
+    }
+
     alteraStatusArvore(novaArvore);
 
     int isFinalDoArquivo = finalDoArquivo(arquivoBinRegistros);
@@ -454,13 +1154,79 @@ void CreateIndex_Veiculo(char nomeArquivoBinRegistros[100], char nomeArquivoBinI
         novoRegistro.P_prox = -1;
         novoRegistro.Pr = ftell(arquivoBinRegistros);
 
-        isFinalDoArquivo = lerVeiculo_Bin(arquivoBinRegistros, &novoVeiculo, -1);
+        isFinalDoArquivo = lerVeiculo_Bin(arquivoBinRegistros, novoHeader.dicionario, &novoVeiculo, -1);
         novoRegistro.C = convertePrefixo(novoVeiculo.prefixo);
 
         if (novoVeiculo.removido == '1') insereRegistro(novaArvore, novoRegistro);
     }
 
     fclose(arquivoBinRegistros);
+    liberaDicionario(novoHeader.dicionario);
+    finalizaArvore(novaArvore);
+    binarioNaTela(nomeArquivoBinIndex);
+}
+
+/**
+ *  Cria um index no formato paginado construindo a arvore B de uma só vez, a partir de todos os registros ordenados
+ * @param nomeArquivoBinRegistros nome do arquivo binário dos registros
+ * @param nomeArquivoBinIndex nome do arquivo binário contendo os indices
+ * @param fatorPreenchimento fração de cada nó da arvore que será ocupada
+ */
+void CreateIndexEmLote_Veiculo(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100], double fatorPreenchimento) {
+    FILE* arquivoBinRegistros;
+    if (!abrirArquivo(&arquivoBinRegistros, nomeArquivoBinRegistros, "rb", 1)) return;
+
+    veiculoHeader novoHeader;
+    visaoVeiculo novoVeiculo;
+    arquivoMapeado mapa;
+
+    lerHeaderBin_Veiculo(arquivoBinRegistros, nomeArquivoBinRegistros, &novoHeader);
+    if (!validaHeader_veiculo(&arquivoBinRegistros, novoHeader, 1, 0)) return;
+    if (!mapeiaArquivo(&arquivoBinRegistros, &mapa, 1)) {
+        liberaDicionario(novoHeader.dicionario);
+        return;
+    }
+
+    int capacidade = novoHeader.nroRegistros + 1;
+    int quantidade = 0;
+    registro* registros = (registro*)malloc(capacidade * sizeof(registro));
+
+    int isFinalDoArquivo = posicionaPrimeiroVeiculo(&mapa);
+
+    //percorre todo o arquivo coletando a chave e o byteOffset dos registros salvos
+    while (!isFinalDoArquivo) {
+        long int byteOffset = mapa.posicao;
+        isFinalDoArquivo = lerVeiculo_Mapa(&mapa, novoHeader.dicionario, &novoVeiculo, -1);
+        if (novoVeiculo.removido != '1') continue;
+
+        if (quantidade == capacidade) {
+            capacidade *= 2;
+            registros = (registro*)realloc(registros, capacidade * sizeof(registro));
+        }
+
+        registros[quantidade].P_ant = -1;
+        registros[quantidade].P_prox = -1;
+        registros[quantidade].Pr = byteOffset;
+        registros[quantidade].C = convertePrefixo(novoVeiculo.prefixo);
+        quantidade++;
+    }
+
+    desmapeiaArquivo(&mapa);
+    fclose(arquivoBinRegistros);
+    liberaDicionario(novoHeader.dicionario);
+
+    arvore* novaArvore = criaArvorePaginada(nomeArquivoBinIndex);
+
+    if (novaArvore == NULL) {
+        free(registros);
+        return;
+    }
+
+    alteraStatusArvore(novaArvore);
+
+    constroiArvoreEmLote(novaArvore, registros, quantidade, fatorPreenchimento);
+
+    free(registros);
     finalizaArvore(novaArvore);
     binarioNaTela(nomeArquivoBinIndex);
 }
@@ -478,12 +1244,13 @@ void SelectFromWithIndex_Veiculo(char nomeArquivoBinRegistros[100], char nomeArq
     veiculoHeader novoHeader;
     veiculo novoVeiculo;
 
-    lerHeaderBin_Veiculo(arquivoBinRegistros, &novoHeader);
+    lerHeaderBin_Veiculo(arquivoBinRegistros, nomeArquivoBinRegistros, &novoHeader);
     if (!validaHeader_veiculo(&arquivoBinRegistros, novoHeader, 1, 1)) return;
 
     arvore* novaArvore = carregaArvore(nomeArquivoBinIndex);
     if (novaArvore == NULL) {
         fclose(arquivoBinRegistros);
+        liberaDicionario(novoHeader.dicionario);
         return;
     }
 
@@ -494,12 +1261,13 @@ void SelectFromWithIndex_Veiculo(char nomeArquivoBinRegistros[100], char nomeArq
 
     // testa se encontrou o registro
     if (byteOffset != -1) {
-        lerVeiculo_Bin(arquivoBinRegistros, &novoVeiculo, byteOffset);
+        lerVeiculo_Bin(arquivoBinRegistros, novoHeader.dicionario, &novoVeiculo, byteOffset);
         imprimeVeiculo(novoVeiculo, novoHeader, 1);
     } else {
         printf("Registro inexistente.");
     }
     fclose(arquivoBinRegistros);
+    liberaDicionario(novoHeader.dicionario);
     finalizaArvore(novaArvore);
 }
 
@@ -516,19 +1284,27 @@ void InsertIntoWithIndex_Veiculo(char nomeArquivoBinRegistros[100], char nomeArq
 
     veiculoHeader header;
 
-    lerHeaderBin_Veiculo(arquivoBinRegistros, &header);
+    lerHeaderBin_Veiculo(arquivoBinRegistros, nomeArquivoBinRegistros, &header);
     if (!validaHeader_veiculo(&arquivoBinRegistros, header, 1, 0)) return;
 
     arvore* novaArvore = carregaArvore(nomeArquivoBinIndex);
     if (novaArvore == NULL) {
         fclose(arquivoBinRegistros);
+        liberaDicionario(header.dicionario);
         return;
     }
 
+    listaEspacoLivre* livres = carregaEspacoLivre_Veiculo(arquivoBinRegistros, nomeArquivoBinRegistros);
+    mapaZonas* zonas = carregaZonas_Veiculo(nomeArquivoBinRegistros, &header);
+
     alteraStatusArvore(novaArvore);
     header.status = '0';
     salvaHeader_Veiculo(arquivoBinRegistros, &header);
 
+    // os registros novos são acumulados e gravados em lotes no fim do arquivo
+    bufferEscrita buffer;
+    iniciaBufferEscritaFormato(&buffer, arquivoBinRegistros, header.formato, TAMANHO_HEADER_VEICULO, header.byteProxReg);
+
     veiculo novoVeiculo;
 
     while (numeroDeEntradas--) {            // le n veículos
@@ -539,20 +1315,135 @@ void InsertIntoWithIndex_Veiculo(char nomeArquivoBinRegistros[100], char nomeArq
         novoRegistro.P_ant = -1;
         novoRegistro.P_prox = -1;
 
-        novoRegistro.Pr = header.byteProxReg;  // pega o byteoffset de onde o novo veiculo vai estar
-
-        salvaVeiculo(arquivoBinRegistros, &novoVeiculo, &header);  // salva o novo veículo no fim do arquivo de dados
+        novoRegistro.Pr = salvaVeiculoBuffer(&buffer, &novoVeiculo, &header, livres, zonas);  // salva e pega o byteoffset de onde o novo veiculo ficou
 
         novoRegistro.C = convertePrefixo(novoVeiculo.prefixo);
 
         if (novoVeiculo.removido == '1') insereRegistro(novaArvore, novoRegistro);  // insere o novo registro lido na árvore B
     }
+    descarregaBufferEscrita(&buffer);
+
     // procedimento padrão de fechamento dos arquivos
     header.status = '1';
     salvaHeader_Veiculo(arquivoBinRegistros, &header);
 
     fclose(arquivoBinRegistros);
+    finalizaEspacoLivre_Veiculo(livres, nomeArquivoBinRegistros);
+    removeIndicesHash_Veiculo(nomeArquivoBinRegistros);
+    finalizaZonas_Veiculo(zonas, nomeArquivoBinRegistros);
+    finalizaDicionario_Veiculo(&header, nomeArquivoBinRegistros);  // novos valores ganham códigos
+    finalizaArvore(novaArvore);
+    binarioNaTela(nomeArquivoBinIndex);
+}
+
+/**
+ *  Reescreve o arquivo de veiculos sem os registros removidos, copiando os demais em sequência,
+ *  e troca os byteOffsets da arvore B do prefixo pela tabela de byteOffsets antigos e novos
+ * @param nomeArquivoBin nome do arquivo binário dos registros
+ * @param nomeArquivoBinIndex nome do arquivo binário contendo os indices
+ */
+void Vacuum_Veiculo(char nomeArquivoBin[100], char nomeArquivoBinIndex[100]) {
+    FILE* arquivoBin;
+    if (!abrirArquivo(&arquivoBin, nomeArquivoBin, "rb", 1)) return;
+
+    veiculoHeader header;
+    visaoVeiculo veiculoTemp;
+    arquivoMapeado mapa;
+
+    lerHeaderBin_Veiculo(arquivoBin, nomeArquivoBin, &header);
+    if (!validaHeader_veiculo(&arquivoBin, header, 1, 0)) return;
+
+    arvore* novaArvore = carregaArvore(nomeArquivoBinIndex);
+
+    if (novaArvore == NULL) {
+        fclose(arquivoBin);
+        liberaDicionario(header.dicionario);
+        return;
+    }
+
+    char nomeArquivoCompactado[256];
+    sprintf(nomeArquivoCompactado, "%s.compactado", nomeArquivoBin);
+
+    FILE* arquivoCompactado;
+    if (!abrirArquivo(&arquivoCompactado, nomeArquivoCompactado, "wb", 1)) {
+        fclose(arquivoBin);
+        liberaDicionario(header.dicionario);
+        finalizaArvore(novaArvore);
+        return;
+    }
+
+    if (!mapeiaArquivo(&arquivoBin, &mapa, 1)) {
+        fclose(arquivoCompactado);
+        remove(nomeArquivoCompactado);
+        liberaDicionario(header.dicionario);
+        finalizaArvore(novaArvore);
+        return;
+    }
+
+    // os registros são copiados sem recodificação, então o dicionário do arquivo continua valendo
+    veiculoHeader novoHeader = header;
+    novoHeader.status = '0';
+    novoHeader.byteProxReg = 175;
+    novoHeader.nroRegistros = 0;
+    novoHeader.nroRegRemovidos = 0;
+    salvaHeader_Veiculo(arquivoCompactado, &novoHeader);
+
+    bufferEscrita buffer;
+    iniciaBufferEscritaFormato(&buffer, arquivoCompactado, novoHeader.formato, TAMANHO_HEADER_VEICULO, novoHeader.byteProxReg);
+
+    // os byteOffsets antigos ficam em ordem crescente, o que permite a busca binária no remapeamento
+    int capacidade = header.nroRegistros + 1;
+    int quantidade = 0;
+    long int* antigos = (long int*)malloc(capacidade * sizeof(long int));
+    long int* novos = (long int*)malloc(capacidade * sizeof(long int));
+
+    int isFinalDoArquivo = posicionaPrimeiroVeiculo(&mapa);
+
+    while (!isFinalDoArquivo) {
+        long int byteOffset = mapa.posicao;
+        isFinalDoArquivo = lerVeiculo_Mapa(&mapa, header.dicionario, &veiculoTemp, -1);
+        if (veiculoTemp.removido != '1') continue;
+
+        if (quantidade == capacidade) {
+            capacidade *= 2;
+            antigos = (long int*)realloc(antigos, capacidade * sizeof(long int));
+            novos = (long int*)realloc(novos, capacidade * sizeof(long int));
+        }
+        // a sobra de um registro salvo no espaço de um removido maior também é descartada
+        int tamanho = 5 + veiculoTemp.tamanhoRegistro;
+        char* destino = reservaBufferEscrita(&buffer, tamanho);
+        memcpy(destino, mapa.dados + byteOffset, tamanho);
+        memcpy(destino + 1, &veiculoTemp.tamanhoRegistro, sizeof(int));
+
+        antigos[quantidade] = byteOffset;
+        novos[quantidade] = posicaoLivreBufferEscrita(&buffer);
+        quantidade++;
+
+        confirmaBufferEscrita(&buffer, tamanho);
+        novoHeader.byteProxReg = posicaoLivreBufferEscrita(&buffer);
+        novoHeader.nroRegistros++;
+    }
+
+    descarregaBufferEscrita(&buffer);
+    desmapeiaArquivo(&mapa);
+    fclose(arquivoBin);
+    liberaDicionario(header.dicionario);
+
+    novoHeader.status = '1';
+    salvaHeader_Veiculo(arquivoCompactado, &novoHeader);
+    fclose(arquivoCompactado);
+
+    // o indice fica inconsistente até ser remapeado
+    alteraStatusArvore(novaArvore);
+    rename(nomeArquivoCompactado, nomeArquivoBin);
+    removeIndicesHash_Veiculo(nomeArquivoBin);
+    remapeiaByteOffsets(novaArvore, antigos, novos, quantidade);
     finalizaArvore(novaArvore);
+
+    free(antigos);
+    free(novos);
+
+    binarioNaTela(nomeArquivoBin);
     binarioNaTela(nomeArquivoBinIndex);
 }
 
@@ -560,6 +1451,7 @@ void InsertIntoWithIndex_Veiculo(char nomeArquivoBinRegistros[100], char nomeArq
  * Cria um arquivo binário com os registros ordenados a partir de um binário desordenado
  * @param nomeArquivoBinDesordenado nome do arquivo bin fonte dos dados
  * @param nomeArquivoBIn nome do arquivo binário onde os dados serão salvos ordenadamente
+ * @return retorna 1 caso consiga ordenar e 0 caso contrário
  */
 int SortReg_Veiculo(char nomeArquivoBinDesordenado[100], char nomeArquivoBin[100]) {
     FILE* arquivoBinOrdenado;
@@ -569,13 +1461,18 @@ int SortReg_Veiculo(char nomeArquivoBinDesordenado[100], char nomeArquivoBin[100
 
     veiculoHeader header;
 
-    lerHeaderBin_Veiculo(arquivoBinDesordenado, &header);
+    lerHeaderBin_Veiculo(arquivoBinDesordenado, nomeArquivoBinDesordenado, &header);
     if (!validaHeader_veiculo(&arquivoBinDesordenado, header, 1, 0)) return 0;
 
-    abrirArquivo(&arquivoBinOrdenado, nomeArquivoBin, "wb", 0);
+    if (!abrirArquivo(&arquivoBinOrdenado, nomeArquivoBin, "wb", 1)) {
+        fclose(arquivoBinDesordenado);
+        liberaDicionario(header.dicionario);
+        return 0;
+    }
 
     veiculoHeader novoHeader = header;
     veiculo novoVeiculo;
+    char registroCodificado[sizeof(veiculo)];
 
     //definindo valores iniciais do header
     novoHeader.status = '0';
@@ -587,20 +1484,55 @@ int SortReg_Veiculo(char nomeArquivoBinDesordenado[100], char nomeArquivoBin[100
 
     int isFinalDoArquivo = finalDoArquivo(arquivoBinDesordenado);
 
-    //aloca array para salvar os dados
-    veiculo* arrayDeVeiculos = malloc(header.nroRegistros * sizeof(veiculo));
-    int posAtual = 0;
+    // caso os registros não caibam na memória configurada eles são ordenados em corridas no disco
+    // cada registro ocupa na memória só os seus bytes no formato do arquivo, e não a struct inteira
+    long int memoria = lerConfiguracao("MEMORIA_ORDENACAO", MEMORIA_ORDENACAO);
+    ordenadorRegistros* ordenadorVeiculos = criaOrdenadorRegistros(memoria);
 
+    iniciaFase("leitura");
     //percorre o arquivo até o final
     while (!isFinalDoArquivo) {
-        isFinalDoArquivo = lerVeiculo_Bin(arquivoBinDesordenado, &novoVeiculo, -1);
-        if (novoVeiculo.removido == '1') arrayDeVeiculos[posAtual++] = novoVeiculo;
+        isFinalDoArquivo = lerVeiculo_Bin(arquivoBinDesordenado, header.dicionario, &novoVeiculo, -1);
+        if (novoVeiculo.removido == '1') {
+            int tamanhoCodificado = codificaVeiculo(registroCodificado, header.dicionario, &novoVeiculo);
+            adicionaRegistro(ordenadorVeiculos, novoVeiculo.codLinha, registroCodificado, tamanhoCodificado);
+        }
     }
+    encerraFase();
+
+    iniciaFase("ordenacao");
+    ordenaRegistros(ordenadorVeiculos);
+    encerraFase();
+
+    iniciaFase("escrita");
+    // os registros já estão no formato do arquivo e são só copiados
+    bufferEscrita buffer;
+    iniciaBufferEscritaFormato(&buffer, arquivoBinOrdenado, novoHeader.formato, TAMANHO_HEADER_VEICULO, novoHeader.byteProxReg);
+    char* registroOrdenado;
+    int tamanho;
+    while (proximoRegistro(ordenadorVeiculos, &registroOrdenado, &tamanho)) {
+        char* destino = reservaBufferEscrita(&buffer, tamanho);
+        memcpy(destino, registroOrdenado, tamanho);
+        confirmaBufferEscrita(&buffer, tamanho);
+
+        novoHeader.byteProxReg = posicaoLivreBufferEscrita(&buffer);
+        novoHeader.nroRegistros++;
+    }
+    descarregaBufferEscrita(&buffer);
+    encerraFase();
 
-    qsort(arrayDeVeiculos, header.nroRegistros, sizeof(veiculo), compararVeiculos);
-
-    for (int i = 0; i < header.nroRegistros; i++) {
-        salvaVeiculo(arquivoBinOrdenado, &arrayDeVeiculos[i], &novoHeader);
+    // uma corrida que não pôde ser criada, gravada ou lida, ou uma escrita que falhou, como com o disco cheio,
+    // deixa o arquivo ordenado incompleto, com status '0'
+    if (ordenadorVeiculos->falha || fflush(arquivoBinOrdenado) != 0 || ferror(arquivoBinOrdenado)) {
+        printf("Falha no processamento do arquivo.");
+        fclose(arquivoBinOrdenado);
+        fclose(arquivoBinDesordenado);
+        removeListaEspacoLivre(nomeArquivoBin);
+        removeIndicesHash_Veiculo(nomeArquivoBin);
+        removeDicionario(nomeArquivoBin);
+        liberaDicionario(header.dicionario);
+        finalizaOrdenadorRegistros(ordenadorVeiculos);
+        return 0;
     }
 
     novoHeader.status = '1';
@@ -610,7 +1542,14 @@ int SortReg_Veiculo(char nomeArquivoBinDesordenado[100], char nomeArquivoBin[100
     //fecha todos arquivos abertos e libera memória
     fclose(arquivoBinOrdenado);
     fclose(arquivoBinDesordenado);
-    free(arrayDeVeiculos);
+    removeListaEspacoLivre(nomeArquivoBin);
+    removeIndicesHash_Veiculo(nomeArquivoBin);
+    if (header.dicionario != NULL)
+        salvaDicionario(header.dicionario, nomeArquivoBin);  // o arquivo ordenado usa os códigos do desordenado
+    else
+        removeDicionario(nomeArquivoBin);
+    liberaDicionario(header.dicionario);
+    finalizaOrdenadorRegistros(ordenadorVeiculos);
 
     return 1;
 }
@@ -627,51 +1566,74 @@ void SelectFromWhereNestedLoop(char nomeArquivoBinVeiculo[100], char nomeArquivo
     if (!abrirArquivo(&arquivoBin_Veiculo, nomeArquivoBinVeiculo, "rb", 1)) return;
 
     veiculoHeader novoHeader_Veiculo;
-    veiculo novoVeiculo;
+    visaoVeiculo novoVeiculo;
 
-    lerHeaderBin_Veiculo(arquivoBin_Veiculo, &novoHeader_Veiculo);
+    lerHeaderBin_Veiculo(arquivoBin_Veiculo, nomeArquivoBinVeiculo, &novoHeader_Veiculo);
     if (!validaHeader_veiculo(&arquivoBin_Veiculo, novoHeader_Veiculo, 1, 1)) return;
 
     // abre e valida os arquivos da linha
 
     FILE* arquivoBin_Linha;
-    if (!abrirArquivo(&arquivoBin_Linha, nomeArquivoBinLinha, "rb", 1)) return;
+    if (!abrirArquivo(&arquivoBin_Linha, nomeArquivoBinLinha, "rb", 1)) {
+        fclose(arquivoBin_Veiculo);
+        liberaDicionario(novoHeader_Veiculo.dicionario);
+        return;
+    }
 
     linhaHeader novoHeader_Linha;
-    linha novaLinha;
+    visaoLinha novaLinha;
 
-    lerHeaderBin_Linha(arquivoBin_Linha, &novoHeader_Linha);
-    if (!validaHeader_linha(&arquivoBin_Linha, novoHeader_Linha, 1, 1)) return;
+    lerHeaderBin_Linha(arquivoBin_Linha, nomeArquivoBinLinha, &novoHeader_Linha);
+    if (!validaHeader_linha(&arquivoBin_Linha, novoHeader_Linha, 1, 1)) {
+        fclose(arquivoBin_Veiculo);
+        liberaDicionario(novoHeader_Veiculo.dicionario);
+        return;
+    }
 
 
-    int isFinalDoArquivoVeiculo = finalDoArquivo(arquivoBin_Veiculo);
+    arquivoMapeado mapaVeiculo;
+    arquivoMapeado mapaLinha;
+
+    if (!mapeiaArquivo(&arquivoBin_Veiculo, &mapaVeiculo, 1)) {
+        fclose(arquivoBin_Linha);
+        liberaDicionario(novoHeader_Veiculo.dicionario);
+        liberaDicionario(novoHeader_Linha.dicionario);
+        return;
+    }
+    if (!mapeiaArquivo(&arquivoBin_Linha, &mapaLinha, 0)) {
+        desmapeiaArquivo(&mapaVeiculo);
+        fclose(arquivoBin_Veiculo);
+        liberaDicionario(novoHeader_Veiculo.dicionario);
+        liberaDicionario(novoHeader_Linha.dicionario);
+        return;
+    }
+
+    int isFinalDoArquivoVeiculo = posicionaPrimeiroVeiculo(&mapaVeiculo);
 
     int existe = 0;
 
     //percorre todo o arquivo de registro de veiculos
     while (!isFinalDoArquivoVeiculo) {
-        isFinalDoArquivoVeiculo = lerVeiculo_Bin(arquivoBin_Veiculo, &novoVeiculo, -1);
+        isFinalDoArquivoVeiculo = lerVeiculo_Mapa(&mapaVeiculo, novoHeader_Veiculo.dicionario, &novoVeiculo, -1);
 
         // para cada veiculo n removido, percorre todo o arquivo de registro da linha
         if (novoVeiculo.removido == '1'){
-            int isFinalDoArquivoLinha = finalDoArquivo(arquivoBin_Linha);
+            // posiciona no primeiro registro de dados da linha
+            int isFinalDoArquivoLinha = posicionaPrimeiraLinha(&mapaLinha);
 
             while(!isFinalDoArquivoLinha){
-                isFinalDoArquivoLinha = lerLinha_Bin(arquivoBin_Linha, &novaLinha, -1);
+                isFinalDoArquivoLinha = lerLinha_Mapa(&mapaLinha, novoHeader_Linha.dicionario, &novaLinha, -1);
 
                 // compara se o veiculo atual e a linha atual tem match no campo codLinha
                 if (novaLinha.removido == '1' && novoVeiculo.codLinha == novaLinha.codLinha){
                     // printa o registro no formato solicitado
-                    imprimeVeiculo(novoVeiculo, novoHeader_Veiculo, 0);
-                    imprimeLinha(novaLinha, novoHeader_Linha, 1);
+                    imprimeVisaoVeiculo(&novoVeiculo, &novoHeader_Veiculo, 0);
+                    imprimeVisaoLinha(&novaLinha, &novoHeader_Linha, 1);
 
                     existe = 1;
                     break;
                 }
             }
-            
-            // reposiciona o ponteiro do arquivo de dados da linha para o primeiro registro de dados
-            fseek(arquivoBin_Linha, 82, 0); 
         }
     }
     // caso a junção for vazia (nenhum registro deu match)
@@ -679,8 +1641,12 @@ void SelectFromWhereNestedLoop(char nomeArquivoBinVeiculo[100], char nomeArquivo
         printf("Registro inexistente.");
     }
 
+    desmapeiaArquivo(&mapaVeiculo);
+    desmapeiaArquivo(&mapaLinha);
     fclose(arquivoBin_Veiculo);
     fclose(arquivoBin_Linha);
+    liberaDicionario(novoHeader_Veiculo.dicionario);
+    liberaDicionario(novoHeader_Linha.dicionario);
 }
 
 /**
@@ -696,59 +1662,393 @@ void SelectFromWhereUniqueLoop(char nomeArquivoBinVeiculo[100], char nomeArquivo
     if (!abrirArquivo(&arquivoBin_Veiculo, nomeArquivoBinVeiculo, "rb", 1)) return;
 
     veiculoHeader novoHeader_Veiculo;
-    veiculo novoVeiculo;
 
-    lerHeaderBin_Veiculo(arquivoBin_Veiculo, &novoHeader_Veiculo);
+    lerHeaderBin_Veiculo(arquivoBin_Veiculo, nomeArquivoBinVeiculo, &novoHeader_Veiculo);
     if (!validaHeader_veiculo(&arquivoBin_Veiculo, novoHeader_Veiculo, 1, 1)) return;
 
     // abre e valida os arquivos da linha
 
     FILE* arquivoBin_Linha;
-    if (!abrirArquivo(&arquivoBin_Linha, nomeArquivoBinLinha, "rb", 1)) return;
+    if (!abrirArquivo(&arquivoBin_Linha, nomeArquivoBinLinha, "rb", 1)) {
+        fclose(arquivoBin_Veiculo);
+        liberaDicionario(novoHeader_Veiculo.dicionario);
+        return;
+    }
 
     linhaHeader novoHeader_Linha;
-    linha novaLinha;
+    visaoLinha novaLinha;
 
-    lerHeaderBin_Linha(arquivoBin_Linha, &novoHeader_Linha);
-    if (!validaHeader_linha(&arquivoBin_Linha, novoHeader_Linha, 1, 1)) return;
+    lerHeaderBin_Linha(arquivoBin_Linha, nomeArquivoBinLinha, &novoHeader_Linha);
+    if (!validaHeader_linha(&arquivoBin_Linha, novoHeader_Linha, 1, 1)) {
+        fclose(arquivoBin_Veiculo);
+        liberaDicionario(novoHeader_Veiculo.dicionario);
+        return;
+    }
 
     // abre e valida os arquivos da arvore B da linha
 
     arvore* novaArvore = carregaArvore(nomeArquivoBinIndex);
     if (novaArvore == NULL) {
         fclose(arquivoBin_Veiculo);
+        fclose(arquivoBin_Linha);
+        liberaDicionario(novoHeader_Veiculo.dicionario);
+        liberaDicionario(novoHeader_Linha.dicionario);
+        return;
+    }
+
+    arquivoMapeado mapaVeiculo;
+    arquivoMapeado mapaLinha;
+
+    if (!mapeiaArquivo(&arquivoBin_Veiculo, &mapaVeiculo, 1)) {
+        fclose(arquivoBin_Linha);
+        liberaDicionario(novoHeader_Veiculo.dicionario);
+        liberaDicionario(novoHeader_Linha.dicionario);
+        finalizaArvore(novaArvore);
+        return;
+    }
+    if (!mapeiaArquivo(&arquivoBin_Linha, &mapaLinha, 0)) {
+        desmapeiaArquivo(&mapaVeiculo);
+        fclose(arquivoBin_Veiculo);
+        liberaDicionario(novoHeader_Veiculo.dicionario);
+        liberaDicionario(novoHeader_Linha.dicionario);
+        finalizaArvore(novaArvore);
         return;
     }
 
-    int isFinalDoArquivoVeiculo = finalDoArquivo(arquivoBin_Veiculo);
+    // os veiculos são lidos em lotes e os codLinha de cada lote são buscados de uma vez na arvore
+    visaoVeiculo* lote = (visaoVeiculo*)malloc(TAMANHO_LOTE_BUSCA * sizeof(visaoVeiculo));
+    int* chaves = (int*)malloc(TAMANHO_LOTE_BUSCA * sizeof(int));
+    long int* byteOffsets = (long int*)malloc(TAMANHO_LOTE_BUSCA * sizeof(long int));
+
+    int isFinalDoArquivoVeiculo = posicionaPrimeiroVeiculo(&mapaVeiculo);
 
     int existe = 0;
 
     //percorre todo o arquivo de registro de veiculos
     while (!isFinalDoArquivoVeiculo) {
-        isFinalDoArquivoVeiculo = lerVeiculo_Bin(arquivoBin_Veiculo, &novoVeiculo, -1);
+        int tamanhoLote = 0;
 
-        if (novoVeiculo.removido == '1'){
-            // procura o codLinha do veiculo nos indices da linha
-            long int byteOffset = buscaRegistro(novaArvore, novoVeiculo.codLinha);
+        while (!isFinalDoArquivoVeiculo && tamanhoLote < TAMANHO_LOTE_BUSCA) {
+            isFinalDoArquivoVeiculo = lerVeiculo_Mapa(&mapaVeiculo, novoHeader_Veiculo.dicionario, &lote[tamanhoLote], -1);
+            if (lote[tamanhoLote].removido == '1') {
+                chaves[tamanhoLote] = lote[tamanhoLote].codLinha;
+                tamanhoLote++;
+            }
+        }
+
+        // procura os codLinha dos veiculos nos indices da linha
+        buscaRegistrosEmLote(novaArvore, chaves, byteOffsets, tamanhoLote);
 
+        for (int i = 0; i < tamanhoLote; i++) {
             // testa se encontrou o registro
-            if (byteOffset != -1) {
-                lerLinha_Bin(arquivoBin_Linha, &novaLinha, byteOffset);
-                
+            if (byteOffsets[i] != -1) {
+                lerLinha_Mapa(&mapaLinha, novoHeader_Linha.dicionario, &novaLinha, byteOffsets[i]);
+
                 // printa o registro no formato solicitado
-                imprimeVeiculo(novoVeiculo, novoHeader_Veiculo, 0);
-                imprimeLinha(novaLinha, novoHeader_Linha, 1);
+                imprimeVisaoVeiculo(&lote[i], &novoHeader_Veiculo, 0);
+                imprimeVisaoLinha(&novaLinha, &novoHeader_Linha, 1);
 
                 existe = 1;
             }
         }
     }
+
+    free(lote);
+    free(chaves);
+    free(byteOffsets);
+
     // caso a junção for vazia (nenhum registro deu match)
     if(!existe){
         printf("Registro inexistente.");
     }
 
+    desmapeiaArquivo(&mapaVeiculo);
+    desmapeiaArquivo(&mapaLinha);
+    fclose(arquivoBin_Veiculo);
+    fclose(arquivoBin_Linha);
+    liberaDicionario(novoHeader_Veiculo.dicionario);
+    liberaDicionario(novoHeader_Linha.dicionario);
+    finalizaArvore(novaArvore);
+}
+
+/**
+ * Compara dois pares da junção pela ordem do veiculo no arquivo
+ * @param parA primeiro par
+ * @param parB segundo par
+ * @return retorna um valor negativo, zero ou positivo caso A venha antes, junto ou depois de B
+ */
+int compararParesJuncao(const void* parA, const void* parB) {
+    long int a = (*(parJuncao*)parA).sequencia;
+    long int b = (*(parJuncao*)parB).sequencia;
+    return (a > b) - (a < b);
+}
+
+/**
+ * Lê um par da junção de uma corrida temporária da ordenação
+ * @param arquivo corrida de onde o par será lido
+ * @param elemento par onde os dados serão salvos
+ * @return retorna 1 caso tenha lido um par e 0 caso a corrida tenha acabado
+ */
+int lerParJuncao(FILE* arquivo, void* elemento) {
+    return fread(elemento, sizeof(parJuncao), 1, arquivo) == 1;
+}
+
+/**
+ * Salva um par da junção em uma corrida temporária da ordenação
+ * @param arquivo corrida onde o par será salvo
+ * @param elemento par a ser salvo
+ */
+void salvaParJuncao(FILE* arquivo, void* elemento) {
+    fwrite(elemento, sizeof(parJuncao), 1, arquivo);
+}
+
+/**
+ * Junção por hash com a tabela das linhas inteira em memória
+ * a tabela guarda o byteOffset da primeira linha não removida de cada codLinha, assim como o loop aninhado encontraria
+ * @param mapaVeiculo arquivo mapeado dos veiculos
+ * @param headerVeiculo header do arquivo dos veiculos
+ * @param mapaLinha arquivo mapeado das linhas
+ * @param headerLinha header do arquivo das linhas
+ * @return retorna 1 caso algum par tenha sido encontrado e 0 caso contrário
+ */
+int juncaoHashEmMemoria(arquivoMapeado* mapaVeiculo, veiculoHeader* headerVeiculo, arquivoMapeado* mapaLinha, linhaHeader* headerLinha) {
+    tabelaHash* tabela = criaTabelaHash(headerLinha->nroRegistros);
+    visaoVeiculo novoVeiculo;
+    visaoLinha novaLinha;
+    int existe = 0;
+
+    // constroi a tabela com as linhas
+    int isFinalDoArquivo = posicionaPrimeiraLinha(mapaLinha);
+    while (!isFinalDoArquivo) {
+        long int byteOffset = mapaLinha->posicao;
+        isFinalDoArquivo = lerLinha_Mapa(mapaLinha, headerLinha->dicionario, &novaLinha, -1);
+        if (novaLinha.removido == '1') insereTabelaHash(tabela, novaLinha.codLinha, byteOffset);
+    }
+
+    // percorre os veiculos uma única vez procurando a linha de cada um na tabela
+    isFinalDoArquivo = posicionaPrimeiroVeiculo(mapaVeiculo);
+    while (!isFinalDoArquivo) {
+        isFinalDoArquivo = lerVeiculo_Mapa(mapaVeiculo, headerVeiculo->dicionario, &novoVeiculo, -1);
+        if (novoVeiculo.removido != '1') continue;
+
+        long int byteOffset = buscaTabelaHash(tabela, novoVeiculo.codLinha);
+        if (byteOffset != -1) {
+            lerLinha_Mapa(mapaLinha, headerLinha->dicionario, &novaLinha, byteOffset);
+
+            imprimeVisaoVeiculo(&novoVeiculo, headerVeiculo, 0);
+            imprimeVisaoLinha(&novaLinha, headerLinha, 1);
+            existe = 1;
+        }
+    }
+
+    liberaTabelaHash(tabela);
+    return existe;
+}
+
+/**
+ * Junção por hash particionada (grace hash) para quando a tabela das linhas não cabe na memória
+ * os dois arquivos são divididos em partições pelo hash do codLinha, cada partição é unida
+ * separadamente e os pares encontrados são reordenados pela ordem dos veiculos antes da impressão
+ * @param mapaVeiculo arquivo mapeado dos veiculos
+ * @param headerVeiculo header do arquivo dos veiculos
+ * @param mapaLinha arquivo mapeado das linhas
+ * @param headerLinha header do arquivo das linhas
+ * @param nroParticoes quantidade de partições, ver limitaParticoesJuncao
+ * @param memoria memória disponivel para a ordenação dos pares
+ * @return retorna 1 caso algum par tenha sido encontrado, 0 caso contrário e -1 caso as partições ou a ordenação dos
+ * pares falhem
+ */
+int juncaoHashParticionada(arquivoMapeado* mapaVeiculo, veiculoHeader* headerVeiculo, arquivoMapeado* mapaLinha, linhaHeader* headerLinha,
+                           int nroParticoes, long int memoria) {
+    FILE** particoesLinha = (FILE**)malloc(nroParticoes * sizeof(FILE*));
+    FILE** particoesVeiculo = (FILE**)malloc(nroParticoes * sizeof(FILE*));
+    for (int p = 0; p < nroParticoes; p++) {
+        particoesLinha[p] = tmpfile();
+        particoesVeiculo[p] = tmpfile();
+
+        if (particoesLinha[p] == NULL || particoesVeiculo[p] == NULL) {
+            printf("Falha no processamento do arquivo.");
+            for (int q = 0; q <= p; q++) {
+                if (particoesLinha[q] != NULL) fclose(particoesLinha[q]);
+                if (particoesVeiculo[q] != NULL) fclose(particoesVeiculo[q]);
+            }
+            free(particoesLinha);
+            free(particoesVeiculo);
+            return -1;
+        }
+    }
+
+    visaoVeiculo novoVeiculo;
+    visaoLinha novaLinha;
+    entradaParticao entrada;
+
+    // particiona as linhas
+    entrada.sequencia = 0;
+    int isFinalDoArquivo = posicionaPrimeiraLinha(mapaLinha);
+    while (!isFinalDoArquivo) {
+        entrada.byteOffset = mapaLinha->posicao;
+        isFinalDoArquivo = lerLinha_Mapa(mapaLinha, headerLinha->dicionario, &novaLinha, -1);
+        if (novaLinha.removido != '1') continue;
+
+        entrada.chave = novaLinha.codLinha;
+        fwrite(&entrada, sizeof(entradaParticao), 1, particoesLinha[espalhaChave(entrada.chave) % nroParticoes]);
+    }
+
+    // particiona os veiculos guardando sua ordem no arquivo
+    isFinalDoArquivo = posicionaPrimeiroVeiculo(mapaVeiculo);
+    while (!isFinalDoArquivo) {
+        entrada.byteOffset = mapaVeiculo->posicao;
+        isFinalDoArquivo = lerVeiculo_Mapa(mapaVeiculo, headerVeiculo->dicionario, &novoVeiculo, -1);
+        if (novoVeiculo.removido != '1') continue;
+
+        entrada.chave = novoVeiculo.codLinha;
+        fwrite(&entrada, sizeof(entradaParticao), 1, particoesVeiculo[espalhaChave(entrada.chave) % nroParticoes]);
+        entrada.sequencia++;
+    }
+
+    // une cada partição, as linhas de uma partição sempre cabem na memória
+    ordenador* ordenadorPares = criaOrdenador(sizeof(parJuncao), memoria, compararParesJuncao, lerParJuncao, salvaParJuncao);
+    parJuncao par;
+
+    for (int p = 0; p < nroParticoes; p++) {
+        tabelaHash* tabela = criaTabelaHash(0);
+
+        rewind(particoesLinha[p]);
+        while (fread(&entrada, sizeof(entradaParticao), 1, particoesLinha[p]) == 1) {
+            insereTabelaHash(tabela, entrada.chave, entrada.byteOffset);
+        }
+
+        rewind(particoesVeiculo[p]);
+        while (fread(&entrada, sizeof(entradaParticao), 1, particoesVeiculo[p]) == 1) {
+            par.byteOffsetLinha = buscaTabelaHash(tabela, entrada.chave);
+            if (par.byteOffsetLinha == -1) continue;
+
+            par.sequencia = entrada.sequencia;
+            par.byteOffsetVeiculo = entrada.byteOffset;
+            adicionaElemento(ordenadorPares, &par);
+        }
+
+        liberaTabelaHash(tabela);
+        fclose(particoesLinha[p]);
+        fclose(particoesVeiculo[p]);
+    }
+
+    // imprime os pares na mesma ordem em que os veiculos aparecem no arquivo
+    int existe = 0;
+    if (ordenaElementos(ordenadorPares)) {
+        while (proximoElemento(ordenadorPares, &par)) {
+            lerVeiculo_Mapa(mapaVeiculo, headerVeiculo->dicionario, &novoVeiculo, par.byteOffsetVeiculo);
+            lerLinha_Mapa(mapaLinha, headerLinha->dicionario, &novaLinha, par.byteOffsetLinha);
+
+            imprimeVisaoVeiculo(&novoVeiculo, headerVeiculo, 0);
+            imprimeVisaoLinha(&novaLinha, headerLinha, 1);
+            existe = 1;
+        }
+    }
+
+    // as corridas da ordenação dos pares não puderam ser criadas, gravadas ou lidas
+    if (ordenadorPares->falha) {
+        printf("Falha no processamento do arquivo.");
+        existe = -1;
+    }
+
+    finalizaOrdenador(ordenadorPares);
+    free(particoesLinha);
+    free(particoesVeiculo);
+    return existe;
+}
+
+/**
+ * Limita a quantidade de partições da junção para que os arquivos temporários, dois por partição,
+ * fiquem bem abaixo do limite de arquivos abertos do processo. Com o limite as partições podem passar da
+ * memória configurada, o que só faz a tabela de cada partição crescer
+ * @param nroParticoes quantidade de partições para que cada uma caiba na memória
+ * @return quantidade de partições que será usada
+ */
+int limitaParticoesJuncao(int nroParticoes) {
+    int maximo = MAXIMO_PARTICOES_JUNCAO;
+
+    struct rlimit limite;
+    if (getrlimit(RLIMIT_NOFILE, &limite) == 0 && limite.rlim_cur != RLIM_INFINITY && (long int)limite.rlim_cur / 4 < maximo)
+        maximo = (int)(limite.rlim_cur / 4);
+    if (maximo < 1) maximo = 1;
+
+    return nroParticoes < maximo ? nroParticoes : maximo;
+}
+
+/**
+ *  Faz a junção dos arquivos de dados dos veiculos com os de linha usando uma tabela hash sobre o codLinha,
+ *  a saída é a mesma do loop aninhado mas cada arquivo é percorrido uma única vez
+ * @param nomeArquivoBinVeiculo nome do arquivo binário dos registros do veiculo
+ * @param nomeArquivoBinLinha nome do arquivo binário dos registros da linha
+ */
+void SelectFromWhereHashJoin(char nomeArquivoBinVeiculo[100], char nomeArquivoBinLinha[100]) {
+    // abre e valida os arquivos do veiculo
+
+    FILE* arquivoBin_Veiculo;
+    if (!abrirArquivo(&arquivoBin_Veiculo, nomeArquivoBinVeiculo, "rb", 1)) return;
+
+    veiculoHeader novoHeader_Veiculo;
+
+    lerHeaderBin_Veiculo(arquivoBin_Veiculo, nomeArquivoBinVeiculo, &novoHeader_Veiculo);
+    if (!validaHeader_veiculo(&arquivoBin_Veiculo, novoHeader_Veiculo, 1, 1)) return;
+
+    // abre e valida os arquivos da linha
+
+    FILE* arquivoBin_Linha;
+    if (!abrirArquivo(&arquivoBin_Linha, nomeArquivoBinLinha, "rb", 1)) {
+        fclose(arquivoBin_Veiculo);
+        liberaDicionario(novoHeader_Veiculo.dicionario);
+        return;
+    }
+
+    linhaHeader novoHeader_Linha;
+
+    lerHeaderBin_Linha(arquivoBin_Linha, nomeArquivoBinLinha, &novoHeader_Linha);
+    if (!validaHeader_linha(&arquivoBin_Linha, novoHeader_Linha, 1, 1)) {
+        fclose(arquivoBin_Veiculo);
+        liberaDicionario(novoHeader_Veiculo.dicionario);
+        return;
+    }
+
+    arquivoMapeado mapaVeiculo;
+    arquivoMapeado mapaLinha;
+
+    if (!mapeiaArquivo(&arquivoBin_Veiculo, &mapaVeiculo, 1)) {
+        fclose(arquivoBin_Linha);
+        liberaDicionario(novoHeader_Veiculo.dicionario);
+        liberaDicionario(novoHeader_Linha.dicionario);
+        return;
+    }
+    if (!mapeiaArquivo(&arquivoBin_Linha, &mapaLinha, 0)) {
+        desmapeiaArquivo(&mapaVeiculo);
+        fclose(arquivoBin_Veiculo);
+        liberaDicionario(novoHeader_Veiculo.dicionario);
+        liberaDicionario(novoHeader_Linha.dicionario);
+        return;
+    }
+
+    // estimativa da memória da tabela, que é mantida no máximo com metade das posições ocupadas
+    long int memoria = lerConfiguracao("MEMORIA_JUNCAO", MEMORIA_JUNCAO_HASH);
+    long int memoriaNecessaria = (long int)novoHeader_Linha.nroRegistros * 2 * (sizeof(int) + sizeof(long int) + sizeof(char));
+
+    int existe;
+    if (memoriaNecessaria <= memoria) {
+        existe = juncaoHashEmMemoria(&mapaVeiculo, &novoHeader_Veiculo, &mapaLinha, &novoHeader_Linha);
+    } else {
+        int nroParticoes = limitaParticoesJuncao((int)(memoriaNecessaria / memoria) + 1);
+        existe = juncaoHashParticionada(&mapaVeiculo, &novoHeader_Veiculo, &mapaLinha, &novoHeader_Linha, nroParticoes, memoria);
+    }
+
+    // caso a junção for vazia (nenhum registro deu match)
+    if (existe == 0) {
+        printf("Registro inexistente.");
+    }
+
+    desmapeiaArquivo(&mapaVeiculo);
+    desmapeiaArquivo(&mapaLinha);
     fclose(arquivoBin_Veiculo);
     fclose(arquivoBin_Linha);
+    liberaDicionario(novoHeader_Veiculo.dicionario);
+    liberaDicionario(novoHeader_Linha.dicionario);
 }
\ No newline at end of file
@@ -2,6 +2,18 @@
 #define _VEICULO_H_
 #include <stdio.h>
 
+#include "../dicionario/dicionario.h"
+#include "../mapeamento/mapeamento.h"
+
+#define TAMANHO_HEADER_VEICULO 175
+#define CAMPOS_ZONA_VEICULO 3  // data, quantidadeLugares e codLinha resumidos no mapa de zonas
+#define CAMPOS_DICIONARIO_VEICULO 2  // modelo e categoria codificados pelo dicionário
+
+/**
+ * formato não é gravado no header, ele é descoberto pelo primeiro byte após o header (ver bloco.h)
+ * dicionario também não, ele é carregado do .dic ao lado do arquivo (NULL quando os campos estão por extenso)
+ * e é o que codifica e decodifica os registros desse arquivo
+ */
 typedef struct veiculoHeader {
     char status;
     long int byteProxReg;
@@ -13,7 +25,8 @@ typedef struct veiculoHeader {
     char descreveLinha[27];
     char descreveModelo[18];
     char descreveCategoria[21];
-
+    int formato;
+    dicionario* dicionario;
 } veiculoHeader;
 
 typedef struct veiculo {
@@ -29,9 +42,45 @@ typedef struct veiculo {
     char categoria[100];
 } veiculo;
 
+/**
+ * Visão de um veiculo sem cópia dos campos, as strings apontam diretamente para
+ * a região onde o registro está (arquivo mapeado ou struct veiculo) e não
+ * são necessariamente terminadas em \0, por isso seus tamanhos devem ser respeitados
+ */
+typedef struct visaoVeiculo {
+    char removido;
+    int tamanhoRegistro;
+    char* prefixo;  // 5 bytes
+    char* data;     // 10 bytes
+    int quantidadeLugares;
+    int codLinha;
+    int tamanhoModelo;
+    char* modelo;
+    int tamanhoCategoria;
+    char* categoria;
+    int codigoModelo;     // código no dicionário, -1 quando o campo está gravado por extenso
+    int codigoCategoria;
+} visaoVeiculo;
+
+/**
+ * Condição de uma busca sequencial, campo é a posição do campo no cabeçalho
+ */
+typedef struct consultaVeiculo {
+    veiculoHeader* header;
+    int campo;
+    char* valor;
+    int valorInteiro;
+    int codigo;  // código do valor no dicionário do arquivo, -1 quando a comparação é pelo valor
+} consultaVeiculo;
+
 void imprimeVeiculo(veiculo currVeiculo, veiculoHeader header, int quebraLinha);
-int lerVeiculo_Bin(FILE* arquivoBin, veiculo* currV, long int pos);
-void lerHeaderBin_Veiculo(FILE* arquivoBin, veiculoHeader* header);
+void imprimeVisaoVeiculo(visaoVeiculo* currVeiculo, veiculoHeader* header, int quebraLinha);
+int tamanhoSaidaVeiculo(visaoVeiculo* currVeiculo);
+char* formataVisaoVeiculo(char* destino, visaoVeiculo* currVeiculo, veiculoHeader* header, int quebraLinha);
+int lerVeiculo_Bin(FILE* arquivoBin, dicionario* dic, veiculo* currV, long int pos);
+int lerVeiculo_Mapa(arquivoMapeado* mapa, dicionario* dic, visaoVeiculo* currV, long int pos);
+int posicionaPrimeiroVeiculo(arquivoMapeado* mapa);
+void lerHeaderBin_Veiculo(FILE* arquivoBin, char* nomeArquivoBin, veiculoHeader* header);
 int validaHeader_veiculo(FILE** arquivo, veiculoHeader header, int verificaConsistencia, int verificaRegistros);
 
 void SelectFrom_Veiculo(char nomeArquivoBin[100]);
@@ -39,10 +88,14 @@ void CreateTable_Veiculo(char nomeArquivoCSV[100], char nomeArquivoBin[100]);
 void SelectFromWhere_Veiculo(char nomeArquivoBin[100], char* campo, char* valor);
 void InsertInto_Veiculo(char nomeArquivoBin[100], int numeroDeEntradas);
 void CreateIndex_Veiculo(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100]);
+void CreateIndexEmLote_Veiculo(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100], double fatorPreenchimento);
+void CreateIndexHash_Veiculo(char nomeArquivoBin[100], char* campo);
 void SelectFromWithIndex_Veiculo(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100], char valorBuscado[6]);
 void InsertIntoWithIndex_Veiculo(char nomeArquivoBinRegistros[100], char nomeArquivoBinIndex[100], int numeroDeEntradas);
+void Vacuum_Veiculo(char nomeArquivoBin[100], char nomeArquivoBinIndex[100]);
 int SortReg_Veiculo(char nomeArquivoBinDesordenado[100], char nomeArquivoBin[100]);
 void SelectFromWhereNestedLoop(char nomeArquivoBinVeiculo[100], char nomeArquivoBinLinha[100]);
+void SelectFromWhereHashJoin(char nomeArquivoBinVeiculo[100], char nomeArquivoBinLinha[100]);
 void SelectFromWhereUniqueLoop(char nomeArquivoBinVeiculo[100], char nomeArquivoBinLinha[100], char nomeArquivoBinIndex[100]);
 
 #endif
\ No newline at end of file
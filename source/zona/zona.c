@@ -0,0 +1,221 @@
+#include "zona.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "../bloco/bloco.h"
+#include "../estatisticas/estatisticas.h"
+#include "../utils/utils.h"
+
+/**
+ * @return 1 caso os mapas de zonas estejam habilitados pela variável MAPA_ZONAS
+ */
+int mapaZonasAtivo() {
+    return lerConfiguracao("MAPA_ZONAS", 0) > 0;
+}
+
+/**
+ * Monta o nome do arquivo auxiliar com as zonas de um arquivo de dados
+ * @param nomeArquivo nome do arquivo de dados
+ * @param nomeZonas onde o nome do arquivo auxiliar será escrito
+ */
+void nomeArquivoZonas(char* nomeArquivo, char* nomeZonas) {
+    sprintf(nomeZonas, "%s.zonas", nomeArquivo);
+}
+
+/**
+ * Deixa a zona de um bloco vazia, ela não aceita nenhum valor até um registro ser registrado
+ * @param zona zona do bloco
+ */
+void esvaziaZona(zonaBloco* zona) {
+    for (int i = 0; i < MAXIMO_CAMPOS_ZONA; i++) {
+        zona->minimo[i] = INT_MAX;
+        zona->maximo[i] = INT_MIN;
+    }
+}
+
+/**
+ * Cria um mapa sem nenhum bloco
+ * @param nroCampos quantidade de campos resumidos, no máximo MAXIMO_CAMPOS_ZONA
+ * @param tamanhoHeader tamanho do header do arquivo de dados
+ * @return ponteiro para o mapa criado
+ */
+mapaZonas* criaMapaZonas(int nroCampos, int tamanhoHeader) {
+    mapaZonas* zonas = (mapaZonas*)malloc(sizeof(mapaZonas));
+    zonas->nroBlocos = 0;
+    zonas->capacidade = 64;
+    zonas->zonas = (zonaBloco*)malloc(zonas->capacidade * sizeof(zonaBloco));
+    zonas->nroCampos = nroCampos;
+    zonas->tamanhoHeader = tamanhoHeader;
+    return zonas;
+}
+
+/**
+ * Estado do arquivo de dados guardado no header do arquivo auxiliar
+ */
+typedef struct estadoZonas {
+    long int tamanhoArquivo;
+    long int modificacaoSegundos;
+    long int modificacaoNanossegundos;
+    unsigned long int inode;
+} estadoZonas;
+
+/**
+ * @param nomeArquivo nome do arquivo de dados
+ * @param estado onde o estado atual do arquivo será escrito
+ * @return retorna 1 caso o arquivo exista e 0 caso contrário
+ */
+int estadoArquivoZonas(char* nomeArquivo, estadoZonas* estado) {
+    struct stat informacoes;
+    if (stat(nomeArquivo, &informacoes) != 0) return 0;
+
+    estado->tamanhoArquivo = informacoes.st_size;
+    estado->modificacaoSegundos = informacoes.st_mtim.tv_sec;
+    estado->modificacaoNanossegundos = informacoes.st_mtim.tv_nsec;
+    estado->inode = informacoes.st_ino;
+    return 1;
+}
+
+/**
+ * Carrega o mapa salvo ao lado do arquivo de dados
+ * @param nomeArquivo nome do arquivo de dados
+ * @param nroCampos quantidade de campos resumidos
+ * @param tamanhoHeader tamanho do header do arquivo de dados
+ * @return ponteiro para o mapa ou NULL caso ele não exista ou não corresponda ao arquivo de dados
+ */
+mapaZonas* carregaMapaZonas(char* nomeArquivo, int nroCampos, int tamanhoHeader) {
+    char nomeZonas[300];
+    nomeArquivoZonas(nomeArquivo, nomeZonas);
+
+    estadoZonas atual;
+    if (!estadoArquivoZonas(nomeArquivo, &atual)) return NULL;
+
+    FILE* arquivoZonas = fopen(nomeZonas, "rb");
+    if (arquivoZonas == NULL) return NULL;
+
+    estadoZonas guardado;
+    int nroCamposGuardado = -1, nroBlocos = -1;
+    int lido = fread(&guardado.tamanhoArquivo, sizeof(long int), 1, arquivoZonas) == 1 &&
+               fread(&guardado.modificacaoSegundos, sizeof(long int), 1, arquivoZonas) == 1 &&
+               fread(&guardado.modificacaoNanossegundos, sizeof(long int), 1, arquivoZonas) == 1 &&
+               fread(&guardado.inode, sizeof(unsigned long int), 1, arquivoZonas) == 1 &&
+               fread(&nroCamposGuardado, sizeof(int), 1, arquivoZonas) == 1 &&
+               fread(&nroBlocos, sizeof(int), 1, arquivoZonas) == 1;
+
+    if (!lido || guardado.tamanhoArquivo != atual.tamanhoArquivo || guardado.modificacaoSegundos != atual.modificacaoSegundos ||
+        guardado.modificacaoNanossegundos != atual.modificacaoNanossegundos || guardado.inode != atual.inode ||
+        nroCamposGuardado != nroCampos || nroBlocos < 0) {
+        fclose(arquivoZonas);
+        return NULL;
+    }
+
+    mapaZonas* zonas = criaMapaZonas(nroCampos, tamanhoHeader);
+    if (nroBlocos > zonas->capacidade) {
+        zonas->capacidade = nroBlocos;
+        zonas->zonas = (zonaBloco*)realloc(zonas->zonas, zonas->capacidade * sizeof(zonaBloco));
+    }
+
+    for (int i = 0; i < nroBlocos; i++) {
+        zonaBloco* zona = &zonas->zonas[i];
+        esvaziaZona(zona);
+        if (fread(zona->minimo, sizeof(int), nroCampos, arquivoZonas) != (size_t)nroCampos ||
+            fread(zona->maximo, sizeof(int), nroCampos, arquivoZonas) != (size_t)nroCampos) {
+            liberaMapaZonas(zonas);
+            fclose(arquivoZonas);
+            return NULL;
+        }
+    }
+    zonas->nroBlocos = nroBlocos;
+
+    fclose(arquivoZonas);
+    return zonas;
+}
+
+/**
+ * Salva o mapa junto do estado atual do arquivo de dados, que já deve estar fechado
+ * @param zonas mapa a ser salvo
+ * @param nomeArquivo nome do arquivo de dados
+ */
+void salvaMapaZonas(mapaZonas* zonas, char* nomeArquivo) {
+    char nomeZonas[300];
+    nomeArquivoZonas(nomeArquivo, nomeZonas);
+
+    estadoZonas atual;
+    if (!estadoArquivoZonas(nomeArquivo, &atual)) return;
+
+    FILE* arquivoZonas = fopen(nomeZonas, "wb");
+    if (arquivoZonas == NULL) return;
+
+    fwrite(&atual.tamanhoArquivo, sizeof(long int), 1, arquivoZonas);
+    fwrite(&atual.modificacaoSegundos, sizeof(long int), 1, arquivoZonas);
+    fwrite(&atual.modificacaoNanossegundos, sizeof(long int), 1, arquivoZonas);
+    fwrite(&atual.inode, sizeof(unsigned long int), 1, arquivoZonas);
+    fwrite(&zonas->nroCampos, sizeof(int), 1, arquivoZonas);
+    fwrite(&zonas->nroBlocos, sizeof(int), 1, arquivoZonas);
+
+    for (int i = 0; i < zonas->nroBlocos; i++) {
+        fwrite(zonas->zonas[i].minimo, sizeof(int), zonas->nroCampos, arquivoZonas);
+        fwrite(zonas->zonas[i].maximo, sizeof(int), zonas->nroCampos, arquivoZonas);
+    }
+
+    fclose(arquivoZonas);
+}
+
+/**
+ * Libera a memória usada pelo mapa
+ * @param zonas mapa a ser liberado
+ */
+void liberaMapaZonas(mapaZonas* zonas) {
+    free(zonas->zonas);
+    free(zonas);
+}
+
+/**
+ * Inclui os valores de um registro gravado (ou regravado) no intervalo do seu bloco
+ * @param zonas mapa do arquivo
+ * @param byteOffset inicio do registro
+ * @param valores valor de cada campo resumido, VALOR_QUALQUER_ZONA quando o valor não pode ser resumido
+ */
+void registraValoresZona(mapaZonas* zonas, long int byteOffset, int* valores) {
+    long int bloco = (byteOffset - zonas->tamanhoHeader) / TAMANHO_BLOCO_DADOS;
+
+    if (bloco >= zonas->nroBlocos) {
+        if (bloco >= zonas->capacidade) {
+            while (bloco >= zonas->capacidade) zonas->capacidade *= 2;
+            zonas->zonas = (zonaBloco*)realloc(zonas->zonas, zonas->capacidade * sizeof(zonaBloco));
+        }
+        for (long int i = zonas->nroBlocos; i <= bloco; i++) esvaziaZona(&zonas->zonas[i]);
+        zonas->nroBlocos = bloco + 1;
+    }
+
+    zonaBloco* zona = &zonas->zonas[bloco];
+    for (int i = 0; i < zonas->nroCampos; i++) {
+        int minimo = (valores[i] == VALOR_QUALQUER_ZONA) ? INT_MIN : valores[i];
+        int maximo = (valores[i] == VALOR_QUALQUER_ZONA) ? INT_MAX : valores[i];
+        if (minimo < zona->minimo[i]) zona->minimo[i] = minimo;
+        if (maximo > zona->maximo[i]) zona->maximo[i] = maximo;
+    }
+}
+
+/**
+ * Marca os blocos que podem ter registros com o valor procurado
+ * @param zonas mapa do arquivo
+ * @param campo posição do campo no mapa
+ * @param valor valor procurado
+ * @param nroBlocos quantidade de blocos do arquivo de dados
+ * @return vetor alocado com 1 para os blocos que precisam ser lidos e 0 para os descartados
+ */
+char* blocosPossiveisZona(mapaZonas* zonas, int campo, int valor, long int nroBlocos) {
+    char* possiveis = (char*)malloc(nroBlocos > 0 ? nroBlocos : 1);
+
+    for (long int i = 0; i < nroBlocos; i++) {
+        // um bloco que o mapa não conhece nunca é descartado
+        possiveis[i] = i >= zonas->nroBlocos || (zonas->zonas[i].minimo[campo] <= valor && valor <= zonas->zonas[i].maximo[campo]);
+        CONTA(blocosDescartados, !possiveis[i]);
+    }
+
+    return possiveis;
+}
@@ -0,0 +1,42 @@
+#ifndef _ZONA_H_
+#define _ZONA_H_
+#include <limits.h>
+#include <stdio.h>
+
+#define MAXIMO_CAMPOS_ZONA 3              // campos inteiros resumidos por bloco
+#define VALOR_QUALQUER_ZONA INT_MIN       // valor que não pode ser resumido, a zona passa a aceitar qualquer valor
+#define TAMANHO_HEADER_ZONAS 40
+
+/**
+ * Com MAPA_ZONAS=1 os arquivos de dados no formato em blocos ganham em <arquivo>.zonas o menor e o maior
+ * valor de alguns campos inteiros de cada bloco. Uma busca por igualdade em um desses campos descarta sem
+ * ler os blocos cujo intervalo não contém o valor procurado
+ *
+ * Registros removidos continuam dentro do intervalo do bloco, o intervalo só cresce e por isso nunca
+ * descarta um bloco que tenha o valor. Como no módulo soma, o header do arquivo auxiliar guarda tamanho,
+ * data de modificação e inode do arquivo de dados, qualquer alteração que não tenha passado pelo mapa
+ * faz ele ser remontado na próxima busca
+ */
+typedef struct zonaBloco {
+    int minimo[MAXIMO_CAMPOS_ZONA];
+    int maximo[MAXIMO_CAMPOS_ZONA];
+} zonaBloco;
+
+typedef struct mapaZonas {
+    zonaBloco* zonas;
+    int nroBlocos;
+    int capacidade;
+    int nroCampos;
+    int tamanhoHeader;  // tamanho do header do arquivo de dados
+} mapaZonas;
+
+int mapaZonasAtivo();
+void nomeArquivoZonas(char* nomeArquivo, char* nomeZonas);
+mapaZonas* criaMapaZonas(int nroCampos, int tamanhoHeader);
+mapaZonas* carregaMapaZonas(char* nomeArquivo, int nroCampos, int tamanhoHeader);
+void salvaMapaZonas(mapaZonas* zonas, char* nomeArquivo);
+void liberaMapaZonas(mapaZonas* zonas);
+void registraValoresZona(mapaZonas* zonas, long int byteOffset, int* valores);
+char* blocosPossiveisZona(mapaZonas* zonas, int campo, int valor, long int nroBlocos);
+
+#endif
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Roda os mesmos casos de teste com o formato em blocos, o dicionário, o reuso de espaço, o mapa de zonas e as consultas
+// em paralelo. A saída, sem as somas de binarioNaTela, deve ser a mesma do formato original; as somas são comparadas
+// com as do arquivo N.somas de cada caso, que é gerado passando "gera" como terceiro argumento
+#define CONFIGURACAO "FORMATO_DADOS=2 DICIONARIO=1 REUSO_ESPACO=1 MAPA_ZONAS=1 THREADS_CONSULTA=4"
+#define SOMA "'^-?[0-9]+\\.[0-9]{6}$'"
+
+int main(int argc, char const *argv[]) {
+    char buffer[600];
+    int numberOfTests = atoi(argv[1]);
+    int gera = argc > 3 && strcmp(argv[3], "gera") == 0;
+
+    for (int i = 1; i <= numberOfTests; i++) {
+        sprintf(buffer, "mkdir -p %s%d_formatos ", argv[2], i);
+        system(buffer);
+
+        sprintf(buffer, "cp -a %s%d/. %s%d_formatos ", argv[2], i, argv[2], i);
+        system(buffer);
+
+        sprintf(buffer, "cp exec %s%d_formatos ", argv[2], i);
+        system(buffer);
+
+        sprintf(buffer, "chmod u+x ./%s%d_formatos/exec", argv[2], i);
+        system(buffer);
+
+        sprintf(buffer, "(cd ./%s%d_formatos/ && ((%s valgrind --leak-check=full --show-leak-kinds=all -s ./exec) < %d.in) > %d.out)", argv[2], i, CONFIGURACAO, i, i);
+        system(buffer);
+
+        sprintf(buffer, "(cd ./%s%d_formatos/ && rm exec)", argv[2], i);
+        system(buffer);
+
+        sprintf(buffer, "grep -E %s %s%d_formatos/%d.out > %s%d_formatos/%d.somas", SOMA, argv[2], i, i, argv[2], i, i);
+        system(buffer);
+
+        if (gera) {
+            sprintf(buffer, "rm -f %s%d/%d.somas && ([ ! -s %s%d_formatos/%d.somas ] || cp %s%d_formatos/%d.somas %s%d/)", argv[2], i, i, argv[2], i, i, argv[2], i, i, argv[2], i);
+            system(buffer);
+        }
+    }
+
+    sprintf(buffer, "echo \"Resultados: \" > %sresultadosFormatos.txt", argv[2]);
+    system(buffer);
+
+    for (int i = 1; i <= numberOfTests; i++) {
+        sprintf(buffer, "echo  '%d: ' >> %sresultadosFormatos.txt", i, argv[2]);
+        system(buffer);
+
+        sprintf(buffer, "grep -vE %s %s%d_formatos/%d.out > %s%d_formatos/%d.saida", SOMA, argv[2], i, i, argv[2], i, i);
+        system(buffer);
+
+        sprintf(buffer, "grep -vE %s %s%d/%d.out > %s%d_formatos/%d.esperada", SOMA, argv[2], i, i, argv[2], i, i);
+        system(buffer);
+
+        sprintf(buffer, "(diff %s%d_formatos/%d.saida %s%d_formatos/%d.esperada) >> %sresultadosFormatos.txt", argv[2], i, i, argv[2], i, i, argv[2]);
+        system(buffer);
+
+        // casos sem nenhum binário impresso não têm o arquivo de somas
+        sprintf(buffer, "(if [ -f %s%d/%d.somas ]; then diff %s%d_formatos/%d.somas %s%d/%d.somas; else diff %s%d_formatos/%d.somas /dev/null; fi) >> %sresultadosFormatos.txt",
+                argv[2], i, i, argv[2], i, i, argv[2], i, i, argv[2], i, i, argv[2]);
+        system(buffer);
+
+        sprintf(buffer, "echo \" \n \" >> %sresultadosFormatos.txt", argv[2]);
+        system(buffer);
+    }
+
+    sprintf(buffer, "cat %sresultadosFormatos.txt", argv[2]);
+    system(buffer);
+
+    return 0;
+}